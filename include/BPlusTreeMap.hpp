@@ -0,0 +1,575 @@
+#ifndef __COLLECTIONS_BPLUS_TREE_MAP
+#define __COLLECTIONS_BPLUS_TREE_MAP
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "MemoryUsage.hpp"
+
+namespace Collections
+{
+    // Mapa ordenado en un B+tree, backend de SortedDictionary con la interfaz de std::map que éste usa
+    // (p.ej. SortedDictionary<double, int64_t, std::greater<double>, BPlusTreeMap<double, int64_t, std::greater<double>>>)
+    // - nodos anchos: las llaves de un nodo ocupan NodeBytes contiguos (4 líneas de caché por default), así que bajar
+    //   por el árbol toca unas pocas líneas por nivel en vez de un nodo de heap por llave como el rojo-negro de std::map
+    // - las llaves y los valores de las hojas van en arreglos separados y las hojas están ligadas: recorrer en orden es
+    //   leer arreglos seguidos
+    // - buscar dentro de un nodo: con llaves aritméticas y std::less / std::greater se cuentan las llaves menores sin
+    //   ramas en todo el arreglo (el compilador lo vectoriza); con cualquier otro comparador, búsqueda binaria
+    // - insertar al final (o al principio) en orden de C, el caso de niveles de precio nuevos, llena las hojas en vez de
+    //   dejarlas a la mitad
+    // - K y V deben tener constructor por default y asignación por movimiento (viven en arreglos)
+    // - los iteradores son forward y regresan std::pair<const K &, V &> por valor: usar auto, const auto & o structured
+    //   bindings en vez de auto &; cualquier inserción o borrado los invalida (std::map no)
+    template <typename K, typename V, typename C = std::less<K>, size_t NodeBytes = 256>
+    class BPlusTreeMap
+    {
+        static constexpr uint32_t Capacity = static_cast<uint32_t>(std::max<size_t>(8, NodeBytes / sizeof(K)));
+
+        // comparación sin ramas sobre todo el nodo
+        static constexpr bool Scan = std::is_arithmetic<K>::value &&
+                                     (std::is_same<C, std::less<K>>::value || std::is_same<C, std::greater<K>>::value ||
+                                      std::is_same<C, std::less<>>::value || std::is_same<C, std::greater<>>::value);
+
+        struct Node
+        {
+            uint32_t count = 0;
+            bool leaf;
+
+            explicit Node(bool leaf) : leaf(leaf) {}
+        };
+
+        struct Leaf : Node
+        {
+            alignas(64) K keys[Capacity];
+            V values[Capacity];
+            Leaf *next = nullptr;
+
+            Leaf() : Node(true) {}
+        };
+
+        // children[i] tiene las llaves en [keys[i - 1], keys[i])
+        struct Inner : Node
+        {
+            alignas(64) K keys[Capacity];
+            Node *children[Capacity + 1];
+
+            Inner() : Node(false) {}
+        };
+
+        Node *root = nullptr;
+        Leaf *first = nullptr;
+        size_t elements = 0, leaves = 0, inners = 0;
+        [[no_unique_address]] C comp;
+
+        template <bool Const>
+        class Iterator
+        {
+            friend class BPlusTreeMap;
+            using LeafPointer = std::conditional_t<Const, const Leaf *, Leaf *>;
+            using Value = std::conditional_t<Const, const V, V>;
+
+            LeafPointer leaf = nullptr;
+            uint32_t position = 0;
+
+            Iterator(LeafPointer leaf, uint32_t position) : leaf(leaf), position(position) {}
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::pair<const K &, Value &>;
+            using reference = std::pair<const K &, Value &>;
+            using difference_type = std::ptrdiff_t;
+
+            // para kvp->first / kvp->second: el par vive dentro del objeto que regresa operator->
+            struct pointer
+            {
+                reference kvp;
+
+                inline const reference *operator->() const
+                {
+                    return &this->kvp;
+                }
+            };
+
+            Iterator() = default;
+
+            template <bool Other>
+                requires(Const && !Other)
+            Iterator(const Iterator<Other> &o) : leaf(o.leaf), position(o.position)
+            {
+            }
+
+            inline reference operator*() const
+            {
+                return reference(this->leaf->keys[this->position], this->leaf->values[this->position]);
+            }
+
+            inline pointer operator->() const
+            {
+                return pointer{**this};
+            }
+
+            inline Iterator &operator++()
+            {
+                if (++this->position == this->leaf->count)
+                {
+                    this->leaf = this->leaf->next;
+                    this->position = 0;
+                }
+                return *this;
+            }
+
+            inline Iterator operator++(int)
+            {
+                auto result = *this;
+                ++*this;
+                return result;
+            }
+
+            friend inline bool operator==(const Iterator &a, const Iterator &b)
+            {
+                return a.leaf == b.leaf && a.position == b.position;
+            }
+        };
+
+        // cuántas llaves van antes que key: las < key (lower_bound) o, con Upper, las <= key (upper_bound)
+        template <bool Upper>
+        inline uint32_t Rank(const K *keys, uint32_t n, const K &key) const
+        {
+            if constexpr (Scan)
+            {
+                uint32_t rank = 0;
+                for (uint32_t i = 0; i < n; ++i)
+                    rank += Upper ? !this->comp(key, keys[i]) : this->comp(keys[i], key);
+                return rank;
+            }
+            else if constexpr (Upper)
+                return static_cast<uint32_t>(std::upper_bound(keys, keys + n, key, this->comp) - keys);
+            else
+                return static_cast<uint32_t>(std::lower_bound(keys, keys + n, key, this->comp) - keys);
+        }
+
+        inline Leaf *FindLeaf(const K &key) const
+        {
+            Node *node = this->root;
+            while (!node->leaf)
+            {
+                auto inner = static_cast<Inner *>(node);
+                node = inner->children[this->Rank<true>(inner->keys, inner->count, key)];
+            }
+            return static_cast<Leaf *>(node);
+        }
+
+        inline Leaf *NewLeaf()
+        {
+            ++this->leaves;
+            return new Leaf();
+        }
+
+        inline Inner *NewInner()
+        {
+            ++this->inners;
+            return new Inner();
+        }
+
+        inline void Delete(Node *node)
+        {
+            if (node->leaf)
+            {
+                --this->leaves;
+                delete static_cast<Leaf *>(node);
+            }
+            else
+            {
+                --this->inners;
+                delete static_cast<Inner *>(node);
+            }
+        }
+
+        void Destroy(Node *node)
+        {
+            if (!node->leaf)
+            {
+                auto inner = static_cast<Inner *>(node);
+                for (uint32_t i = 0; i <= inner->count; ++i)
+                    this->Destroy(inner->children[i]);
+            }
+            this->Delete(node);
+        }
+
+        // parte el hijo lleno parent->children[i]: el izquierdo se queda con las primeras `at` llaves
+        inline void SplitChild(Inner *parent, uint32_t i, uint32_t at)
+        {
+            Node *child = parent->children[i];
+            Node *right;
+            K separator;
+            if (child->leaf)
+            {
+                auto left = static_cast<Leaf *>(child);
+                auto leaf = this->NewLeaf();
+                std::move(left->keys + at, left->keys + left->count, leaf->keys);
+                std::move(left->values + at, left->values + left->count, leaf->values);
+                leaf->count = left->count - at;
+                left->count = at;
+                leaf->next = left->next;
+                left->next = leaf;
+                separator = leaf->keys[0];
+                right = leaf;
+            }
+            else
+            {
+                // la llave `at` sube al padre
+                auto left = static_cast<Inner *>(child);
+                auto inner = this->NewInner();
+                std::move(left->keys + at + 1, left->keys + left->count, inner->keys);
+                std::copy(left->children + at + 1, left->children + left->count + 1, inner->children);
+                inner->count = left->count - at - 1;
+                left->count = at;
+                separator = std::move(left->keys[at]);
+                right = inner;
+            }
+
+            std::move_backward(parent->keys + i, parent->keys + parent->count, parent->keys + parent->count + 1);
+            std::copy_backward(parent->children + i + 1, parent->children + parent->count + 1, parent->children + parent->count + 2);
+            parent->keys[i] = std::move(separator);
+            parent->children[i + 1] = right;
+            ++parent->count;
+        }
+
+        // dónde partir un nodo lleno en el camino de key: a la mitad, o casi todo a un lado si key va más allá del
+        // extremo del nodo (inserciones en orden)
+        inline uint32_t SplitPoint(const Node *child, bool last, bool first, const K &key) const
+        {
+            const K *keys = child->leaf ? static_cast<const Leaf *>(child)->keys : static_cast<const Inner *>(child)->keys;
+            if (last && this->comp(keys[child->count - 1], key))
+                return child->leaf ? Capacity - 1 : Capacity - 2;
+            if (first && this->comp(key, keys[0]))
+                return 1;
+            return Capacity / 2;
+        }
+
+        inline bool Underfull(const Node *node) const
+        {
+            return node->count < Capacity / 4;
+        }
+
+        // junta parent->children[i + 1] dentro de parent->children[i]
+        inline void Merge(Inner *parent, uint32_t i)
+        {
+            Node *left = parent->children[i], *right = parent->children[i + 1];
+            if (left->leaf)
+            {
+                auto l = static_cast<Leaf *>(left), r = static_cast<Leaf *>(right);
+                std::move(r->keys, r->keys + r->count, l->keys + l->count);
+                std::move(r->values, r->values + r->count, l->values + l->count);
+                l->count += r->count;
+                l->next = r->next;
+            }
+            else
+            {
+                auto l = static_cast<Inner *>(left), r = static_cast<Inner *>(right);
+                l->keys[l->count] = std::move(parent->keys[i]);
+                std::move(r->keys, r->keys + r->count, l->keys + l->count + 1);
+                std::copy(r->children, r->children + r->count + 1, l->children + l->count + 1);
+                l->count += r->count + 1;
+            }
+            std::move(parent->keys + i + 1, parent->keys + parent->count, parent->keys + i);
+            std::copy(parent->children + i + 2, parent->children + parent->count + 1, parent->children + i + 1);
+            --parent->count;
+            this->Delete(right);
+        }
+
+        // un nodo interno sin llaves (un solo hijo) que no cabe con su hermano le pide una llave y un hijo
+        inline void Rotate(Inner *parent, uint32_t i, bool from_right)
+        {
+            auto left = static_cast<Inner *>(parent->children[i]), right = static_cast<Inner *>(parent->children[i + 1]);
+            if (from_right)
+            {
+                left->keys[left->count] = std::move(parent->keys[i]);
+                left->children[left->count + 1] = right->children[0];
+                ++left->count;
+                parent->keys[i] = std::move(right->keys[0]);
+                std::move(right->keys + 1, right->keys + right->count, right->keys);
+                std::copy(right->children + 1, right->children + right->count + 1, right->children);
+                --right->count;
+            }
+            else
+            {
+                std::move_backward(right->keys, right->keys + right->count, right->keys + right->count + 1);
+                std::copy_backward(right->children, right->children + right->count + 1, right->children + right->count + 2);
+                right->keys[0] = std::move(parent->keys[i]);
+                right->children[0] = left->children[left->count];
+                ++right->count;
+                parent->keys[i] = std::move(left->keys[left->count - 1]);
+                --left->count;
+            }
+        }
+
+    public:
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::pair<const K, V>;
+        using key_compare = C;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        // sólo para la interfaz de SortedDictionary: los nodos se piden con new
+        using allocator_type = std::allocator<value_type>;
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        BPlusTreeMap() = default;
+        explicit BPlusTreeMap(const allocator_type &) {}
+
+        BPlusTreeMap(const BPlusTreeMap &o) : comp(o.comp)
+        {
+            for (const auto &[key, value] : o)
+                this->try_emplace(key, value);
+        }
+
+        BPlusTreeMap(BPlusTreeMap &&o) noexcept
+            : root(std::exchange(o.root, nullptr)), first(std::exchange(o.first, nullptr)), elements(std::exchange(o.elements, 0)),
+              leaves(std::exchange(o.leaves, 0)), inners(std::exchange(o.inners, 0)), comp(o.comp)
+        {
+        }
+
+        BPlusTreeMap &operator=(BPlusTreeMap o) noexcept
+        {
+            std::swap(this->root, o.root);
+            std::swap(this->first, o.first);
+            std::swap(this->elements, o.elements);
+            std::swap(this->leaves, o.leaves);
+            std::swap(this->inners, o.inners);
+            std::swap(this->comp, o.comp);
+            return *this;
+        }
+
+        ~BPlusTreeMap()
+        {
+            this->clear();
+        }
+
+        inline iterator begin()
+        {
+            return iterator(this->first, 0);
+        }
+
+        inline iterator end()
+        {
+            return iterator();
+        }
+
+        inline const_iterator begin() const
+        {
+            return const_iterator(this->first, 0);
+        }
+
+        inline const_iterator end() const
+        {
+            return const_iterator();
+        }
+
+        inline size_t size() const
+        {
+            return this->elements;
+        }
+
+        inline bool empty() const
+        {
+            return this->elements == 0;
+        }
+
+        inline C key_comp() const
+        {
+            return this->comp;
+        }
+
+        inline void clear()
+        {
+            if (this->root)
+                this->Destroy(this->root);
+            this->root = nullptr;
+            this->first = nullptr;
+            this->elements = 0;
+        }
+
+        // nodos (ver ContainerMemoryUsage)
+        inline size_t memory_usage() const
+        {
+            return this->leaves * AllocationSize(sizeof(Leaf)) + this->inners * AllocationSize(sizeof(Inner));
+        }
+
+        inline iterator find(const K &key)
+        {
+            if (!this->root)
+                return this->end();
+            auto leaf = this->FindLeaf(key);
+            auto position = this->Rank<false>(leaf->keys, leaf->count, key);
+            return position < leaf->count && !this->comp(key, leaf->keys[position]) ? iterator(leaf, position) : this->end();
+        }
+
+        inline const_iterator find(const K &key) const
+        {
+            return const_cast<BPlusTreeMap *>(this)->find(key);
+        }
+
+        inline iterator lower_bound(const K &key)
+        {
+            if (!this->root)
+                return this->end();
+            auto leaf = this->FindLeaf(key);
+            auto position = this->Rank<false>(leaf->keys, leaf->count, key);
+            // todas las llaves de la hoja son menores: la primera de la siguiente ya es >= key
+            return position < leaf->count ? iterator(leaf, position) : iterator(leaf->next, 0);
+        }
+
+        inline const_iterator lower_bound(const K &key) const
+        {
+            return const_cast<BPlusTreeMap *>(this)->lower_bound(key);
+        }
+
+        inline size_t count(const K &key) const
+        {
+            return this->find(key) != this->end();
+        }
+
+        // los nodos llenos del camino se parten de bajada, así que el padre siempre tiene lugar para un separador
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(const K &key, Args &&...args)
+        {
+            if (!this->root)
+                this->root = this->first = this->NewLeaf();
+            if (this->root->count == Capacity)
+            {
+                auto root = this->NewInner();
+                root->children[0] = this->root;
+                this->root = root;
+                this->SplitChild(root, 0, this->SplitPoint(root->children[0], true, true, key));
+            }
+
+            Node *node = this->root;
+            while (!node->leaf)
+            {
+                auto inner = static_cast<Inner *>(node);
+                auto i = this->Rank<true>(inner->keys, inner->count, key);
+                if (inner->children[i]->count == Capacity)
+                {
+                    this->SplitChild(inner, i, this->SplitPoint(inner->children[i], i == inner->count, i == 0, key));
+                    if (!this->comp(key, inner->keys[i]))
+                        ++i;
+                }
+                node = inner->children[i];
+            }
+
+            auto leaf = static_cast<Leaf *>(node);
+            auto position = this->Rank<false>(leaf->keys, leaf->count, key);
+            if (position < leaf->count && !this->comp(key, leaf->keys[position]))
+                return {iterator(leaf, position), false};
+
+            // llave y valor se construyen antes de recorrer el nodo: si lanzan, la hoja queda como estaba
+            K new_key(key);
+            V value(std::forward<Args>(args)...);
+            std::move_backward(leaf->keys + position, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+            std::move_backward(leaf->values + position, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+            leaf->keys[position] = std::move(new_key);
+            leaf->values[position] = std::move(value);
+            ++leaf->count;
+            ++this->elements;
+            return {iterator(leaf, position), true};
+        }
+
+        template <typename M>
+        inline std::pair<iterator, bool> insert_or_assign(const K &key, M &&value)
+        {
+            auto result = this->try_emplace(key, std::forward<M>(value));
+            if (!result.second)
+                result.first->second = std::forward<M>(value);
+            return result;
+        }
+
+        inline V &operator[](const K &key)
+        {
+            return this->try_emplace(key).first->second;
+        }
+
+        // un hijo que queda con menos de Capacity / 4 llaves se junta con su hermano si entre los dos no pasan de 3/4
+        // del nodo (o si quedó vacío y cabe); un nodo que no se puede juntar se deja como está
+        size_t erase(const K &key)
+        {
+            if (!this->root)
+                return 0;
+
+            std::pair<Inner *, uint32_t> path[64];
+            size_t depth = 0;
+            Node *node = this->root;
+            while (!node->leaf)
+            {
+                auto inner = static_cast<Inner *>(node);
+                auto i = this->Rank<true>(inner->keys, inner->count, key);
+                path[depth++] = {inner, i};
+                node = inner->children[i];
+            }
+
+            auto leaf = static_cast<Leaf *>(node);
+            auto position = this->Rank<false>(leaf->keys, leaf->count, key);
+            if (position == leaf->count || this->comp(key, leaf->keys[position]))
+                return 0;
+            std::move(leaf->keys + position + 1, leaf->keys + leaf->count, leaf->keys + position);
+            std::move(leaf->values + position + 1, leaf->values + leaf->count, leaf->values + position);
+            --leaf->count;
+            leaf->values[leaf->count] = V();
+            --this->elements;
+
+            while (depth && this->Underfull(node))
+            {
+                auto [parent, i] = path[--depth];
+                // con el hermano derecho, o con el izquierdo si es el último hijo
+                uint32_t l = i < parent->count ? i : i - 1;
+                Node *left = parent->children[l], *right = parent->children[l + 1];
+                size_t total = left->count + right->count + (node->leaf ? 0 : 1);
+                if (total <= Capacity * 3 / 4 || (node->count == 0 && total <= Capacity))
+                {
+                    this->Merge(parent, l);
+                    node = parent;
+                    continue;
+                }
+                if (!node->leaf && node->count == 0)
+                    this->Rotate(parent, l, node == left);
+                break;
+            }
+
+            if (!this->root->leaf && this->root->count == 0)
+            {
+                auto old = static_cast<Inner *>(this->root);
+                this->root = old->children[0];
+                this->Delete(old);
+            }
+            else if (this->root->leaf && this->root->count == 0)
+            {
+                this->Delete(this->root);
+                this->root = nullptr;
+                this->first = nullptr;
+            }
+            return 1;
+        }
+
+        // regresa el siguiente elemento (una búsqueda más: el borrado puede juntar hojas)
+        inline iterator erase(const_iterator position)
+        {
+            K key = position.leaf->keys[position.position];
+            this->erase(key);
+            return this->lower_bound(key);
+        }
+
+        inline iterator erase(iterator position)
+        {
+            return this->erase(const_iterator(position));
+        }
+    };
+} // namespace Collections
+
+#endif // __COLLECTIONS_BPLUS_TREE_MAP
@@ -0,0 +1,314 @@
+#ifndef __COLLECTIONS_CLOCK_CACHE
+#define __COLLECTIONS_CLOCK_CACHE
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "Dictionary.hpp"
+
+namespace Collections
+{
+    // contadores de un cache, para dimensionarlo contra su hit ratio
+    struct CacheStats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t insertions = 0;
+        uint64_t evictions = 0;
+
+        inline double HitRatio() const
+        {
+            return this->hits + this->misses ? static_cast<double>(this->hits) / static_cast<double>(this->hits + this->misses) : 0.0;
+        }
+
+        inline CacheStats &operator+=(const CacheStats &o)
+        {
+            this->hits += o.hits;
+            this->misses += o.misses;
+            this->insertions += o.insertions;
+            this->evictions += o.evictions;
+            return *this;
+        }
+    };
+
+    // cada entrada pesa 1: la capacidad es en número de entradas
+    struct UnitWeight
+    {
+        template <typename K, typename V>
+        inline size_t operator()(const K &, const V &) const
+        {
+            return 1;
+        }
+    };
+
+    // Cache de capacidad acotada con desalojo CLOCK (sin lista ligada de LRU)
+    // - las entradas viven en un arreglo circular; un hit sólo sube el contador de frecuencia de su slot (hasta 3)
+    // - para hacer lugar la manecilla recorre el arreglo: baja en uno los contadores y desaloja la primera entrada en 0
+    // - resistente a barridos: una entrada nueva entra con frecuencia 0 y se va en cuanto la manecilla la alcanza,
+    //   mientras que las entradas reusadas sobreviven hasta 3 vueltas
+    // W = UnitWeight (capacidad en entradas) | functor (const K&, const V&) -> size_t, p.ej. bytes
+    // no es thread safe, ver ConcurrentClockCache
+    template <typename K, typename V, typename W = UnitWeight>
+    class ClockCache
+    {
+        static constexpr uint8_t MaxFrequency = 3;
+
+        struct Slot
+        {
+            std::optional<std::pair<K, V>> entry;
+            size_t weight = 0;
+            uint8_t frequency = 0;
+        };
+
+        Dictionary<K, size_t> index;
+        std::vector<Slot> slots;
+        std::vector<size_t> free;
+        size_t hand = 0, capacity, weight = 0;
+        W weigher;
+        CacheStats stats;
+        // lo último que GetOrAdd no pudo guardar por pesar más que toda la capacidad
+        std::optional<V> uncached;
+
+        inline void Evict(size_t i)
+        {
+            auto &slot = this->slots[i];
+            this->index.TryRemove(slot.entry->first);
+            this->weight -= slot.weight;
+            slot.entry.reset();
+            this->free.push_back(i);
+        }
+
+        // desaloja hasta que quepa `needed`
+        inline void MakeRoom(size_t needed)
+        {
+            while (this->weight + needed > this->capacity && this->index.Any())
+            {
+                auto &slot = this->slots[this->hand];
+                if (slot.entry)
+                {
+                    if (slot.frequency)
+                        --slot.frequency;
+                    else
+                    {
+                        this->Evict(this->hand);
+                        ++this->stats.evictions;
+                    }
+                }
+                this->hand = (this->hand + 1) % this->slots.size();
+            }
+        }
+
+        template <typename Kx, typename Vx>
+        inline V &Insert(Kx &&key, Vx &&value, size_t weight)
+        {
+            this->MakeRoom(weight);
+
+            size_t i;
+            if (this->free.empty())
+            {
+                i = this->slots.size();
+                this->slots.emplace_back();
+            }
+            else
+            {
+                i = this->free.back();
+                this->free.pop_back();
+            }
+
+            auto &slot = this->slots[i];
+            slot.entry.emplace(std::forward<Kx>(key), std::forward<Vx>(value));
+            slot.weight = weight;
+            slot.frequency = 0;
+            this->weight += weight;
+            this->index.TryAdd(slot.entry->first, i);
+            ++this->stats.insertions;
+            return slot.entry->second;
+        }
+
+    public:
+        explicit ClockCache(size_t capacity, const W &weigher = W()) : capacity(capacity), weigher(weigher) {}
+
+        inline size_t Capacity() const
+        {
+            return this->capacity;
+        }
+
+        // suma de los pesos (con UnitWeight, igual que Size)
+        inline size_t Weight() const
+        {
+            return this->weight;
+        }
+
+        inline size_t Size()
+        {
+            return this->index.Size();
+        }
+
+        inline bool Any()
+        {
+            return this->index.Any();
+        }
+
+        // ver Dictionary::MemoryUsage; el índice, los slots (con los huecos libres) y la lista de libres
+        inline size_t MemoryUsage(bool deep = false) const
+        {
+            size_t result = sizeof(*this) - sizeof(this->index) + this->index.MemoryUsage(deep) + ContainerMemoryUsage(this->slots) + ContainerMemoryUsage(this->free);
+            if (deep)
+            {
+                for (auto &slot : this->slots)
+                    result += slot.entry ? HeapSizeOf(*slot.entry) : 0;
+                result += this->uncached ? HeapSizeOf(*this->uncached) : 0;
+            }
+            return result;
+        }
+
+        inline CacheStats Stats() const
+        {
+            return this->stats;
+        }
+
+        inline void ResetStats()
+        {
+            this->stats = CacheStats();
+        }
+
+        // no cuenta como hit ni como miss
+        inline bool ContainsKey(const K &key)
+        {
+            return this->index.ContainsKey(key);
+        }
+
+        inline bool TryGetValue(const K &key, V &value)
+        {
+            if (size_t i; this->index.TryGetValue(key, i))
+            {
+                auto &slot = this->slots[i];
+                if (slot.frequency < MaxFrequency)
+                    ++slot.frequency;
+                value = slot.entry->second;
+                ++this->stats.hits;
+                return true;
+            }
+            ++this->stats.misses;
+            return false;
+        }
+
+        // el apuntador es válido hasta la siguiente inserción (que puede desalojarlo)
+        inline bool TryGetValue(const K &key, V *&value)
+        {
+            if (size_t i; this->index.TryGetValue(key, i))
+            {
+                auto &slot = this->slots[i];
+                if (slot.frequency < MaxFrequency)
+                    ++slot.frequency;
+                value = &slot.entry->second;
+                ++this->stats.hits;
+                return true;
+            }
+            ++this->stats.misses;
+            return false;
+        }
+
+        // false si ya existía o si la entrada sola pesa más que toda la capacidad
+        inline bool TryAdd(const K &key, const V &value)
+        {
+            auto weight = this->weigher(key, value);
+            if (weight > this->capacity || this->index.ContainsKey(key))
+                return false;
+            this->Insert(key, value, weight);
+            return true;
+        }
+
+        inline bool TryAdd(const K &key, V &&value)
+        {
+            auto weight = this->weigher(key, value);
+            if (weight > this->capacity || this->index.ContainsKey(key))
+                return false;
+            this->Insert(key, std::move(value), weight);
+            return true;
+        }
+
+        // inserta o reemplaza; true si la llave es nueva
+        // un valor que pesa más que toda la capacidad no se guarda y la entrada anterior se queda como estaba (false)
+        inline bool Add(const K &key, const V &value)
+        {
+            auto weight = this->weigher(key, value);
+            if (weight > this->capacity)
+                return false;
+            bool fresh = !this->TryRemove(key);
+            this->Insert(key, value, weight);
+            return fresh;
+        }
+
+        inline bool Add(const K &key, V &&value)
+        {
+            auto weight = this->weigher(key, value);
+            if (weight > this->capacity)
+                return false;
+            bool fresh = !this->TryRemove(key);
+            this->Insert(key, std::move(value), weight);
+            return fresh;
+        }
+
+        // ojo : la referencia es válida hasta la siguiente inserción (que puede desalojarla)
+        // un valor que pesa más que toda la capacidad se regresa sin guardarlo: no desaloja nada y el siguiente
+        // GetOrAdd de esa llave vuelve a llamar add()
+        inline V &GetOrAdd(const K &key, const std::function<V()> &add)
+        {
+            if (V *value; this->TryGetValue(key, value))
+                return *value;
+
+            V value = add();
+            auto weight = this->weigher(key, value);
+            if (weight > this->capacity)
+                return this->uncached.emplace(std::move(value));
+            return this->Insert(key, std::move(value), weight);
+        }
+
+        inline bool TryRemove(const K &key)
+        {
+            if (size_t i; this->index.TryGetValue(key, i))
+            {
+                this->Evict(i);
+                return true;
+            }
+            return false;
+        }
+
+        inline bool TryRemove(const K &key, V &value)
+        {
+            if (size_t i; this->index.TryGetValue(key, i))
+            {
+                value = std::move(this->slots[i].entry->second);
+                this->Evict(i);
+                return true;
+            }
+            return false;
+        }
+
+        template <typename F>
+        void ForEach(const F &action)
+        {
+            for (auto &slot : this->slots)
+            {
+                if (slot.entry)
+                    action(slot.entry->first, slot.entry->second);
+            }
+        }
+
+        inline void Clear()
+        {
+            this->index.Clear();
+            this->slots.clear();
+            this->free.clear();
+            this->hand = 0;
+            this->weight = 0;
+            this->uncached.reset();
+        }
+    };
+} // namespace Collections
+
+#endif // __COLLECTIONS_CLOCK_CACHE
@@ -1,9 +1,26 @@
 #include <boost/noncopyable.hpp>
 
+#include "BPlusTreeMap.hpp"  
 #include "SortedDictionary.hpp"  
 #include "RocksDBDictionary.hpp"  
+#include "Parallel.hpp"  
+#include "Hash.hpp"  
+#include "FlatHashTable.hpp"  
+#include "MemoryUsage.hpp"  
+#include "MappedSnapshot.hpp"  
+#include "FrozenHashTable.hpp"  
+#include "IncrementalHashMap.hpp"  
 #include "Dictionary.hpp"  
+#include "DictionarySnapshot.hpp"  
 #include "ConcurrentDictionary.hpp"  
+#include "ShardedConcurrentDictionary.hpp"  
+#include "TimingWheel.hpp"  
+#include "ConcurrentExpiringDictionary.hpp"  
+#include "ClockCache.hpp"  
+#include "ConcurrentClockCache.hpp"  
+#include "LockFreeDictionary.hpp"  
+#include "CounterDictionary.hpp"  
+#include "DenseDictionary.hpp"  
 
 #include "Queue.hpp"  
 #include "ConcurrentQueue.hpp"  
@@ -0,0 +1,238 @@
+#ifndef __COLLECTIONS_CONCURRENT_CLOCK_CACHE
+#define __COLLECTIONS_CONCURRENT_CLOCK_CACHE
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "ClockCache.hpp"
+#include "Hash.hpp"
+#include "Locks.hpp"
+
+namespace Collections
+{
+
+    // ClockCache thread safe: las llaves se reparten en shards, cada uno con su ClockCache, su mutex y capacity / shards
+    // (igual que ShardedConcurrentDictionary). Un hit también escribe (la frecuencia y los contadores), por eso todas
+    // las operaciones toman el lock exclusivo de su shard
+    // - la capacidad se reparte exacta: la suma de los shards es capacity (unos llevan una unidad más que otros)
+    // - cada shard desaloja por su cuenta: una entrada que pesa más que su shard (MaxEntryWeight) nunca se guarda.
+    //   Con pesos en bytes hay que pasar shards explícito para que capacity / shards quepa la entrada más grande
+    // M = std::mutex | InstrumentedMutex<...> (contención sumada de todos los shards, ver MutexStats) | propietario
+    template <typename K, typename V, typename W = UnitWeight, typename M = DefaultMutex>
+    class ConcurrentClockCache
+    {
+        struct alignas(64) Shard
+        {
+            M mutex;
+            std::optional<ClockCache<K, V, W>> cache;
+        };
+
+        std::unique_ptr<Shard[]> shards;
+        size_t shard_count, capacity;
+
+        inline Shard &ShardOf(const K &key)
+        {
+            return this->shards[ShardIndex(Hash<K>{}(key), this->shard_count)];
+        }
+
+    public:
+        // unidades de capacidad mínimas por shard al calcular el default
+        static constexpr size_t MinShardCapacity = 64;
+
+        // 4 por core, pero sin dejar shards de menos de MinShardCapacity: un cache chico no se parte en pedazos inútiles
+        static size_t DefaultShardCount(size_t capacity)
+        {
+            size_t by_cores = std::bit_ceil(std::max(1U, std::thread::hardware_concurrency()) * 4U);
+            return std::min(by_cores, std::bit_floor(std::max<size_t>(capacity / MinShardCapacity, 1)));
+        }
+
+        // shards = 0: DefaultShardCount(capacity); se redondea a potencia de 2
+        explicit ConcurrentClockCache(size_t capacity, size_t shards = 0, const W &weigher = W())
+            : capacity(capacity)
+        {
+            this->shard_count = std::bit_ceil(std::max<size_t>(shards ? shards : DefaultShardCount(capacity), 1));
+            this->shards.reset(new Shard[this->shard_count]);
+            for (size_t i = 0; i < this->shard_count; ++i)
+                this->shards[i].cache.emplace(capacity / this->shard_count + (i < capacity % this->shard_count ? 1 : 0), weigher);
+        }
+
+        inline size_t Capacity() const
+        {
+            return this->capacity;
+        }
+
+        inline size_t ShardCount() const
+        {
+            return this->shard_count;
+        }
+
+        // el peso más grande que se puede guardar en cualquier shard
+        inline size_t MaxEntryWeight() const
+        {
+            return this->capacity / this->shard_count;
+        }
+
+        inline size_t Size()
+        {
+            size_t result = 0;
+            for (size_t i = 0; i < this->shard_count; ++i)
+            {
+                WriteLock<M> m(this->shards[i].mutex);
+                result += this->shards[i].cache->Size();
+            }
+            return result;
+        }
+
+        inline bool Any()
+        {
+            return this->Size() != 0;
+        }
+
+        inline size_t Weight()
+        {
+            size_t result = 0;
+            for (size_t i = 0; i < this->shard_count; ++i)
+            {
+                WriteLock<M> m(this->shards[i].mutex);
+                result += this->shards[i].cache->Weight();
+            }
+            return result;
+        }
+
+        // ver Dictionary::MemoryUsage; shard por shard
+        inline size_t MemoryUsage(bool deep = false)
+        {
+            size_t result = sizeof(*this) + AllocationSize(this->shard_count * sizeof(Shard));
+            for (size_t i = 0; i < this->shard_count; ++i)
+            {
+                WriteLock<M> m(this->shards[i].mutex);
+                result += this->shards[i].cache->MemoryUsage(deep) - sizeof(ClockCache<K, V, W>);
+            }
+            return result;
+        }
+
+        // contención de todos los shards sumada, sólo con M = InstrumentedMutex (o COLLECTIONS_LOCK_STATS)
+        // (Stats son los hits / misses del cache)
+        inline LockStats MutexStats() const
+            requires InstrumentedLockable<M>
+        {
+            LockStats result;
+            for (size_t i = 0; i < this->shard_count; ++i)
+                result += this->shards[i].mutex.Stats();
+            return result;
+        }
+
+        // suma de los contadores de todos los shards
+        inline CacheStats Stats()
+        {
+            CacheStats result;
+            for (size_t i = 0; i < this->shard_count; ++i)
+            {
+                WriteLock<M> m(this->shards[i].mutex);
+                result += this->shards[i].cache->Stats();
+            }
+            return result;
+        }
+
+        inline void ResetStats()
+        {
+            for (size_t i = 0; i < this->shard_count; ++i)
+            {
+                WriteLock<M> m(this->shards[i].mutex);
+                this->shards[i].cache->ResetStats();
+            }
+        }
+
+        inline bool ContainsKey(const K &key)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.cache->ContainsKey(key);
+        }
+
+        inline bool TryGetValue(const K &key, V &value)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.cache->TryGetValue(key, value);
+        }
+
+        inline bool TryAdd(const K &key, const V &value)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.cache->TryAdd(key, value);
+        }
+
+        inline bool TryAdd(const K &key, V &&value)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.cache->TryAdd(key, std::move(value));
+        }
+
+        inline bool Add(const K &key, const V &value)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.cache->Add(key, value);
+        }
+
+        inline bool Add(const K &key, V &&value)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.cache->Add(key, std::move(value));
+        }
+
+        // regresa una copia: otro thread puede desalojar la entrada en cuanto se suelta el lock
+        // ojo : add() corre con el lock del shard tomado
+        inline V GetOrAdd(const K &key, const std::function<V()> &add)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.cache->GetOrAdd(key, add);
+        }
+
+        inline bool TryRemove(const K &key)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.cache->TryRemove(key);
+        }
+
+        inline bool TryRemove(const K &key, V &value)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.cache->TryRemove(key, value);
+        }
+
+        // shard por shard
+        template <typename F>
+        void ForEach(const F &action)
+        {
+            for (size_t i = 0; i < this->shard_count; ++i)
+            {
+                WriteLock<M> m(this->shards[i].mutex);
+                this->shards[i].cache->ForEach(action);
+            }
+        }
+
+        inline void Clear()
+        {
+            for (size_t i = 0; i < this->shard_count; ++i)
+            {
+                WriteLock<M> m(this->shards[i].mutex);
+                this->shards[i].cache->Clear();
+            }
+        }
+    };
+} // namespace Collections
+
+#endif // __COLLECTIONS_CONCURRENT_CLOCK_CACHE
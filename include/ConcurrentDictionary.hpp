@@ -1,212 +1,400 @@
 #ifndef __COLLECTIONS_CONCURRENT_DICTIONARY
 #define __COLLECTIONS_CONCURRENT_DICTIONARY
 
+#include <algorithm>
 #include <functional>
+#include <future>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <span>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "Dictionary.hpp"
+#include "DictionarySnapshot.hpp"
+#include "Locks.hpp"
 
 namespace Collections
 {
 
-    template <typename K, typename V>
-    class ConcurrentDictionary : private Dictionary<K, V>
+    // M = std::mutex | std::shared_mutex (lectores simultáneos, para cargas de mayoría lecturas)
+    //     | InstrumentedMutex<...> (contención por instancia, ver Stats) | propietario
+    // B = backend del Dictionary interno (ver Dictionary)
+    // para llaves enteras y V trivialmente copiable con mayoría de lecturas (p.ej. cotizaciones) ver LockFreeDictionary:
+    // lecturas optimistas (seqlock) sin tocar ningún mutex
+    template <typename K, typename V, typename M = DefaultMutex, typename B = std::unordered_map<K, V, Hash<K>, Equal<K>>>
+    class ConcurrentDictionary : private Dictionary<K, V, B>
     {
+        // cálculos de GetOrAdd / TryAdd / AddOrUpdate en curso, por llave; protegidos por mutex
+        std::unordered_map<K, std::shared_future<void>, Hash<K>, Equal<K>> flights;
+
+        // single flight: add() corre sin el lock, así que las demás llaves no esperan a una fábrica lenta;
+        // quien pida la misma llave mientras tanto espera ese mismo cálculo (y recibe su excepción) en vez de repetirlo
+        // present(V&) si la llave ya existe y store(V&&) con el valor calculado se llaman con el lock tomado
+        // ojo : add() no puede pedir su propia llave (se esperaría a sí mismo)
+        template <typename R, typename Q, typename Present, typename Store>
+        inline R SingleFlight(const Q &key, const std::function<V()> &add, const Present &present, const Store &store)
+        {
+            for (;;)
+            {
+                std::promise<void> done;
+                std::shared_future<void> pending;
+                {
+                    WriteLock<M> m(this->mutex);
+                    if (V *value; Dictionary<K, V, B>::TryGetValue(key, value))
+                        return present(*value);
+                    if (auto flight = this->flights.find(key); flight != this->flights.end())
+                        pending = flight->second;
+                    else
+                        this->flights.emplace(K(key), done.get_future().share());
+                }
+
+                if (pending.valid())
+                {
+                    // relanza la excepción de quien calculaba; si terminó bien se vuelve a buscar la llave
+                    pending.get();
+                    continue;
+                }
+
+                std::optional<V> computed;
+                try
+                {
+                    computed.emplace(add());
+                }
+                catch (...)
+                {
+                    {
+                        WriteLock<M> m(this->mutex);
+                        this->flights.erase(this->flights.find(key));
+                    }
+                    done.set_exception(std::current_exception());
+                    throw;
+                }
+
+                // los que esperan despiertan pero necesitan el lock: cuando lo obtengan el valor ya está guardado
+                WriteLock<M> m(this->mutex);
+                this->flights.erase(this->flights.find(key));
+                done.set_value();
+                return store(std::move(*computed));
+            }
+        }
+
     public:
         // al publicar este mutex puedo sincronizar arbitrariamente (problema hunters)
-        std::mutex mutex;
+        M mutex;
 
     public:
         ConcurrentDictionary() = default;
-        ConcurrentDictionary(const std::unordered_map<K, V> &o) : Dictionary<K, V>(o){};
-        ConcurrentDictionary(const Dictionary<K, V> &o) : Dictionary<K, V>(o){};
+        ConcurrentDictionary(const std::unordered_map<K, V> &o) : Dictionary<K, V, B>(o){};
+        ConcurrentDictionary(const Dictionary<K, V, B> &o) : Dictionary<K, V, B>(o){};
+        explicit ConcurrentDictionary(const typename B::allocator_type &allocator) : Dictionary<K, V, B>(allocator) {}
+
+        // contención del mutex, sólo con M = InstrumentedMutex (o COLLECTIONS_LOCK_STATS)
+        inline LockStats Stats() const
+            requires InstrumentedLockable<M>
+        {
+            return this->mutex.Stats();
+        }
 
-        void From(const ConcurrentDictionary<K, V> &src)
+        void From(const ConcurrentDictionary<K, V, M, B> &src)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            Dictionary<K, V>::From(src);
+            WriteLock<M> m(this->mutex);
+            Dictionary<K, V, B>::From(src);
         }
 
         // el operador[] insertará el valor por default en primitivas en donde exista default, de lo contrario, usar GetOrAdd
         V &operator[](const K &key)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::operator[](key);
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::operator[](key);
         }
 
         // el operador[] insertará el valor por default en primitivas en donde exista default, de lo contrario, usar GetOrAdd
         const V &operator[](const K &key) const
         {
-            std::lock_guard<std::mutex> m(const_cast<std::mutex&>(this->mutex));
-            return Dictionary<K, V>::operator[](key);
+            WriteLock<M> m(const_cast<M &>(this->mutex));
+            return Dictionary<K, V, B>::operator[](key);
         }
 
-        typename ConcurrentDictionary<K, V>::iterator begin()
+        typename ConcurrentDictionary<K, V, M, B>::iterator begin()
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::begin();
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::begin();
         }
 
-        typename ConcurrentDictionary<K, V>::iterator end()
+        typename ConcurrentDictionary<K, V, M, B>::iterator end()
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::end();
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::end();
         }
 
-        typename ConcurrentDictionary<K, V>::const_iterator begin() const
+        typename ConcurrentDictionary<K, V, M, B>::const_iterator begin() const
         {
-            std::lock_guard<std::mutex> m(const_cast<std::mutex&>(this->mutex));
-            return Dictionary<K, V>::begin();
+            WriteLock<M> m(const_cast<M &>(this->mutex));
+            return Dictionary<K, V, B>::begin();
         }
 
-        typename ConcurrentDictionary<K, V>::const_iterator end() const
+        typename ConcurrentDictionary<K, V, M, B>::const_iterator end() const
         {
-            std::lock_guard<std::mutex> m(const_cast<std::mutex&>(this->mutex));
-            return Dictionary<K, V>::end();
+            WriteLock<M> m(const_cast<M &>(this->mutex));
+            return Dictionary<K, V, B>::end();
         }
 
         inline std::vector<K> Keys()
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::Keys();
+            ReadLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::Keys();
         }
 
         template <typename F>
         inline std::vector<K> Keys(const F &condition)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::Keys(condition);
+            ReadLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::Keys(condition);
         }
 
         inline std::vector<V> Values()
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::Values();
+            ReadLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::Values();
         }
 
         inline size_t Size()
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::Size();
+            ReadLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::Size();
+        }
+
+        // ver Dictionary::MemoryUsage; deep = true recorre todo con el ReadLock tomado
+        inline size_t MemoryUsage(bool deep = false)
+        {
+            ReadLock<M> m(this->mutex);
+            return sizeof(*this) - sizeof(Dictionary<K, V, B>) + Dictionary<K, V, B>::MemoryUsage(deep) + ContainerMemoryUsage(this->flights);
         }
 
         inline bool Any()
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::Any();
+            ReadLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::Any();
         }
 
         inline void Clear()
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::Clear();
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::Clear();
         }
 
         inline bool TryRemove(const K &key)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::TryRemove(key);
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryRemove(key);
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q>
+        inline bool TryRemove(const Q &key)
+        {
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryRemove(key);
         }
 
         inline V& Incr(const K &key, const V &value)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::operator[](key) += value ;
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::operator[](key) += value ;
         }
 
         inline bool TryRemove(const K &key, V &value)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::TryRemove(key, value);
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryRemove(key, value);
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q>
+        inline bool TryRemove(const Q &key, V &value)
+        {
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryRemove(key, value);
         }
 
         inline bool TryRemove(const K &key, V *&value)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::TryRemove(key, value);
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryRemove(key, value);
         }
 
         inline bool TryRemoveIf(const K &key, const std::function<bool(V&)>& cond)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::TryRemoveIf(key, cond);
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryRemoveIf(key, cond);
         }
 
         inline bool TryRemoveWhen(const K &key, const std::function<bool(V&)>& cond)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::TryRemoveWhen(key, cond);
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryRemoveWhen(key, cond);
         }
 
         template <typename F>
         inline bool TryRemoveExec(const K &key, const F &action)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::TryRemoveExec(key, action);
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryRemoveExec(key, action);
         }
 
         inline bool ContainsKey(const K &key)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::ContainsKey(key);
+            ReadLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::ContainsKey(key);
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q>
+        inline bool ContainsKey(const Q &key)
+        {
+            ReadLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::ContainsKey(key);
         }
 
         inline bool TryCheckValue(const K &key, const std::function<bool(V&)> &cond)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::TryCheckValue(key, cond);
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryCheckValue(key, cond);
         }
 
         inline bool TryGetValue(const K &key, V &value) 
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::TryGetValue(key, value);
+            ReadLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryGetValue(key, value);
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q>
+        inline bool TryGetValue(const Q &key, V &value)
+        {
+            ReadLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryGetValue(key, value);
         }
 
         inline bool TryGetValue(const K &key, V *&value)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::TryGetValue(key, value);
+            ReadLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryGetValue(key, value);
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q>
+        inline bool TryGetValue(const Q &key, V *&value)
+        {
+            ReadLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryGetValue(key, value);
         }
 
         template <typename F>
         inline bool TryGetValueExec(const K &key, const F &action)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::TryGetValueExec(key, action);
+            ReadLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryGetValueExec(key, action);
         }
 
         inline bool TryAdd(const K &key, const V &value)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::TryAdd(key, value);
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryAdd(key, value);
+        }
+
+        inline bool TryAdd(const K &key, V &&value)
+        {
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryAdd(key, std::move(value));
+        }
+
+        inline bool TryAdd(K &&key, V &&value)
+        {
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryAdd(std::move(key), std::move(value));
+        }
+
+        template <typename... Args>
+        inline bool TryEmplace(const K &key, Args &&...args)
+        {
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryEmplace(key, std::forward<Args>(args)...);
+        }
+
+        template <typename... Args>
+        inline bool TryEmplace(K &&key, Args &&...args)
+        {
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryEmplace(std::move(key), std::forward<Args>(args)...);
+        }
+
+        template <typename Q, typename U>
+            requires HeterogeneousKey<B, Q> && std::constructible_from<K, const Q &> && std::constructible_from<V, U &&>
+        inline bool TryAdd(const Q &key, U &&value)
+        {
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryAdd(key, std::forward<U>(value));
         }
 
         // nueva - para megahub
         inline bool TryAdd(const std::function<K()> &key, const V &value)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::TryAdd(key(), value);
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryAdd(key(), value);
         }
 
+        // function() corre sin el lock, ver SingleFlight
         inline bool TryAdd(const K &key, const std::function<V()> &function)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::TryAdd(key, function);
+            return this->template SingleFlight<bool>(
+                key, function, [](V &)
+                { return false; },
+                [&](V &&value)
+                { return B::try_emplace(key, std::move(value)).second; });
         }
 
         inline bool Add(const K &key, const V &value)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::Add(key, value);
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::Add(key, value);
+        }
+
+        inline bool Add(const K &key, V &&value)
+        {
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::Add(key, std::move(value));
+        }
+
+        inline bool Add(K &&key, V &&value)
+        {
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::Add(std::move(key), std::move(value));
         }
                 
+        // add() corre sin el lock y una sola vez por llave aunque varios threads la pidan juntos, ver SingleFlight
         inline V &GetOrAdd(const K &key, const std::function<V()> &add)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::GetOrAdd(key, add);
+            return this->template SingleFlight<V &>(
+                key, add, [](V &value) -> V &
+                { return value; },
+                [&](V &&value) -> V &
+                { return B::try_emplace(key, std::move(value)).first->second; });
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q> && std::constructible_from<K, const Q &>
+        inline V & GetOrAdd(const Q &key, const std::function<V()> &add)
+        {
+            return this->template SingleFlight<V &>(
+                key, add, [](V &value) -> V &
+                { return value; },
+                [&](V &&value) -> V &
+                { return B::try_emplace(K(key), std::move(value)).first->second; });
         }
 
         inline V &GetOrAdd(const K &key)
@@ -216,43 +404,187 @@ namespace Collections
 
         inline V &GetOrAddNew(const K &key)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::GetOrAddNew(key);
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::GetOrAddNew(key);
         }
         
         inline V &GetOrAddOrNull(const K &key, const std::function<V()> &add)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::GetOrAddOrNull(key, add);
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::GetOrAddOrNull(key, add);
         }
                 
         
+        // add() corre sin el lock (ver SingleFlight); update() sí con el lock tomado
+        // si alguien agrega la llave mientras add() calcula, el valor calculado se descarta y se aplica update()
         inline void AddOrUpdate(const K &key, const std::function<V()> &add, const std::function<void(V&)> &update)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            return Dictionary<K, V>::AddOrUpdate(key, add, update);
+            this->template SingleFlight<void>(
+                key, add, update,
+                [&](V &&value)
+                {
+                    if (auto [kvp, added] = B::try_emplace(key, std::move(value)); !added)
+                        update(kvp->second);
+                });
+        }
+
+        inline void Reserve(size_t n)
+        {
+            WriteLock<M> m(this->mutex);
+            Dictionary<K, V, B>::Reserve(n);
+        }
+
+        inline void SetMaxLoadFactor(float max_load_factor)
+        {
+            WriteLock<M> m(this->mutex);
+            Dictionary<K, V, B>::SetMaxLoadFactor(max_load_factor);
+        }
+
+        inline void ShrinkToFit()
+        {
+            WriteLock<M> m(this->mutex);
+            Dictionary<K, V, B>::ShrinkToFit();
+        }
+
+        // los lotes se aplican completos dentro de una sola sección crítica (ver Dictionary::TryAddRange)
+        template <typename I>
+        inline std::vector<bool> TryAddRange(I first, I last)
+        {
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryAddRange(first, last);
+        }
+
+        template <typename I>
+        inline std::vector<bool> AddRange(I first, I last)
+        {
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::AddRange(first, last);
+        }
+
+        template <typename I>
+        inline std::vector<bool> RemoveRange(I first, I last)
+        {
+            WriteLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::RemoveRange(first, last);
+        }
+
+        // sólo la versión que copia: un apuntador al valor no sirve de nada fuera del lock
+        inline std::vector<bool> TryGetMany(std::span<const K> keys, std::span<V> values)
+        {
+            ReadLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::TryGetMany(keys, values);
         }
 
         template <typename F>
         void Transform(const F &action)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            Dictionary<K, V>::Transform(action);
+            WriteLock<M> m(this->mutex);
+            Dictionary<K, V, B>::Transform(action);
         }
 
+        // ojo : action corre con el lock tomado; para recorrer un mapa grande sin detener a los escritores ver ForEachChunked
         template <typename F>
         void ForEach(const F &action)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            Dictionary<K, V>::ForEach(action);
+            WriteLock<M> m(this->mutex);
+            Dictionary<K, V, B>::ForEach(action);
+        }
+
+        // el lock se toma una vez y el recorrido se reparte entre los cores (ver Dictionary::ParallelForEach)
+        template <typename F>
+        void ParallelForEach(const F &action, size_t workers = 0)
+        {
+            WriteLock<M> m(this->mutex);
+            Dictionary<K, V, B>::ParallelForEach(action, workers);
+        }
+
+        template <typename F>
+        void ParallelTransform(const F &action, size_t workers = 0)
+        {
+            WriteLock<M> m(this->mutex);
+            Dictionary<K, V, B>::ParallelTransform(action, workers);
+        }
+
+        template <typename F>
+        std::vector<K> ParallelKeys(const F &condition, size_t workers = 0)
+        {
+            ReadLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::ParallelKeys(condition, workers);
+        }
+
+        template <typename T, typename Map, typename Combine>
+        T Reduce(T init, const Map &map, const Combine &combine, size_t workers = 0)
+        {
+            ReadLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::Reduce(std::move(init), map, combine, workers);
+        }
+
+        // copia de sólo lectura con hash perfecto mínimo (ver Dictionary::Freeze); se puede leer sin este mutex
+        inline FrozenDictionary<K, V, typename B::hasher, typename B::key_equal> Freeze()
+        {
+            ReadLock<M> m(this->mutex);
+            return Dictionary<K, V, B>::Freeze();
+        }
+
+        // foto de sólo lectura en un instante: se copia bajo ReadLock y después se recorre sin lock todo lo que se quiera
+        // ojo : la copia es O(n) (un nodo por elemento) con el lock tomado, los escritores esperan más que con un ForEach
+        // barato; sirve cuando hace falta un instante único o recorrer varias veces. Para no detener a los escritores
+        // usar ForEachChunked (espera acotada a un grupo de cubetas) o ShardedConcurrentDictionary::Snapshot (a un shard)
+        DictionarySnapshot<K, V, B> Snapshot()
+        {
+            ReadLock<M> m(this->mutex);
+            return DictionarySnapshot<K, V, B>({std::make_shared<const B>(static_cast<const B &>(*this))});
+        }
+
+        // recorrido cubeta por cubeta: copia `buckets` cubetas bajo el lock, lo suelta y llama action(kvp) sobre la copia,
+        // así un escritor espera a lo más la copia de un grupo. No es una foto: ve al menos una vez cada llave presente
+        // durante todo el recorrido; si la tabla hace rehash a mitad del camino se reinicia y algunas llaves se repiten
+        template <typename F>
+            requires requires(const B &b, size_t n) { b.begin(n); b.end(n); }
+        void ForEachChunked(const F &action, size_t buckets = 1024)
+        {
+            std::vector<typename B::value_type> chunk;
+            for (size_t bucket = 0, bucket_count = 0;;)
+            {
+                {
+                    ReadLock<M> m(this->mutex);
+                    if (B::bucket_count() != bucket_count)
+                    {
+                        bucket = 0;
+                        bucket_count = B::bucket_count();
+                    }
+                    if (bucket >= bucket_count)
+                        return;
+
+                    chunk.clear();
+                    for (auto last = std::min(bucket + buckets, bucket_count); bucket < last; ++bucket)
+                    {
+                        for (auto kvp = B::cbegin(bucket); kvp != B::cend(bucket); ++kvp)
+                            chunk.push_back(*kvp);
+                    }
+                }
+                std::for_each(chunk.begin(), chunk.end(), action);
+            }
         }
 
         void FromMap(const std::unordered_map<K, V> &map)
         {
-            std::lock_guard<std::mutex> m(this->mutex);
-            Dictionary<K, V>::FromMap(map);
+            WriteLock<M> m(this->mutex);
+            Dictionary<K, V, B>::FromMap(map);
         }
     };
+
+    namespace pmr
+    {
+        template <typename K, typename V, typename M = DefaultMutex>
+        using ConcurrentDictionary = Collections::ConcurrentDictionary<K, V, M, std::pmr::unordered_map<K, V, Hash<K>, Equal<K>>>;
+    } // namespace pmr
+
+    namespace counted
+    {
+        template <typename K, typename V, typename M = DefaultMutex>
+        using ConcurrentDictionary = Collections::ConcurrentDictionary<K, V, M, std::unordered_map<K, V, Hash<K>, Equal<K>, CountingAllocator<std::pair<const K, V>>>>;
+    } // namespace counted
 } // namespace Collections
 
 #endif // __COLLECTIONS_CONCURRENT_DICTIONARY
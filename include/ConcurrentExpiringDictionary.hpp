@@ -0,0 +1,325 @@
+#ifndef __COLLECTIONS_CONCURRENT_EXPIRING_DICTIONARY
+#define __COLLECTIONS_CONCURRENT_EXPIRING_DICTIONARY
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Dictionary.hpp"
+#include "Locks.hpp"
+#include "TimingWheel.hpp"
+
+namespace Collections
+{
+
+    // Diccionario concurrente con vencimiento (TTL) por llave, para caches de sesiones / órdenes
+    // - cada llave vence ttl después de TryAdd / Add / AddOrUpdate; Touch (o un TTL explícito) le recorre el vencimiento
+    // - los vencimientos viven en una TimingWheel: limpiar cuesta O(vencidas), nunca O(tamaño), y no hace falta un
+    //   barrido externo con Keys() + TryRemoveIf
+    // - la limpieza corre dentro de cada escritura (o explícitamente con RemoveExpired); las lecturas ya no ven las
+    //   llaves vencidas aunque todavía no se hayan limpiado, pero Size() sí las cuenta hasta entonces
+    // Clock = std::chrono::steady_clock | cualquier reloj con now() estático (p.ej. uno falso para pruebas)
+    // M = std::mutex | std::shared_mutex | InstrumentedMutex<...> (contención por instancia, ver Stats) | propietario
+    template <typename K, typename V, typename Clock = std::chrono::steady_clock, typename M = DefaultMutex>
+    class ConcurrentExpiringDictionary
+    {
+        using TimePoint = typename Clock::time_point;
+        using Duration = typename Clock::duration;
+
+        struct Entry
+        {
+            V value;
+            TimePoint deadline;
+            // tick con el que la llave está en la rueda; los timers con otro tick son viejos y se ignoran
+            uint64_t scheduled;
+        };
+
+        M mutex;
+        Duration ttl, resolution;
+        Dictionary<K, Entry> entries;
+        TimingWheel<K> wheel;
+
+        // los vencimientos se redondean hacia arriba y el reloj hacia abajo: una llave nunca se borra antes de tiempo
+        inline uint64_t TickOf(TimePoint deadline) const
+        {
+            return static_cast<uint64_t>((deadline.time_since_epoch() + this->resolution - Duration(1)) / this->resolution);
+        }
+
+        inline uint64_t CurrentTick(TimePoint now) const
+        {
+            return static_cast<uint64_t>(now.time_since_epoch() / this->resolution);
+        }
+
+        // se llama con el lock tomado
+        template <typename F>
+        inline size_t Expire(TimePoint now, const F &expired)
+        {
+            size_t result = 0;
+            this->wheel.Advance(this->CurrentTick(now), [&](K &&key, uint64_t tick)
+                                {
+                Entry *entry;
+                if (!this->entries.TryGetValue(key, entry) || entry->scheduled != tick)
+                    return;
+                if (entry->deadline <= now)
+                {
+                    expired(key, entry->value);
+                    this->entries.TryRemove(key);
+                    ++result;
+                }
+                else
+                {
+                    // la tocaron después de programarla: se vuelve a programar en su vencimiento nuevo
+                    entry->scheduled = this->TickOf(entry->deadline);
+                    this->wheel.Schedule(std::move(key), entry->scheduled);
+                } });
+            return result;
+        }
+
+        inline void Expire(TimePoint now)
+        {
+            this->Expire(now, [](const K &, V &) {});
+        }
+
+        // se llama con el lock tomado; sólo va a la rueda si el vencimiento es anterior al que ya está programado
+        inline void SetDeadline(const K &key, Entry &entry, TimePoint deadline, bool fresh)
+        {
+            entry.deadline = deadline;
+            if (auto tick = this->TickOf(deadline); fresh || tick < entry.scheduled)
+            {
+                entry.scheduled = tick;
+                this->wheel.Schedule(key, tick);
+            }
+        }
+
+    public:
+        explicit ConcurrentExpiringDictionary(Duration ttl, Duration resolution = std::chrono::milliseconds(1))
+            : ttl(ttl), resolution(resolution), wheel(this->CurrentTick(Clock::now()))
+        {
+        }
+
+        inline Duration TimeToLive() const
+        {
+            return this->ttl;
+        }
+
+        // contención del mutex, sólo con M = InstrumentedMutex (o COLLECTIONS_LOCK_STATS)
+        inline LockStats Stats() const
+            requires InstrumentedLockable<M>
+        {
+            return this->mutex.Stats();
+        }
+
+        // incluye llaves vencidas que todavía no se limpian
+        inline size_t Size()
+        {
+            ReadLock<M> m(this->mutex);
+            return this->entries.Size();
+        }
+
+        inline bool Any()
+        {
+            return this->Size() != 0;
+        }
+
+        // ver Dictionary::MemoryUsage; incluye las llaves vencidas sin limpiar y los timers viejos que siguen en la rueda
+        inline size_t MemoryUsage(bool deep = false)
+        {
+            ReadLock<M> m(this->mutex);
+            size_t result = sizeof(*this) - sizeof(this->entries) - sizeof(this->wheel) + this->entries.MemoryUsage() + this->wheel.MemoryUsage(deep);
+            if (deep)
+            {
+                for (auto &kvp : this->entries)
+                    result += HeapSizeOf(kvp.first) + HeapSizeOf(kvp.second.value);
+            }
+            return result;
+        }
+
+        inline bool TryAdd(const K &key, const V &value, Duration ttl)
+        {
+            auto now = Clock::now();
+            WriteLock<M> m(this->mutex);
+            this->Expire(now);
+            if (Entry *found; this->entries.TryGetValue(key, found) && found->deadline > now)
+                return false;
+            auto &entry = this->entries[key];
+            entry.value = value;
+            this->SetDeadline(key, entry, now + ttl, true);
+            return true;
+        }
+
+        inline bool TryAdd(const K &key, const V &value)
+        {
+            return this->TryAdd(key, value, this->ttl);
+        }
+
+        // inserta o reemplaza el valor y le recorre el vencimiento; true si la llave es nueva
+        inline bool Add(const K &key, const V &value, Duration ttl)
+        {
+            auto now = Clock::now();
+            WriteLock<M> m(this->mutex);
+            this->Expire(now);
+            Entry *found;
+            bool fresh = !this->entries.TryGetValue(key, found) || found->deadline <= now;
+            auto &entry = this->entries[key];
+            entry.value = value;
+            this->SetDeadline(key, entry, now + ttl, fresh);
+            return fresh;
+        }
+
+        inline bool Add(const K &key, const V &value)
+        {
+            return this->Add(key, value, this->ttl);
+        }
+
+        inline void AddOrUpdate(const K &key, const std::function<V()> &add, const std::function<void(V &)> &update, Duration ttl)
+        {
+            auto now = Clock::now();
+            WriteLock<M> m(this->mutex);
+            this->Expire(now);
+            // una llave vencida que todavía no se limpia cuenta como nueva
+            Entry *entry;
+            if (this->entries.TryGetValue(key, entry) && entry->deadline > now)
+            {
+                update(entry->value);
+                this->SetDeadline(key, *entry, now + ttl, false);
+            }
+            else
+            {
+                auto &added = this->entries[key];
+                added.value = add();
+                this->SetDeadline(key, added, now + ttl, true);
+            }
+        }
+
+        inline void AddOrUpdate(const K &key, const std::function<V()> &add, const std::function<void(V &)> &update)
+        {
+            this->AddOrUpdate(key, add, update, this->ttl);
+        }
+
+        // recorre el vencimiento de una llave viva; false si no existe o ya venció
+        inline bool Touch(const K &key, Duration ttl)
+        {
+            auto now = Clock::now();
+            WriteLock<M> m(this->mutex);
+            this->Expire(now);
+            Entry *entry;
+            if (!this->entries.TryGetValue(key, entry) || entry->deadline <= now)
+                return false;
+            this->SetDeadline(key, *entry, now + ttl, false);
+            return true;
+        }
+
+        inline bool Touch(const K &key)
+        {
+            return this->Touch(key, this->ttl);
+        }
+
+        inline bool ContainsKey(const K &key)
+        {
+            auto now = Clock::now();
+            ReadLock<M> m(this->mutex);
+            Entry *entry;
+            return this->entries.TryGetValue(key, entry) && entry->deadline > now;
+        }
+
+        inline bool TryGetValue(const K &key, V &value)
+        {
+            auto now = Clock::now();
+            ReadLock<M> m(this->mutex);
+            if (Entry *entry; this->entries.TryGetValue(key, entry) && entry->deadline > now)
+            {
+                value = entry->value;
+                return true;
+            }
+            return false;
+        }
+
+        // tiempo que le queda a la llave; false si no existe o ya venció
+        inline bool TryGetTimeToLive(const K &key, Duration &ttl)
+        {
+            auto now = Clock::now();
+            ReadLock<M> m(this->mutex);
+            if (Entry *entry; this->entries.TryGetValue(key, entry) && entry->deadline > now)
+            {
+                ttl = entry->deadline - now;
+                return true;
+            }
+            return false;
+        }
+
+        // el timer que quede en la rueda se ignora al vencer (ver Entry::scheduled); false si no existía o ya había vencido
+        inline bool TryRemove(const K &key)
+        {
+            auto now = Clock::now();
+            WriteLock<M> m(this->mutex);
+            Entry *entry;
+            if (!this->entries.TryGetValue(key, entry))
+                return false;
+            bool alive = entry->deadline > now;
+            this->entries.TryRemove(key);
+            return alive;
+        }
+
+        inline bool TryRemove(const K &key, V &value)
+        {
+            auto now = Clock::now();
+            WriteLock<M> m(this->mutex);
+            if (Entry *entry; this->entries.TryGetValue(key, entry) && entry->deadline > now)
+            {
+                value = std::move(entry->value);
+                return this->entries.TryRemove(key);
+            }
+            return false;
+        }
+
+        // limpia las vencidas y regresa cuántas fueron; para un thread de limpieza cuando hay pocas escrituras
+        inline size_t RemoveExpired()
+        {
+            return this->RemoveExpired([](const K &, V &) {});
+        }
+
+        // expired(key, value) se llama con cada llave vencida antes de borrarla, con el lock tomado
+        template <typename F>
+        inline size_t RemoveExpired(const F &expired)
+        {
+            auto now = Clock::now();
+            WriteLock<M> m(this->mutex);
+            return this->Expire(now, expired);
+        }
+
+        // sólo las llaves vivas
+        template <typename F>
+        void ForEach(const F &action)
+        {
+            auto now = Clock::now();
+            WriteLock<M> m(this->mutex);
+            for (auto &[key, entry] : this->entries)
+            {
+                if (entry.deadline > now)
+                    action(key, entry.value);
+            }
+        }
+
+        inline std::vector<K> Keys()
+        {
+            std::vector<K> result;
+            this->ForEach([&result](const K &key, V &)
+                          { result.push_back(key); });
+            return result;
+        }
+
+        inline void Clear()
+        {
+            WriteLock<M> m(this->mutex);
+            this->entries.Clear();
+            this->wheel.Clear();
+        }
+    };
+} // namespace Collections
+
+#endif // __COLLECTIONS_CONCURRENT_EXPIRING_DICTIONARY
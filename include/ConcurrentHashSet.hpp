@@ -2,77 +2,143 @@
 #define __COLLECIONS_CONCURRENT_HASHSET
 
 #include <mutex>
+#include <shared_mutex>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "HashSet.hpp"
+#include "Locks.hpp"
 
 namespace Collections
 {
-template <typename T>
-class ConcurrentHashSet : private HashSet<T>
+// M = std::mutex | std::shared_mutex (lectores simultáneos, para cargas de mayoría lecturas)
+//     | InstrumentedMutex<...> (contención por instancia, ver Stats) | propietario
+// B = backend del HashSet interno (ver HashSet)
+template <typename T, typename M = DefaultMutex, typename B = std::unordered_set<T, Hash<T>, Equal<T>>>
+class ConcurrentHashSet : private HashSet<T, B>
 {
-    std::mutex mutex;
+    M mutex;
 
 public:
-    typename ConcurrentHashSet<T>::iterator begin()
+    ConcurrentHashSet() = default;
+    explicit ConcurrentHashSet(const typename B::allocator_type &allocator) : HashSet<T, B>(allocator) {}
+
+    // contención del mutex, sólo con M = InstrumentedMutex (o COLLECTIONS_LOCK_STATS)
+    inline LockStats Stats() const
+        requires InstrumentedLockable<M>
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        return HashSet<T>::begin();
+        return this->mutex.Stats();
     }
 
-    typename ConcurrentHashSet<T>::iterator end()
+    typename ConcurrentHashSet<T, M, B>::iterator begin()
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        return HashSet<T>::end();
+        WriteLock<M> m(this->mutex);
+        return HashSet<T, B>::begin();
     }
 
-    typename ConcurrentHashSet<T>::const_iterator begin() const
+    typename ConcurrentHashSet<T, M, B>::iterator end()
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        return HashSet<T>::begin();
+        WriteLock<M> m(this->mutex);
+        return HashSet<T, B>::end();
     }
 
-    typename ConcurrentHashSet<T>::const_iterator end() const
+    typename ConcurrentHashSet<T, M, B>::const_iterator begin() const
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        return HashSet<T>::end();
+        ReadLock<M> m(const_cast<M &>(this->mutex));
+        return HashSet<T, B>::begin();
+    }
+
+    typename ConcurrentHashSet<T, M, B>::const_iterator end() const
+    {
+        ReadLock<M> m(const_cast<M &>(this->mutex));
+        return HashSet<T, B>::end();
     }
 
     std::unordered_set<T> Clone()
     {            
-        std::lock_guard<std::mutex> m(this->mutex);
-        return HashSet<T>::Clone();
+        ReadLock<M> m(this->mutex);
+        return HashSet<T, B>::Clone();
     }
 
     size_t Size()
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        return HashSet<T>::Size();
+        ReadLock<M> m(this->mutex);
+        return HashSet<T, B>::Size();
+    }
+
+    // ver Dictionary::MemoryUsage
+    inline size_t MemoryUsage(bool deep = false)
+    {
+        ReadLock<M> m(this->mutex);
+        return sizeof(*this) - sizeof(HashSet<T, B>) + HashSet<T, B>::MemoryUsage(deep);
     }
 
     inline bool Any()
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        return HashSet<T>::Any();
+        ReadLock<M> m(this->mutex);
+        return HashSet<T, B>::Any();
     }
 
     void Insert(const T &t)
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        HashSet<T>::Insert(t);
+        WriteLock<M> m(this->mutex);
+        HashSet<T, B>::Insert(t);
+    }
+
+    void Insert(T &&t)
+    {
+        WriteLock<M> m(this->mutex);
+        HashSet<T, B>::Insert(std::move(t));
+    }
+
+    template <typename... Args>
+    bool Emplace(Args &&...args)
+    {
+        WriteLock<M> m(this->mutex);
+        return HashSet<T, B>::Emplace(std::forward<Args>(args)...);
     }
 
     bool TryInsert(const T &t)
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        return HashSet<T>::TryInsert(t);
+        WriteLock<M> m(this->mutex);
+        return HashSet<T, B>::TryInsert(t);
+    }
+
+    bool TryInsert(T &&t)
+    {
+        WriteLock<M> m(this->mutex);
+        return HashSet<T, B>::TryInsert(std::move(t));
+    }
+
+    template <typename Q>
+        requires HeterogeneousKey<B, Q> && std::constructible_from<T, const Q &>
+    bool TryInsert(const Q &t)
+    {
+        WriteLock<M> m(this->mutex);
+        return HashSet<T, B>::TryInsert(t);
+    }
+
+    // todo el lote en una sola sección crítica (ver HashSet::InsertRange)
+    template <typename I>
+    std::vector<bool> InsertRange(I first, I last)
+    {
+        WriteLock<M> m(this->mutex);
+        return HashSet<T, B>::InsertRange(first, last);
     }
 
     bool Exists(const T &t)
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        return HashSet<T>::Exists(t);
+        ReadLock<M> m(this->mutex);
+        return HashSet<T, B>::Exists(t);
+    }
+
+    template <typename Q>
+        requires HeterogeneousKey<B, Q>
+    bool Exists(const Q &t)
+    {
+        ReadLock<M> m(this->mutex);
+        return HashSet<T, B>::Exists(t);
     }
 
     bool Contains(const T& t) 
@@ -80,32 +146,59 @@ public:
         return this->Exists(t);
     }
 
+    template <typename Q>
+        requires HeterogeneousKey<B, Q>
+    bool Contains(const Q &t)
+    {
+        return this->Exists(t);
+    }
+
     void Remove(const T &t)
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        return HashSet<T>::Remove(t);
+        WriteLock<M> m(this->mutex);
+        return HashSet<T, B>::Remove(t);
     }
 
     bool TryRemove(const T &t)
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        return HashSet<T>::TryRemove(t);
+        WriteLock<M> m(this->mutex);
+        return HashSet<T, B>::TryRemove(t);
+    }
+
+    template <typename Q>
+        requires HeterogeneousKey<B, Q>
+    bool TryRemove(const Q &t)
+    {
+        WriteLock<M> m(this->mutex);
+        return HashSet<T, B>::TryRemove(t);
     }
 
     void Clear()
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        return HashSet<T>::Clear();
+        WriteLock<M> m(this->mutex);
+        return HashSet<T, B>::Clear();
     }
 
     template <typename F>
     void ForEach(const F &action)
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        return HashSet<T>::ForEach( action ) ;        
+        ReadLock<M> m(this->mutex);
+        return HashSet<T, B>::ForEach( action ) ;        
     }
 };
 
+namespace pmr
+{
+    template <typename T, typename M = DefaultMutex>
+    using ConcurrentHashSet = Collections::ConcurrentHashSet<T, M, std::pmr::unordered_set<T, Hash<T>, Equal<T>>>;
+} // namespace pmr
+
+namespace counted
+{
+    template <typename T, typename M = DefaultMutex>
+    using ConcurrentHashSet = Collections::ConcurrentHashSet<T, M, std::unordered_set<T, Hash<T>, Equal<T>, CountingAllocator<T>>>;
+} // namespace counted
+
 } // namespace Collections
 
 #endif // __COLLECIONS_CONCURRENT_HASHSET
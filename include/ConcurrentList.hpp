@@ -3,80 +3,102 @@
 
 #include <chrono>
 #include <functional>
+#include <memory>
+#include <memory_resource>
 #include <mutex>
 #include <unordered_map>
 #include <vector>
 #include <utility>
 
+#include "Locks.hpp"
+
 namespace Collections
 {
 
-template <typename V>
-class ConcurrentList : private List<V>
+// M = std::mutex | InstrumentedMutex<...> (contención por instancia, ver Stats) | propietario
+template <typename V, typename A = std::allocator<V>, typename M = DefaultMutex>
+class ConcurrentList : private List<V, A>
 {    
-    std::mutex mutex ;
+    M mutex ;
 
 public:
+    ConcurrentList() = default;
+    explicit ConcurrentList(const A &allocator) : List<V, A>(allocator) {}
+
+    // contención del mutex, sólo con M = InstrumentedMutex (o COLLECTIONS_LOCK_STATS)
+    inline LockStats Stats() const
+        requires InstrumentedLockable<M>
+    {
+        return this->mutex.Stats();
+    }
+
     // el operador[] insertará el valor por default en primitivas en donde exista default, de lo contrario, usar GetOrAdd
     inline V &operator[](int i)
     {
-        std::lock_guard<std::mutex> m(this->mutex); 
-        return List<V>::operator[](i);
+        WriteLock<M> m(this->mutex);
+        return List<V, A>::operator[](i);
     }
 
     // el operador[] insertará el valor por default en primitivas en donde exista default, de lo contrario, usar GetOrAdd
     const inline V &operator[](int i) const
     {
-        std::lock_guard<std::mutex> m(this->mutex); 
-        return List<V>::operator[](i);
+        ReadLock<M> m(const_cast<M &>(this->mutex));
+        return List<V, A>::operator[](i);
     }
 
-    typename List<V>::iterator begin()
+    typename List<V, A>::iterator begin()
     {
-        std::lock_guard<std::mutex> m(this->mutex); 
-        return List<V>::begin();
+        WriteLock<M> m(this->mutex);
+        return List<V, A>::begin();
     }
 
-    typename List<V>::iterator end()
+    typename List<V, A>::iterator end()
     {
-        std::lock_guard<std::mutex> m(this->mutex); 
-        return List<V>::end();
+        WriteLock<M> m(this->mutex);
+        return List<V, A>::end();
     }
 
-    typename List<V>::const_iterator begin() const
+    typename List<V, A>::const_iterator begin() const
     {
-        std::lock_guard<std::mutex> m(const_cast<std::mutex&>(this->mutex));
-        return List<V>::begin();
+        ReadLock<M> m(const_cast<M &>(this->mutex));
+        return List<V, A>::begin();
     }
 
-    typename List<V>::const_iterator end() const
+    typename List<V, A>::const_iterator end() const
     {
-        std::lock_guard<std::mutex> m(const_cast<std::mutex&>(this->mutex));
-        return List<V>::end();
+        ReadLock<M> m(const_cast<M &>(this->mutex));
+        return List<V, A>::end();
     }
     
     inline bool Any()
     {
-        std::lock_guard<std::mutex> m(this->mutex); 
-        return !List<V>::empty();
+        WriteLock<M> m(this->mutex);
+        return !List<V, A>::empty();
     }
 
     inline size_t Size()
     {
-        std::lock_guard<std::mutex> m(this->mutex); 
-        return List<V>::size();
+        WriteLock<M> m(this->mutex);
+        return List<V, A>::size();
+    }
+
+    // ver Dictionary::MemoryUsage
+    inline size_t MemoryUsage(bool deep = false)
+    {
+        WriteLock<M> m(this->mutex);
+        return sizeof(*this) - sizeof(List<V, A>) + List<V, A>::MemoryUsage(deep);
     }
 
     inline void Clear()
     {
-        std::lock_guard<std::mutex> m(this->mutex); 
-        return List<V>::clear();
+        WriteLock<M> m(this->mutex);
+        return List<V, A>::clear();
     }
 
     inline void Remove(int i)
     {
-        std::lock_guard<std::mutex> m(this->mutex); 
-        List<V>::erase(List<V>::begin()+i);
+        WriteLock<M> m(this->mutex);
+        List<V, A>::erase(List<V, A>::begin()+i);
     }
 
     inline void Add(const V &value)
@@ -84,32 +106,63 @@ public:
         this->Push(value);
     }   
         
+    inline void Add(V &&value)
+    {
+        this->Push(std::move(value));
+    }
+
     inline void Push(const V &value)
     {
-        std::lock_guard<std::mutex> m(this->mutex); 
-        List<V>::push_back(value);
+        WriteLock<M> m(this->mutex);
+        List<V, A>::push_back(value);
     }
-    
-    inline void Pop(const V &value)
+
+    inline void Push(V &&value)
+    {
+        WriteLock<M> m(this->mutex);
+        List<V, A>::Push(std::move(value));
+    }
+
+    // no regresa la referencia: fuera del lock otro thread puede reubicar el vector
+    template <typename... Args>
+    inline void Emplace(Args &&...args)
     {
-        std::lock_guard<std::mutex> m(this->mutex); 
-        List<V>::pop_back(value);
+        WriteLock<M> m(this->mutex);
+        List<V, A>::Emplace(std::forward<Args>(args)...);
+    }
+
+    inline bool Pop(V &value)
+    {
+        WriteLock<M> m(this->mutex);
+        return List<V, A>::Pop(value);
     }
 
     template <typename F>
     inline void Transform(const F& action)
     {
-        std::lock_guard<std::mutex> m(this->mutex); 
-        std::transform( this->begin(), this->end(), this->begin(), action ) ;
+        WriteLock<M> m(this->mutex);
+        std::transform(List<V, A>::begin(), List<V, A>::end(), List<V, A>::begin(), action);
     }
 
     void FromVector(const std::vector<V> &vector)
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        List<V>::FromVector(vector);
+        WriteLock<M> m(this->mutex);
+        List<V, A>::FromVector(vector);
     }
     
 };
+
+namespace pmr
+{
+    template <typename V>
+    using ConcurrentList = Collections::ConcurrentList<V, std::pmr::polymorphic_allocator<V>>;
+} // namespace pmr
+
+namespace counted
+{
+    template <typename V>
+    using ConcurrentList = Collections::ConcurrentList<V, CountingAllocator<V>>;
+} // namespace counted
 } // namespace Collections
 
 #endif // __COLLECTIONS_DICTIONARY
@@ -1,83 +1,137 @@
 #ifndef __COLLECIONS_CONCURRENT_QUEUE
 #define __COLLECIONS_CONCURRENT_QUEUE
 
+#include <deque>
 #include <mutex>
+#include <utility>
+
+#include "Locks.hpp"
 
 namespace Collections
 {
 
-template <typename T>
-class ConcurrentQueue : private Queue<T>
+// M = std::mutex | InstrumentedMutex<...> (contención por instancia, ver Stats) | propietario
+template <typename T, typename C = std::deque<T>, typename M = DefaultMutex>
+class ConcurrentQueue : private Queue<T, C>
 {
-    std::mutex mutex;
+    M mutex;
 
 public:
+    ConcurrentQueue() = default;
+    explicit ConcurrentQueue(const typename C::allocator_type &allocator) : Queue<T, C>(allocator) {}
+
+    // contención del mutex, sólo con M = InstrumentedMutex (o COLLECTIONS_LOCK_STATS)
+    inline LockStats Stats() const
+        requires InstrumentedLockable<M>
+    {
+        return this->mutex.Stats();
+    }
 
     // en std la std::queue no tiene iteradores
 
     inline int Size()
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        return Queue<T>::Size();
+        WriteLock<M> m(this->mutex);
+        return Queue<T, C>::Size();
+    }
+
+    // ver Dictionary::MemoryUsage
+    inline size_t MemoryUsage(bool deep = false)
+    {
+        WriteLock<M> m(this->mutex);
+        return sizeof(*this) - sizeof(Queue<T, C>) + Queue<T, C>::MemoryUsage(deep);
     }
 
     inline bool Any()
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        return Queue<T>::Any();
+        WriteLock<M> m(this->mutex);
+        return Queue<T, C>::Any();
     }
 
     void Enqueue(const T &t)
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        Queue<T>::Enqueue(t);
+        WriteLock<M> m(this->mutex);
+        Queue<T, C>::Enqueue(t);
+    }
+
+    void Enqueue(T &&t)
+    {
+        WriteLock<M> m(this->mutex);
+        Queue<T, C>::Enqueue(std::move(t));
+    }
+
+    template <typename... Args>
+    void Emplace(Args &&...args)
+    {
+        WriteLock<M> m(this->mutex);
+        Queue<T, C>::Emplace(std::forward<Args>(args)...);
+    }
+
+    // todo el lote en una sola sección crítica
+    template <typename I>
+    size_t EnqueueRange(I first, I last)
+    {
+        WriteLock<M> m(this->mutex);
+        return Queue<T, C>::EnqueueRange(first, last);
     }
 
     bool TryDequeue(T *&t)
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        return Queue<T>::TryDequeue(t);
+        WriteLock<M> m(this->mutex);
+        return Queue<T, C>::TryDequeue(t);
     }
 
     bool TryDequeue(T &t)
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        return Queue<T>::TryDequeue(t);
+        WriteLock<M> m(this->mutex);
+        return Queue<T, C>::TryDequeue(t);
     }
 
     bool TryPeek(T *&t)
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        return Queue<T>::TryPeek(t);
+        WriteLock<M> m(this->mutex);
+        return Queue<T, C>::TryPeek(t);
     }
 
     bool TryPeek(T &t)
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        return Queue<T>::TryPeek(t);
+        WriteLock<M> m(this->mutex);
+        return Queue<T, C>::TryPeek(t);
     }
 
     template <typename F>
     bool TryDequeue(const F& action)
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        return Queue<T>::TryDequeue(action);
+        WriteLock<M> m(this->mutex);
+        return Queue<T, C>::TryDequeue(action);
     }
 
     template <typename F>
     void WhileTryDequeue(const F& action)
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        Queue<T>::WhileTryDequeue(action);
+        WriteLock<M> m(this->mutex);
+        Queue<T, C>::WhileTryDequeue(action);
     }
 
     void Clear()
     {
-        std::lock_guard<std::mutex> m(this->mutex);
-        return Queue<T>::Clear();
+        WriteLock<M> m(this->mutex);
+        return Queue<T, C>::Clear();
     }
 };
 
+namespace pmr
+{
+    template <typename T>
+    using ConcurrentQueue = Collections::ConcurrentQueue<T, std::pmr::deque<T>>;
+} // namespace pmr
+
+namespace counted
+{
+    template <typename T>
+    using ConcurrentQueue = Collections::ConcurrentQueue<T, std::deque<T, CountingAllocator<T>>>;
+} // namespace counted
+
 } // namespace Collections
 
 #endif // __COLLECIONS_CONCURRENT_QUEUE
@@ -0,0 +1,247 @@
+#ifndef __COLLECTIONS_COUNTER_DICTIONARY
+#define __COLLECTIONS_COUNTER_DICTIONARY
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "Hash.hpp"
+#include "Locks.hpp"
+#include "MemoryUsage.hpp"
+
+namespace Collections
+{
+
+    // Diccionario de contadores (reemplazo de ConcurrentDictionary::Incr para contadores muy calientes)
+    // - cada contador se reparte en celdas, una línea de cache cada una; cada thread suma con un atómico en su propia
+    //   celda, así los threads no se pelean la línea de cache
+    // - Read / Snapshot suman las celdas: ven cada incremento terminado, pero no es una foto atómica entre celdas
+    // - los contadores nunca se borran (Clear los pone en cero), así GetCounter regresa un handle estable: en loops
+    //   calientes guardar el handle y llamar Incr sobre él no toca ningún lock
+    // - Incr(key) guarda en un cache por thread llave -> handle: sólo la primera vez que un thread ve una llave toma el
+    //   lock; después es un find en un mapa local, sin locks ni escrituras compartidas fuera de la celda
+    // M = std::shared_mutex (default: buscar un contador existente sólo toma el lock compartido) | std::mutex | propietario
+    template <typename K, typename V = int64_t, typename M = std::shared_mutex>
+    class CounterDictionary
+    {
+        static_assert(std::is_arithmetic<V>::value, "V must be arithmetic");
+
+    public:
+        class Counter
+        {
+            struct alignas(64) Cell
+            {
+                std::atomic<V> value{0};
+            };
+
+            std::unique_ptr<Cell[]> cells;
+            size_t mask;
+
+            // cada thread se queda con una celda fija (round robin en su primer uso)
+            static inline size_t ThreadCell()
+            {
+                static std::atomic<size_t> next{0};
+                thread_local const size_t cell = next.fetch_add(1, std::memory_order_relaxed);
+                return cell;
+            }
+
+        public:
+            explicit Counter(size_t cells) : cells(new Cell[cells]), mask(cells - 1) {}
+
+            inline void Incr(V value = 1)
+            {
+                this->cells[ThreadCell() & this->mask].value.fetch_add(value, std::memory_order_relaxed);
+            }
+
+            inline V Read() const
+            {
+                V result = 0;
+                for (size_t i = 0; i <= this->mask; ++i)
+                    result += this->cells[i].value.load(std::memory_order_relaxed);
+                return result;
+            }
+
+            inline void Reset()
+            {
+                for (size_t i = 0; i <= this->mask; ++i)
+                    this->cells[i].value.store(0, std::memory_order_relaxed);
+            }
+        };
+
+    private:
+        using LocalCounters = std::unordered_map<K, Counter *, Hash<K>, Equal<K>>;
+
+        // cache de handles de un thread para un diccionario; owner es el id del diccionario dueño de las entradas
+        struct ThreadCache
+        {
+            uint64_t owner = 0;
+            LocalCounters counters;
+        };
+
+        // diccionarios que un thread cachea a la vez (por id) y llaves por diccionario antes de vaciar el cache
+        static constexpr size_t ThreadCacheSlots = 4;
+        static constexpr size_t ThreadCacheCapacity = 1024;
+
+        M mutex;
+        std::unordered_map<K, std::unique_ptr<Counter>, Hash<K>, Equal<K>> counters;
+        size_t cells;
+        // nunca se reusa: un diccionario nuevo en la dirección de uno destruido no ve los handles viejos
+        const uint64_t id = NextId();
+
+        static inline uint64_t NextId()
+        {
+            static std::atomic<uint64_t> next{0};
+            return next.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+
+        inline LocalCounters &LocalCache()
+        {
+            thread_local ThreadCache caches[ThreadCacheSlots];
+            auto &cache = caches[this->id % ThreadCacheSlots];
+            if (cache.owner != this->id)
+            {
+                cache.owner = this->id;
+                cache.counters.clear();
+            }
+            return cache.counters;
+        }
+
+        template <typename Q>
+        inline Counter *Find(const Q &key)
+        {
+            ReadLock<M> m(this->mutex);
+            auto result = this->counters.find(key);
+            return result != this->counters.end() ? result->second.get() : nullptr;
+        }
+
+    public:
+        // una celda por core (redondeado a potencia de 2): con más threads que cores se comparten algunas celdas
+        static size_t DefaultCells()
+        {
+            return std::bit_ceil(std::max(1U, std::thread::hardware_concurrency()));
+        }
+
+        explicit CounterDictionary(size_t cells = DefaultCells()) : cells(std::bit_ceil(std::max<size_t>(cells, 1))) {}
+
+        // el handle vive lo mismo que el diccionario
+        inline Counter &GetCounter(const K &key)
+        {
+            if (auto counter = this->Find(key); counter)
+                return *counter;
+
+            WriteLock<M> m(this->mutex);
+            auto &counter = this->counters[key];
+            if (!counter)
+                counter = std::make_unique<Counter>(this->cells);
+            return *counter;
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<std::unordered_map<K, std::unique_ptr<Counter>, Hash<K>, Equal<K>>, Q> && std::constructible_from<K, const Q &>
+        inline Counter &GetCounter(const Q &key)
+        {
+            if (auto counter = this->Find(key); counter)
+                return *counter;
+            return this->GetCounter(K(key));
+        }
+
+        // sin lock si este thread ya usó la llave (ver cache por thread arriba)
+        template <typename Q>
+        inline void Incr(const Q &key, V value = 1)
+        {
+            if constexpr (std::is_same<std::remove_cvref_t<Q>, K>::value || HeterogeneousKey<LocalCounters, Q>)
+            {
+                auto &cache = this->LocalCache();
+                if (auto found = cache.find(key); found != cache.end())
+                {
+                    found->second->Incr(value);
+                    return;
+                }
+                auto &counter = this->GetCounter(key);
+                if (cache.size() == ThreadCacheCapacity)
+                    cache.clear();
+                cache.emplace(K(key), &counter);
+                counter.Incr(value);
+            }
+            else
+                this->Incr(K(key), value);
+        }
+
+        // 0 si el contador no existe
+        template <typename Q>
+        inline V Read(const Q &key)
+        {
+            auto counter = this->Find(key);
+            return counter ? counter->Read() : 0;
+        }
+
+        template <typename Q>
+        inline bool ContainsKey(const Q &key)
+        {
+            return this->Find(key) != nullptr;
+        }
+
+        inline std::unordered_map<K, V> Snapshot()
+        {
+            ReadLock<M> m(this->mutex);
+            std::unordered_map<K, V> result;
+            result.reserve(this->counters.size());
+            for (auto &[key, counter] : this->counters)
+                result.emplace(key, counter->Read());
+            return result;
+        }
+
+        inline std::vector<K> Keys()
+        {
+            ReadLock<M> m(this->mutex);
+            std::vector<K> result;
+            result.reserve(this->counters.size());
+            for (auto &kvp : this->counters)
+                result.push_back(kvp.first);
+            return result;
+        }
+
+        inline size_t Size()
+        {
+            ReadLock<M> m(this->mutex);
+            return this->counters.size();
+        }
+
+        inline bool Any()
+        {
+            return this->Size() != 0;
+        }
+
+        // ver Dictionary::MemoryUsage; cada contador es un nodo más su Counter y sus celdas (una línea de cache cada una)
+        inline size_t MemoryUsage(bool deep = false)
+        {
+            ReadLock<M> m(this->mutex);
+            size_t result = sizeof(*this) + ContainerMemoryUsage(this->counters) +
+                            this->counters.size() * (AllocationSize(sizeof(Counter)) + AllocationSize(this->cells * 64));
+            if (deep)
+            {
+                for (auto &kvp : this->counters)
+                    result += HeapSizeOf(kvp.first);
+            }
+            return result;
+        }
+
+        // pone todos los contadores en cero; los handles siguen siendo válidos
+        inline void Clear()
+        {
+            ReadLock<M> m(this->mutex);
+            for (auto &kvp : this->counters)
+                kvp.second->Reset();
+        }
+    };
+} // namespace Collections
+
+#endif // __COLLECTIONS_COUNTER_DICTIONARY
@@ -0,0 +1,495 @@
+#ifndef __COLLECTIONS_DENSE_DICTIONARY
+#define __COLLECTIONS_DENSE_DICTIONARY
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "MemoryUsage.hpp"
+
+namespace Collections
+{
+
+    // Diccionario de acceso directo para llaves enteras densas en un rango conocido [min, max]
+    // (ids de instrumentos, ticks de precio): la llave es el índice, sin hash ni un nodo por elemento
+    // - los valores viven en páginas de PageSize llaves que se reservan al primer uso y se liberan al vaciarse,
+    //   así un rango grande con huecos sólo paga las páginas ocupadas (más un apuntador por página)
+    // - un bitmap por página marca las llaves presentes: recorrer salta de presente en presente con countr_zero
+    // - el recorrido (begin/end, ForEach, Keys, Values) sale ordenado por llave, como en SortedDictionary
+    // - misma interfaz que Dictionary; fuera del rango los Try* regresan false, ContainsKey false y
+    //   operator[] / Add / GetOrAdd lanzan std::out_of_range
+    // - el iterador regresa std::pair<const K, V &> por valor (no hay pares guardados): usar auto, const auto & o
+    //   structured bindings en vez de auto &
+    template <typename K, typename V, size_t PageSize = 4096>
+    class DenseDictionary
+    {
+        static_assert(std::is_integral<K>::value, "K must be integral");
+        static_assert(PageSize && PageSize % 64 == 0 && std::has_single_bit(PageSize), "PageSize must be a power of 2 multiple of 64");
+
+        static constexpr size_t Words = PageSize / 64;
+        static constexpr unsigned PageBits = std::countr_zero(PageSize);
+
+        struct Page
+        {
+            std::array<uint64_t, Words> present{};
+            size_t count = 0;
+            alignas(V) unsigned char storage[PageSize * sizeof(V)];
+
+            Page() = default;
+            Page(const Page &) = delete;
+            Page &operator=(const Page &) = delete;
+
+            ~Page()
+            {
+                for (size_t word = 0; word < Words; ++word)
+                {
+                    for (auto bits = this->present[word]; bits; bits &= bits - 1)
+                        this->At(word * 64 + std::countr_zero(bits)).~V();
+                }
+            }
+
+            inline V &At(size_t i)
+            {
+                return *std::launder(reinterpret_cast<V *>(this->storage + i * sizeof(V)));
+            }
+
+            inline bool Has(size_t i) const
+            {
+                return (this->present[i >> 6] >> (i & 63)) & 1;
+            }
+
+            template <typename... Args>
+            inline V &Construct(size_t i, Args &&...args)
+            {
+                auto value = ::new (static_cast<void *>(this->storage + i * sizeof(V))) V(std::forward<Args>(args)...);
+                this->present[i >> 6] |= uint64_t(1) << (i & 63);
+                ++this->count;
+                return *value;
+            }
+
+            inline void Destroy(size_t i)
+            {
+                this->At(i).~V();
+                this->present[i >> 6] &= ~(uint64_t(1) << (i & 63));
+                --this->count;
+            }
+        };
+
+        K min, max;
+        std::vector<std::unique_ptr<Page>> pages;
+        size_t count = 0;
+
+        // posición de la llave relativa a min; false fuera del rango
+        inline bool OffsetOf(K key, size_t &offset) const
+        {
+            if (key < this->min || key > this->max)
+                return false;
+            using U = std::make_unsigned_t<K>;
+            offset = static_cast<size_t>(static_cast<U>(key) - static_cast<U>(this->min));
+            return true;
+        }
+
+        inline size_t CheckedOffset(K key) const
+        {
+            size_t offset;
+            if (!this->OffsetOf(key, offset))
+                throw std::out_of_range("DenseDictionary: key out of range");
+            return offset;
+        }
+
+        inline K KeyOf(size_t offset) const
+        {
+            using U = std::make_unsigned_t<K>;
+            return static_cast<K>(static_cast<U>(this->min) + static_cast<U>(offset));
+        }
+
+        // valor de la llave o nullptr, sin reservar nada
+        inline V *Find(K key) const
+        {
+            size_t offset;
+            if (!this->OffsetOf(key, offset))
+                return nullptr;
+            auto &page = this->pages[offset >> PageBits];
+            if (!page || !page->Has(offset & (PageSize - 1)))
+                return nullptr;
+            return &page->At(offset & (PageSize - 1));
+        }
+
+        template <typename... Args>
+        inline std::pair<V *, bool> Emplace(size_t offset, Args &&...args)
+        {
+            auto &page = this->pages[offset >> PageBits];
+            if (!page)
+                page = std::make_unique<Page>();
+            size_t i = offset & (PageSize - 1);
+            if (page->Has(i))
+                return {&page->At(i), false};
+            auto &value = page->Construct(i, std::forward<Args>(args)...);
+            ++this->count;
+            return {&value, true};
+        }
+
+        inline void Erase(size_t offset)
+        {
+            auto &page = this->pages[offset >> PageBits];
+            page->Destroy(offset & (PageSize - 1));
+            --this->count;
+            if (!page->count)
+                page.reset();
+        }
+
+        // siguiente offset presente a partir de `offset` (inclusive), o Capacity() si ya no hay
+        inline size_t NextPresent(size_t offset) const
+        {
+            const size_t capacity = this->Capacity();
+            while (offset < capacity)
+            {
+                auto &page = this->pages[offset >> PageBits];
+                if (!page)
+                {
+                    offset = ((offset >> PageBits) + 1) << PageBits;
+                    continue;
+                }
+                size_t i = offset & (PageSize - 1), word = i >> 6;
+                uint64_t bits = page->present[word] & (~uint64_t(0) << (i & 63));
+                while (!bits && ++word < Words)
+                    bits = page->present[word];
+                if (bits)
+                    return ((offset >> PageBits) << PageBits) + word * 64 + std::countr_zero(bits);
+                offset = ((offset >> PageBits) + 1) << PageBits;
+            }
+            return capacity;
+        }
+
+        template <bool Const>
+        class Iterator
+        {
+            friend class DenseDictionary;
+            using Owner = std::conditional_t<Const, const DenseDictionary, DenseDictionary>;
+            using Value = std::conditional_t<Const, const V, V>;
+
+            Owner *owner = nullptr;
+            size_t offset = 0;
+
+            Iterator(Owner *owner, size_t offset) : owner(owner), offset(offset) {}
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::pair<const K, Value &>;
+            using reference = std::pair<const K, Value &>;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+
+            inline reference operator*() const
+            {
+                return reference(this->owner->KeyOf(this->offset), this->owner->pages[this->offset >> PageBits]->At(this->offset & (PageSize - 1)));
+            }
+
+            inline Iterator &operator++()
+            {
+                this->offset = this->owner->NextPresent(this->offset + 1);
+                return *this;
+            }
+
+            inline Iterator operator++(int)
+            {
+                auto result = *this;
+                ++*this;
+                return result;
+            }
+
+            friend inline bool operator==(const Iterator &a, const Iterator &b)
+            {
+                return a.offset == b.offset;
+            }
+        };
+
+    public:
+        using key_type = K;
+        using mapped_type = V;
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        // rango inclusivo de llaves permitidas
+        DenseDictionary(K min, K max) : min(min), max(max)
+        {
+            if (max < min)
+                throw std::invalid_argument("DenseDictionary: max < min");
+            this->pages.resize((this->CheckedOffset(max) >> PageBits) + 1);
+        }
+
+        DenseDictionary(const DenseDictionary &o) : DenseDictionary(o.min, o.max)
+        {
+            o.ForEach([this](const auto &kvp)
+                      { this->TryAdd(kvp.first, kvp.second); });
+        }
+
+        DenseDictionary &operator=(const DenseDictionary &o)
+        {
+            if (this != &o)
+            {
+                DenseDictionary copy(o);
+                *this = std::move(copy);
+            }
+            return *this;
+        }
+
+        // el origen queda vacío pero con su rango, como después de Clear()
+        DenseDictionary(DenseDictionary &&o) : min(o.min), max(o.max), pages(std::move(o.pages)), count(o.count)
+        {
+            o.pages.clear();
+            o.pages.resize(this->pages.size());
+            o.count = 0;
+        }
+
+        DenseDictionary &operator=(DenseDictionary &&o)
+        {
+            if (this != &o)
+            {
+                this->min = o.min;
+                this->max = o.max;
+                this->pages = std::move(o.pages);
+                this->count = o.count;
+                o.pages.clear();
+                o.pages.resize(this->pages.size());
+                o.count = 0;
+            }
+            return *this;
+        }
+
+        inline K MinKey() const
+        {
+            return this->min;
+        }
+
+        inline K MaxKey() const
+        {
+            return this->max;
+        }
+
+        // llaves que caben en el rango (no las presentes, ver Size)
+        inline size_t Capacity() const
+        {
+            return this->pages.size() << PageBits;
+        }
+
+        inline iterator begin()
+        {
+            return iterator(this, this->NextPresent(0));
+        }
+
+        inline iterator end()
+        {
+            return iterator(this, this->Capacity());
+        }
+
+        inline const_iterator begin() const
+        {
+            return const_iterator(this, this->NextPresent(0));
+        }
+
+        inline const_iterator end() const
+        {
+            return const_iterator(this, this->Capacity());
+        }
+
+        // el operador[] insertará el valor por default; lanza std::out_of_range fuera del rango
+        inline V &operator[](K key)
+        {
+            return *this->Emplace(this->CheckedOffset(key)).first;
+        }
+
+        inline size_t Size() const
+        {
+            return this->count;
+        }
+
+        inline bool Any() const
+        {
+            return this->count != 0;
+        }
+
+        // ver Dictionary::MemoryUsage; recorre el arreglo de páginas (O(rango / PageSize)), no las llaves
+        inline size_t MemoryUsage(bool deep = false) const
+        {
+            size_t result = sizeof(*this) + ContainerMemoryUsage(this->pages);
+            for (auto &page : this->pages)
+                result += page ? AllocationSize(sizeof(Page)) : 0;
+            if (deep)
+            {
+                for (auto [key, value] : *this)
+                    result += HeapSizeOf(value);
+            }
+            return result;
+        }
+
+        inline void Clear()
+        {
+            for (auto &page : this->pages)
+                page.reset();
+            this->count = 0;
+        }
+
+        inline bool ContainsKey(K key) const
+        {
+            return this->Find(key) != nullptr;
+        }
+
+        inline bool TryGetValue(K key, V &value) const
+        {
+            if (auto found = this->Find(key))
+            {
+                value = *found;
+                return true;
+            }
+            return false;
+        }
+
+        inline bool TryGetValue(K key, V *&value)
+        {
+            value = this->Find(key);
+            return value != nullptr;
+        }
+
+        template <typename F>
+        inline bool TryGetValueExec(K key, const F &action)
+        {
+            if (auto found = this->Find(key))
+            {
+                action(*found);
+                return true;
+            }
+            return false;
+        }
+
+        inline bool TryAdd(K key, const V &value)
+        {
+            size_t offset;
+            return this->OffsetOf(key, offset) && this->Emplace(offset, value).second;
+        }
+
+        inline bool TryAdd(K key, V &&value)
+        {
+            size_t offset;
+            return this->OffsetOf(key, offset) && this->Emplace(offset, std::move(value)).second;
+        }
+
+        // construye el valor en su lugar con args, sólo si la llave no existe
+        template <typename... Args>
+        inline bool TryEmplace(K key, Args &&...args)
+        {
+            size_t offset;
+            return this->OffsetOf(key, offset) && this->Emplace(offset, std::forward<Args>(args)...).second;
+        }
+
+        // inserta o reemplaza; true si la llave es nueva
+        inline bool Add(K key, const V &value)
+        {
+            auto [found, added] = this->Emplace(this->CheckedOffset(key), value);
+            if (!added)
+                *found = value;
+            return added;
+        }
+
+        inline bool Add(K key, V &&value)
+        {
+            auto [found, added] = this->Emplace(this->CheckedOffset(key), std::move(value));
+            if (!added)
+                *found = std::move(value);
+            return added;
+        }
+
+        template <typename F>
+        inline V &GetOrAdd(K key, const F &add)
+        {
+            auto offset = this->CheckedOffset(key);
+            if (auto found = this->Find(key))
+                return *found;
+            return *this->Emplace(offset, add()).first;
+        }
+
+        inline void AddOrUpdate(K key, const std::function<V()> &add, const std::function<void(V &)> &update)
+        {
+            if (auto found = this->Find(key))
+                update(*found);
+            else
+                this->Emplace(this->CheckedOffset(key), add());
+        }
+
+        inline bool TryRemove(K key)
+        {
+            if (!this->Find(key))
+                return false;
+            this->Erase(this->CheckedOffset(key));
+            return true;
+        }
+
+        inline bool TryRemove(K key, V &value)
+        {
+            if (auto found = this->Find(key))
+            {
+                value = std::move(*found);
+                this->Erase(this->CheckedOffset(key));
+                return true;
+            }
+            return false;
+        }
+
+        // la llave presente más chica; el diccionario no debe estar vacío
+        inline K FirstKey() const
+        {
+            return this->KeyOf(this->NextPresent(0));
+        }
+
+        // action(kvp) en orden de llave; kvp es un std::pair<const K, V &> (ver Iterator)
+        template <typename F>
+        void ForEach(const F &action)
+        {
+            for (auto kvp = this->begin(); kvp != this->end(); ++kvp)
+            {
+                auto pair = *kvp;
+                action(pair);
+            }
+        }
+
+        template <typename F>
+        void ForEach(const F &action) const
+        {
+            for (auto kvp = this->begin(); kvp != this->end(); ++kvp)
+            {
+                auto pair = *kvp;
+                action(pair);
+            }
+        }
+
+        // ordenadas
+        inline std::vector<K> Keys() const
+        {
+            std::vector<K> result;
+            result.reserve(this->count);
+            for (auto kvp = this->begin(); kvp != this->end(); ++kvp)
+                result.push_back((*kvp).first);
+            return result;
+        }
+
+        inline std::vector<V> Values() const
+        {
+            std::vector<V> result;
+            result.reserve(this->count);
+            for (auto kvp = this->begin(); kvp != this->end(); ++kvp)
+                result.push_back((*kvp).second);
+            return result;
+        }
+    };
+} // namespace Collections
+
+#endif // __COLLECTIONS_DENSE_DICTIONARY
@@ -1,23 +1,106 @@
 #ifndef __COLLECTIONS_DICTIONARY
 #define __COLLECTIONS_DICTIONARY
 
+#include <algorithm>
+#include <cassert>
 #include <chrono>
 #include <functional>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <span>
 #include <vector>
 #include <utility>
 #include <unordered_map>
 
+#include "FrozenHashTable.hpp"
+#include "Hash.hpp"
+#include "MemoryUsage.hpp"
+#include "Parallel.hpp"
+
 namespace Collections
 {
 
-    template <typename K, typename V>
-    class Dictionary : protected std::unordered_map<K, V>
+    // B = std::unordered_map<K, V> (nodos) | FlatHashMap<K, V> (plano, swiss-table) | std::pmr::unordered_map (ver Collections::pmr)
+    //     | cualquier mapa con la interfaz de std::unordered_map
+    // con el Hash/Equal default las llaves std::string aceptan búsquedas con std::string_view y const char* sin construir la llave
+    template <typename K, typename V, typename B = std::unordered_map<K, V, Hash<K>, Equal<K>>>
+    class Dictionary : protected B
     {
+        // llaves que se piden antes de resolver la primera: suficientes para traslapar los misses sin que las
+        // primeras líneas pedidas se desalojen antes de usarlas
+        static constexpr size_t PrefetchWindow = 16;
+
+        // found(i, V* o nullptr) por cada keys[i], en orden, resolviendo por ventanas en dos fases:
+        // - backend plano (FlatHashMap): hash + prefetch del grupo de cada llave, después find con el hash ya calculado
+        // - backend con cubetas (std::unordered_map), en tres pasadas para que los misses de una llave no esperen a los de
+        //   la anterior: el índice de cubeta de todas (sólo hash), begin(n) de todas (lee el slot de la cubeta y el nodo
+        //   anterior a su cabeza; la interfaz estándar no deja hacer prefetch del arreglo de cubetas, así que esos misses
+        //   sólo se traslapan entre sí) con prefetch de cada cabeza, y al final se recorre cada cubeta
+        // - cualquier otro: find una por una
+        template <typename F>
+        inline void FindMany(std::span<const K> keys, const F &found)
+        {
+            for (size_t base = 0; base < keys.size(); base += PrefetchWindow)
+            {
+                const size_t count = std::min(PrefetchWindow, keys.size() - base);
+                if constexpr (requires(B &b, const K &key, size_t h) { b.prefetch(b.hash_of(key)); b.find(key, h); })
+                {
+                    size_t hashes[PrefetchWindow];
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        hashes[i] = B::hash_of(keys[base + i]);
+                        B::prefetch(hashes[i]);
+                    }
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        auto kvp = B::find(keys[base + i], hashes[i]);
+                        found(base + i, kvp != B::end() ? &kvp->second : nullptr);
+                    }
+                }
+                else if constexpr (requires(B &b, const K &key, size_t n) { b.bucket(key); b.begin(n); b.end(n); b.key_eq(); })
+                {
+                    size_t buckets[PrefetchWindow];
+                    typename B::local_iterator heads[PrefetchWindow];
+                    for (size_t i = 0; i < count; ++i)
+                        buckets[i] = B::bucket(keys[base + i]);
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        heads[i] = B::begin(buckets[i]);
+                        if (heads[i] != B::end(buckets[i]))
+                            Prefetch(&*heads[i]);
+                    }
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        V *value = nullptr;
+                        for (auto kvp = heads[i]; kvp != B::end(buckets[i]); ++kvp)
+                        {
+                            if (B::key_eq()(kvp->first, keys[base + i]))
+                            {
+                                value = &kvp->second;
+                                break;
+                            }
+                        }
+                        found(base + i, value);
+                    }
+                }
+                else
+                {
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        auto kvp = B::find(keys[base + i]);
+                        found(base + i, kvp != B::end() ? &kvp->second : nullptr);
+                    }
+                }
+            }
+        }
+
     public:
         Dictionary() = default;
-        Dictionary(const std::unordered_map<K, V> &o) : std::unordered_map<K, V>(o){};
+        Dictionary(const std::unordered_map<K, V> &o) : B(o.begin(), o.end()){};
+        explicit Dictionary(const typename B::allocator_type &allocator) : B(allocator) {}
 
-        void From(const Dictionary<K, V> &src)
+        void From(const Dictionary<K, V, B> &src)
         {            
             *this = src;
         }
@@ -25,38 +108,40 @@ namespace Collections
         // el operador[] insertará el valor por default en primitivas en donde exista default, de lo contrario, usar GetOrAdd
         inline V &operator[](const K &key)
         {
-            return std::unordered_map<K, V>::operator[](key);
+            return B::operator[](key);
         }
 
         // el operador[] insertará el valor por default en primitivas en donde exista default, de lo contrario, usar GetOrAdd
         const inline V &operator[](const K &key) const
         {
-            return const_cast<Collections::Dictionary<K, V>*>(this)->operator[](key);
+            return const_cast<Collections::Dictionary<K, V, B>*>(this)->operator[](key);
         }
 
-        typename Dictionary<K, V>::iterator begin()
+        typename Dictionary<K, V, B>::iterator begin()
         {
-            return std::unordered_map<K, V>::begin();
+            return B::begin();
         }
 
-        typename Dictionary<K, V>::iterator end()
+        typename Dictionary<K, V, B>::iterator end()
         {
-            return std::unordered_map<K, V>::end();
+            return B::end();
         }
 
-        typename Dictionary<K, V>::const_iterator begin() const
+        typename Dictionary<K, V, B>::const_iterator begin() const
         {
-            return std::unordered_map<K, V>::begin();
+            return B::begin();
         }
 
-        typename Dictionary<K, V>::const_iterator end() const
+        typename Dictionary<K, V, B>::const_iterator end() const
         {
-            return std::unordered_map<K, V>::end();
+            return B::end();
         }
 
+        // copias: para recorrer una sola vez usar KeysView / ValuesView / Where, que no reservan memoria
         inline std::vector<K> Keys()
         {
             std::vector<K> result;
+            result.reserve(B::size());
             for (auto kvp = this->begin(); kvp != this->end(); ++kvp)
                 result.push_back(kvp->first);
             return result;
@@ -77,37 +162,110 @@ namespace Collections
         inline std::vector<V> Values()
         {
             std::vector<V> result;
+            result.reserve(B::size());
             for (auto kvp = this->begin(); kvp != this->end(); ++kvp)
                 result.push_back(kvp->second);
             return result;
         }
 
+        // vistas perezosas (std::ranges) sobre el mapa: no copian ni reservan nada y se pueden componer,
+        // p.ej. dict.Where(pred) | std::views::keys | std::views::take(10)
+        // ojo : son válidas mientras el diccionario viva y no se modifique (igual que sus iteradores)
+        inline auto KeysView() const
+        {
+            return static_cast<const B &>(*this) | std::views::keys;
+        }
+
+        inline auto ValuesView()
+        {
+            return static_cast<B &>(*this) | std::views::values;
+        }
+
+        inline auto ValuesView() const
+        {
+            return static_cast<const B &>(*this) | std::views::values;
+        }
+
+        // pares (llave, valor) que cumplen condition(kvp)
+        template <typename F>
+        inline auto Where(F condition)
+        {
+            return static_cast<B &>(*this) | std::views::filter(std::move(condition));
+        }
+
+        // selector(kvp) por cada par
+        template <typename F>
+        inline auto Select(F selector)
+        {
+            return static_cast<B &>(*this) | std::views::transform(std::move(selector));
+        }
+
+        // los primeros n pares en el orden de recorrido del mapa
+        inline auto Take(size_t n)
+        {
+            return static_cast<B &>(*this) | std::views::take(static_cast<std::ranges::range_difference_t<B>>(n));
+        }
+
         inline bool Any()
         {
-            return !std::unordered_map<K, V>::empty() ;
+            return !B::empty() ;
         }
 
         inline size_t Size()
         {
-            return std::unordered_map<K, V>::size();
+            return B::size();
+        }
+
+        // bytes del diccionario: O(1), exacto con Collections::counted::Dictionary y estimado con cualquier otro backend
+        // deep = true suma lo que cuelga de llaves y valores (strings, apuntadores de GetOrAddNew, ver HeapSize): O(n)
+        inline size_t MemoryUsage(bool deep = false) const
+        {
+            const B &backend = *this;
+            return sizeof(*this) + ContainerMemoryUsage(backend) + (deep ? ElementsHeapSize(backend) : 0);
         }
 
         inline void Clear()
         {
-            return std::unordered_map<K, V>::clear();
+            return B::clear();
         }
 
         inline bool TryRemove(const K &key)
         {
-            return std::unordered_map<K, V>::erase(key);
+            return B::erase(key);
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q>
+        inline bool TryRemove(const Q &key)
+        {
+            if (auto result = B::find(key); result != B::end())
+            {
+                B::erase(result);
+                return true;
+            }
+            return false;
         }
 
+        // el valor se mueve hacia afuera (sin copia) antes de borrar el registro
         inline bool TryRemove(const K &key, V &value)
         {            
-            if (auto result = std::unordered_map<K, V>::find(key); result != std::unordered_map<K, V>::end())
+            if (auto result = B::find(key); result != B::end())
             {
-                value = result->second;
-                std::unordered_map<K, V>::erase(key);
+                value = std::move(result->second);
+                B::erase(result);
+                return true;
+            }
+            return false;
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q>
+        inline bool TryRemove(const Q &key, V &value)
+        {
+            if (auto result = B::find(key); result != B::end())
+            {
+                value = std::move(result->second);
+                B::erase(result);
                 return true;
             }
             return false;
@@ -115,10 +273,10 @@ namespace Collections
 
         inline bool TryRemove(const K &key, V *&value)
         {            
-            if (auto result = std::unordered_map<K, V>::find(key); result != std::unordered_map<K, V>::end())
+            if (auto result = B::find(key); result != B::end())
             {
                 value = &result->second;
-                std::unordered_map<K, V>::erase(key);
+                B::erase(key);
                 return true;
             }
             return false;
@@ -127,9 +285,9 @@ namespace Collections
         // regresa true cuando encontró la llave Y se dá la condición de borrado
         inline bool TryRemoveIf(const K &key, const std::function<bool(V &)> &cond)
         {            
-            if (auto result = std::unordered_map<K, V>::find(key); result != std::unordered_map<K, V>::end() && cond(result->second))
+            if (auto result = B::find(key); result != B::end() && cond(result->second))
             {
-                std::unordered_map<K, V>::erase(key);
+                B::erase(key);
                 return true;
             }
             return false;
@@ -138,11 +296,11 @@ namespace Collections
         // similar a TryRemoveIf + Contains : regresa true si contiene la llave (después)
         inline bool TryRemoveWhen(const K &key, const std::function<bool(V &)> &cond)
         {            
-            if (auto result = std::unordered_map<K, V>::find(key); result != std::unordered_map<K, V>::end())
+            if (auto result = B::find(key); result != B::end())
             {
                 if (cond(result->second))
                 {
-                    std::unordered_map<K, V>::erase(key);
+                    B::erase(key);
                 }
                 else
                 {
@@ -165,12 +323,31 @@ namespace Collections
 
         inline bool ContainsKey(const K &key)
         {
-            return std::unordered_map<K, V>::find(key) != std::unordered_map<K, V>::end();
+            return B::find(key) != B::end();
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q>
+        inline bool ContainsKey(const Q &key)
+        {
+            return B::find(key) != B::end();
         }
 
         inline bool TryGetValue(const K &key, V &value) 
         {            
-            if (auto result = std::unordered_map<K, V>::find(key); result != std::unordered_map<K, V>::end())
+            if (auto result = B::find(key); result != B::end())
+            {
+                value = result->second;
+                return true;
+            }
+            return false;
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q>
+        inline bool TryGetValue(const Q &key, V &value)
+        {
+            if (auto result = B::find(key); result != B::end())
             {
                 value = result->second;
                 return true;
@@ -181,7 +358,7 @@ namespace Collections
         // regresa true si tiene la llave & se dá la condincionante del valor obtenido en dicha llave
         inline bool TryCheckValue(const K &key, const std::function<bool(V &)> &cond)
         {            
-            if (auto result = std::unordered_map<K, V>::find(key); result != std::unordered_map<K, V>::end())
+            if (auto result = B::find(key); result != B::end())
             {
                 return cond(result->second);
             }
@@ -192,7 +369,19 @@ namespace Collections
         // https://stackoverflow.com/questions/5286453/how-to-return-a-pointer-as-a-function-parameter
         inline bool TryGetValue(const K &key, V *&value)
         {            
-            if (auto result = std::unordered_map<K, V>::find(key); result != std::unordered_map<K, V>::end())
+            if (auto result = B::find(key); result != B::end())
+            {
+                value = &result->second;
+                return true;
+            }
+            return false;
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q>
+        inline bool TryGetValue(const Q &key, V *&value)
+        {
+            if (auto result = B::find(key); result != B::end())
             {
                 value = &result->second;
                 return true;
@@ -213,7 +402,39 @@ namespace Collections
 
         inline bool TryAdd(const K &key, const V &value)
         {
-            return std::unordered_map<K, V>::try_emplace(key, value).second;
+            return B::try_emplace(key, value).second;
+        }
+
+        // si la llave ya existe value no se toca (no se mueve)
+        inline bool TryAdd(const K &key, V &&value)
+        {
+            return B::try_emplace(key, std::move(value)).second;
+        }
+
+        inline bool TryAdd(K &&key, V &&value)
+        {
+            return B::try_emplace(std::move(key), std::move(value)).second;
+        }
+
+        // construye el valor en su lugar con args, sólo si la llave no existe
+        template <typename... Args>
+        inline bool TryEmplace(const K &key, Args &&...args)
+        {
+            return B::try_emplace(key, std::forward<Args>(args)...).second;
+        }
+
+        template <typename... Args>
+        inline bool TryEmplace(K &&key, Args &&...args)
+        {
+            return B::try_emplace(std::move(key), std::forward<Args>(args)...).second;
+        }
+
+        // la llave sólo se construye cuando de verdad es nueva
+        template <typename Q, typename U>
+            requires HeterogeneousKey<B, Q> && std::constructible_from<K, const Q &> && std::constructible_from<V, U &&>
+        inline bool TryAdd(const Q &key, U &&value)
+        {
+            return B::find(key) == B::end() && B::try_emplace(K(key), std::forward<U>(value)).second;
         }
 
         inline bool TryAdd(const K &key, const std::function<V()> &function)
@@ -228,18 +449,39 @@ namespace Collections
 
         inline bool Add(const K &key, const V &value)
         {
-            return std::unordered_map<K, V>::insert_or_assign(key, value).second;
+            return B::insert_or_assign(key, value).second;
+        }
+
+        inline bool Add(const K &key, V &&value)
+        {
+            return B::insert_or_assign(key, std::move(value)).second;
+        }
+
+        inline bool Add(K &&key, V &&value)
+        {
+            return B::insert_or_assign(std::move(key), std::move(value)).second;
         }
         
         inline V &GetOrAdd(const K &key, const std::function<V()> &add)
         {            
-            if (auto result = std::unordered_map<K, V>::find(key); result != std::unordered_map<K, V>::end())
+            if (auto result = B::find(key); result != B::end())
             {
                 return result->second;
             }
-            
-            return this->operator[](key) = add();
-            
+
+            return B::try_emplace(key, add()).first->second;
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q> && std::constructible_from<K, const Q &>
+        inline V &GetOrAdd(const Q &key, const std::function<V()> &add)
+        {
+            if (auto result = B::find(key); result != B::end())
+            {
+                return result->second;
+            }
+
+            return B::try_emplace(K(key), add()).first->second;
         }
 
         inline V &GetOrAdd(const K &key)
@@ -249,7 +491,7 @@ namespace Collections
 
         inline V &GetOrAddNew(const K &key)
         {            
-            if (auto result = std::unordered_map<K, V>::find(key); result != std::unordered_map<K, V>::end())
+            if (auto result = B::find(key); result != B::end())
             {
                 return result->second;
             }
@@ -260,7 +502,7 @@ namespace Collections
         
         inline V &GetOrAddOrNull(const K &key, const std::function<V()> &add)
         {            
-            if (auto result = std::unordered_map<K, V>::find(key); result != std::unordered_map<K, V>::end() && result->second)
+            if (auto result = B::find(key); result != B::end() && result->second)
             {
                 return result->second;
             }
@@ -271,9 +513,9 @@ namespace Collections
         
         inline void AddOrUpdate(const K &key, const std::function<V()> &add, const std::function<void(V&)> &update)
         {            
-            if (auto result = std::unordered_map<K, V>::find(key); result == std::unordered_map<K, V>::end())
+            if (auto result = B::find(key); result == B::end())
             {                
-                std::unordered_map<K, V>::emplace(key, add());
+                B::emplace(key, add());
             }
             else
             {
@@ -281,6 +523,92 @@ namespace Collections
             }
         }
 
+        // deja lugar para n llaves sin rehash; con el backend default sí reubica todo de golpe, hacerlo en el arranque
+        inline void Reserve(size_t n)
+        {
+            B::reserve(n);
+        }
+
+        inline void SetMaxLoadFactor(float max_load_factor)
+        {
+            B::max_load_factor(max_load_factor);
+        }
+
+        // regresa la memoria de cubetas sobrantes (p.ej. después de borrar la mayoría de las llaves)
+        inline void ShrinkToFit()
+        {
+            B::rehash(0);
+        }
+
+        // lotes [first, last) de pares llave/valor (con std::make_move_iterator se mueven); el resultado de cada elemento
+        // regresa en el mismo orden. Con iteradores forward se reserva una sola vez para todo el lote
+        template <typename I>
+        inline std::vector<bool> TryAddRange(I first, I last)
+        {
+            std::vector<bool> result;
+            this->ReserveBatch(first, last, result, true);
+            for (; first != last; ++first)
+            {
+                auto &&kvp = *first;
+                result.push_back(B::try_emplace(std::forward<decltype(kvp)>(kvp).first, std::forward<decltype(kvp)>(kvp).second).second);
+            }
+            return result;
+        }
+
+        // true si la llave es nueva, false si se actualizó
+        template <typename I>
+        inline std::vector<bool> AddRange(I first, I last)
+        {
+            std::vector<bool> result;
+            this->ReserveBatch(first, last, result, true);
+            for (; first != last; ++first)
+            {
+                auto &&kvp = *first;
+                result.push_back(B::insert_or_assign(std::forward<decltype(kvp)>(kvp).first, std::forward<decltype(kvp)>(kvp).second).second);
+            }
+            return result;
+        }
+
+        // [first, last) de llaves; true si existía y se borró
+        template <typename I>
+        inline std::vector<bool> RemoveRange(I first, I last)
+        {
+            std::vector<bool> result;
+            this->ReserveBatch(first, last, result, false);
+            for (; first != last; ++first)
+                result.push_back(B::erase(*first) > 0);
+            return result;
+        }
+
+        // values[i] recibe una copia del valor de keys[i]; si la llave no existe values[i] no se toca
+        inline std::vector<bool> TryGetMany(std::span<const K> keys, std::span<V> values)
+        {
+            assert(values.size() >= keys.size());
+            std::vector<bool> result(keys.size());
+            this->FindMany(keys, [&](size_t i, V *value)
+                           {
+                if (value)
+                {
+                    values[i] = *value;
+                    result[i] = true;
+                } });
+            return result;
+        }
+
+        // values[i] apunta al valor de keys[i] o es nullptr; regresa cuántas llaves se encontraron
+        // las llaves se resuelven por ventanas con prefetch (ver FindMany): para canastas de 64-256 llaves los misses
+        // de caché se traslapan en vez de pagarse uno por uno como en un ciclo de TryGetValue
+        inline size_t TryGetMany(std::span<const K> keys, std::span<V *> values)
+        {
+            assert(values.size() >= keys.size());
+            size_t found_count = 0;
+            this->FindMany(keys, [&](size_t i, V *value)
+                           {
+                values[i] = value;
+                found_count += value != nullptr; });
+            return found_count;
+        }
+
         template <typename F>
         void Transform(const F &action)
         {
@@ -293,13 +621,114 @@ namespace Collections
             std::for_each(this->begin(), this->end(), action);
         }
 
+        // versiones paralelas: el recorrido se reparte entre `workers` threads (0 = uno por core), ver ParallelVisit
+        // action se llama al mismo tiempo desde varios threads, cada elemento una sola vez
+        template <typename F>
+        void ParallelForEach(const F &action, size_t workers = 0)
+        {
+            ParallelVisit(static_cast<B &>(*this), workers, [&action](auto &kvp, size_t)
+                          { action(kvp); });
+        }
+
+        // kvp.second = action(kvp.first, kvp.second) para cada elemento
+        template <typename F>
+        void ParallelTransform(const F &action, size_t workers = 0)
+        {
+            ParallelVisit(static_cast<B &>(*this), workers, [&action](auto &kvp, size_t)
+                          { kvp.second = action(kvp.first, static_cast<const V &>(kvp.second)); });
+        }
+
+        // como Keys(condition), sin orden definido
+        template <typename F>
+        std::vector<K> ParallelKeys(const F &condition, size_t workers = 0)
+        {
+            std::vector<std::vector<K>> partial(ParallelWorkers(workers));
+            ParallelVisit(static_cast<B &>(*this), workers, [&](auto &kvp, size_t worker)
+                          {
+                if (condition(kvp.first))
+                    partial[worker].push_back(kvp.first); });
+
+            std::vector<K> result;
+            for (auto &keys : partial)
+                result.insert(result.end(), keys.begin(), keys.end());
+            return result;
+        }
+
+        // combine(init, map(kvp) ...) en paralelo: combine debe ser asociativa (el orden de combinación no está definido)
+        template <typename T, typename Map, typename Combine>
+        T Reduce(T init, const Map &map, const Combine &combine, size_t workers = 0)
+        {
+            std::vector<std::optional<T>> partial(ParallelWorkers(workers));
+            ParallelVisit(static_cast<B &>(*this), workers, [&](auto &kvp, size_t worker)
+                          {
+                auto &local = partial[worker];
+                if (local)
+                    local = combine(std::move(*local), map(static_cast<const typename B::value_type &>(kvp)));
+                else
+                    local.emplace(map(static_cast<const typename B::value_type &>(kvp))); });
+
+            for (auto &local : partial)
+            {
+                if (local)
+                    init = combine(std::move(init), std::move(*local));
+            }
+            return init;
+        }
+
+        // copia de sólo lectura con hash perfecto mínimo, para datos que se cargan una vez y después sólo se leen
+        // (ver FrozenHashTable): búsquedas de un solo slot y sin lock desde cualquier thread
+        inline FrozenDictionary<K, V, typename B::hasher, typename B::key_equal> Freeze() const
+        {
+            return FrozenDictionary<K, V, typename B::hasher, typename B::key_equal>(this->begin(), this->end());
+        }
+
+        // snapshot en disco con el layout de Freeze() (ver MappedSnapshot.hpp); K y V trivialmente copiables
+        inline void SaveSnapshot(const std::string &path) const
+        {
+            this->Freeze().SaveSnapshot(path);
+        }
+
+        // no copia nada: las búsquedas van directo al archivo mapeado, que se sube a memoria conforme se toca
+        static FrozenDictionary<K, V, typename B::hasher, typename B::key_equal> MapSnapshot(const std::string &path, bool verify = false)
+        {
+            return FrozenDictionary<K, V, typename B::hasher, typename B::key_equal>::MapSnapshot(path, verify);
+        }
+
         void FromMap(const std::unordered_map<K, V> &map)
         {
             this->Clear();
             for (const auto &[k, v] : map)
                 this->operator[](k) = v;
         }
+
+    private:
+        template <typename I>
+        inline void ReserveBatch(I first, I last, std::vector<bool> &result, bool inserts)
+        {
+            if constexpr (std::forward_iterator<I>)
+            {
+                auto n = static_cast<size_t>(std::ranges::distance(first, last));
+                result.reserve(n);
+                // reserve() de std::unordered_map puede encoger la tabla: sólo se llama si de verdad hay que crecer
+                if (inserts && B::size() + n > B::bucket_count() * B::max_load_factor())
+                    B::reserve(B::size() + n);
+            }
+        }
     };
+
+    // con std::pmr::polymorphic_allocator: Dictionary<K, V>(std::pmr::memory_resource *) usa la arena o pool que se le pase
+    namespace pmr
+    {
+        template <typename K, typename V>
+        using Dictionary = Collections::Dictionary<K, V, std::pmr::unordered_map<K, V, Hash<K>, Equal<K>>>;
+    } // namespace pmr
+
+    // con CountingAllocator: MemoryUsage() exacto
+    namespace counted
+    {
+        template <typename K, typename V>
+        using Dictionary = Collections::Dictionary<K, V, std::unordered_map<K, V, Hash<K>, Equal<K>, CountingAllocator<std::pair<const K, V>>>>;
+    } // namespace counted
 } // namespace Collections
 
 #endif // __COLLECTIONS_DICTIONARY
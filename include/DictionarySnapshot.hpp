@@ -0,0 +1,198 @@
+#ifndef __COLLECTIONS_DICTIONARY_SNAPSHOT
+#define __COLLECTIONS_DICTIONARY_SNAPSHOT
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "Hash.hpp"
+
+namespace Collections
+{
+    // Foto de sólo lectura de un diccionario concurrente (ver ConcurrentDictionary::Snapshot y ShardedConcurrentDictionary::Snapshot)
+    // - se recorre y se consulta sin locks: los escritores del diccionario original ya no la ven
+    // - parts es una copia del backend por shard (1 para ConcurrentDictionary); las llaves se reparten igual que en los shards
+    // - copiar la foto es barato (comparte las partes)
+    template <typename K, typename V, typename B>
+    class DictionarySnapshot
+    {
+        std::vector<std::shared_ptr<const B>> parts;
+
+        template <typename Q>
+        inline const B &PartOf(const Q &key) const
+        {
+            return *this->parts[ShardIndex(typename B::hasher{}(key), this->parts.size())];
+        }
+
+    public:
+        // recorre parte por parte
+        class const_iterator
+        {
+            const DictionarySnapshot *snapshot = nullptr;
+            size_t part = 0;
+            typename B::const_iterator current;
+
+            inline void SkipEmpty()
+            {
+                while (this->part < this->snapshot->parts.size() && this->current == this->snapshot->parts[this->part]->end())
+                {
+                    if (++this->part < this->snapshot->parts.size())
+                        this->current = this->snapshot->parts[this->part]->begin();
+                }
+            }
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = typename B::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const value_type *;
+            using reference = const value_type &;
+
+            const_iterator() = default;
+            const_iterator(const DictionarySnapshot *snapshot, size_t part) : snapshot(snapshot), part(part)
+            {
+                if (this->part < this->snapshot->parts.size())
+                {
+                    this->current = this->snapshot->parts[this->part]->begin();
+                    this->SkipEmpty();
+                }
+            }
+
+            inline reference operator*() const
+            {
+                return *this->current;
+            }
+
+            inline pointer operator->() const
+            {
+                return &*this->current;
+            }
+
+            inline const_iterator &operator++()
+            {
+                ++this->current;
+                this->SkipEmpty();
+                return *this;
+            }
+
+            inline const_iterator operator++(int)
+            {
+                auto result = *this;
+                ++*this;
+                return result;
+            }
+
+            inline bool operator==(const const_iterator &o) const
+            {
+                return this->part == o.part && (this->part == this->snapshot->parts.size() || this->current == o.current);
+            }
+        };
+
+        DictionarySnapshot() : parts{std::make_shared<const B>()} {}
+
+        // parts.size() debe ser potencia de 2 (igual que los shards)
+        explicit DictionarySnapshot(std::vector<std::shared_ptr<const B>> parts) : parts(std::move(parts)) {}
+
+        const_iterator begin() const
+        {
+            return const_iterator(this, 0);
+        }
+
+        const_iterator end() const
+        {
+            return const_iterator(this, this->parts.size());
+        }
+
+        inline size_t Size() const
+        {
+            size_t result = 0;
+            for (auto &part : this->parts)
+                result += part->size();
+            return result;
+        }
+
+        inline bool Any() const
+        {
+            return std::any_of(this->parts.begin(), this->parts.end(), [](auto &part)
+                               { return !part->empty(); });
+        }
+
+        inline bool ContainsKey(const K &key) const
+        {
+            auto &part = this->PartOf(key);
+            return part.find(key) != part.end();
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q>
+        inline bool ContainsKey(const Q &key) const
+        {
+            auto &part = this->PartOf(key);
+            return part.find(key) != part.end();
+        }
+
+        inline bool TryGetValue(const K &key, V &value) const
+        {
+            auto &part = this->PartOf(key);
+            if (auto result = part.find(key); result != part.end())
+            {
+                value = result->second;
+                return true;
+            }
+            return false;
+        }
+
+        // el apuntador vive lo mismo que la foto
+        inline bool TryGetValue(const K &key, const V *&value) const
+        {
+            auto &part = this->PartOf(key);
+            if (auto result = part.find(key); result != part.end())
+            {
+                value = &result->second;
+                return true;
+            }
+            return false;
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q>
+        inline bool TryGetValue(const Q &key, V &value) const
+        {
+            auto &part = this->PartOf(key);
+            if (auto result = part.find(key); result != part.end())
+            {
+                value = result->second;
+                return true;
+            }
+            return false;
+        }
+
+        inline std::vector<K> Keys() const
+        {
+            std::vector<K> result;
+            result.reserve(this->Size());
+            for (auto &kvp : *this)
+                result.push_back(kvp.first);
+            return result;
+        }
+
+        inline std::vector<V> Values() const
+        {
+            std::vector<V> result;
+            result.reserve(this->Size());
+            for (auto &kvp : *this)
+                result.push_back(kvp.second);
+            return result;
+        }
+
+        template <typename F>
+        void ForEach(const F &action) const
+        {
+            std::for_each(this->begin(), this->end(), action);
+        }
+    };
+} // namespace Collections
+
+#endif // __COLLECTIONS_DICTIONARY_SNAPSHOT
@@ -0,0 +1,843 @@
+#ifndef __COLLECTIONS_FLAT_HASH_TABLE
+#define __COLLECTIONS_FLAT_HASH_TABLE
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "Hash.hpp"
+#include "MemoryUsage.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Collections
+{
+    // 16 bytes de control que se comparan de un jalón (SSE2) o byte por byte si no hay SSE2
+    // cada byte : Empty (-128) | Deleted (-2) | 7 bits bajos del hash (0..127) cuando el slot está ocupado
+    class FlatGroup
+    {
+    public:
+        static constexpr size_t Width = 16;
+        static constexpr int8_t Empty = -128;
+        static constexpr int8_t Deleted = -2;
+
+#if defined(__SSE2__)
+        explicit FlatGroup(const int8_t *ctrl) : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl))) {}
+
+        inline uint32_t Match(int8_t h2) const
+        {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), this->ctrl)));
+        }
+
+        // Empty y Deleted son los únicos con el bit alto prendido
+        inline uint32_t MatchEmptyOrDeleted() const
+        {
+            return static_cast<uint32_t>(_mm_movemask_epi8(this->ctrl));
+        }
+
+    private:
+        __m128i ctrl;
+#else
+        explicit FlatGroup(const int8_t *ctrl)
+        {
+            std::memcpy(this->ctrl, ctrl, Width);
+        }
+
+        inline uint32_t Match(int8_t h2) const
+        {
+            uint32_t result = 0;
+            for (size_t i = 0; i < Width; ++i)
+                result |= static_cast<uint32_t>(this->ctrl[i] == h2) << i;
+            return result;
+        }
+
+        inline uint32_t MatchEmptyOrDeleted() const
+        {
+            uint32_t result = 0;
+            for (size_t i = 0; i < Width; ++i)
+                result |= static_cast<uint32_t>(this->ctrl[i] < 0) << i;
+            return result;
+        }
+
+    private:
+        int8_t ctrl[Width];
+#endif
+
+    public:
+        inline uint32_t MatchEmpty() const
+        {
+            return this->Match(Empty);
+        }
+    };
+
+    // Tabla hash plana (open addressing estilo swiss-table): los elementos viven en un solo arreglo contiguo y la búsqueda
+    // compara 16 bytes de control por instrucción, sin nodos ni apuntadores que perseguir.
+    // Expone el subconjunto de la interfaz de std::unordered_map/set que usan Dictionary y HashSet para servirles de backend.
+    // ojo : a diferencia de std::unordered_map, insertar puede mover los elementos (invalida apuntadores e iteradores)
+    template <typename T, typename K, typename KeyOf, typename H, typename E, typename A>
+    class FlatHashTable
+    {
+    public:
+        using key_type = K;
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using hasher = H;
+        using key_equal = E;
+        using allocator_type = A;
+        using reference = T &;
+        using const_reference = const T &;
+
+        template <bool Const>
+        class Iterator
+        {
+            friend class FlatHashTable;
+            template <bool>
+            friend class Iterator;
+
+            const int8_t *ctrl = nullptr;
+            const int8_t *ctrl_end = nullptr;
+            T *slot = nullptr;
+
+            inline void SkipFree()
+            {
+                while (this->ctrl != this->ctrl_end && *this->ctrl < 0)
+                {
+                    ++this->ctrl;
+                    ++this->slot;
+                }
+            }
+
+            Iterator(const int8_t *ctrl, T *slot, const int8_t *ctrl_end) : ctrl(ctrl), ctrl_end(ctrl_end), slot(slot)
+            {
+                this->SkipFree();
+            }
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using reference = std::conditional_t<Const, const T &, T &>;
+            using pointer = std::conditional_t<Const, const T *, T *>;
+
+            Iterator() = default;
+
+            template <bool C = Const, typename = std::enable_if_t<C>>
+            Iterator(const Iterator<false> &o) : ctrl(o.ctrl), ctrl_end(o.ctrl_end), slot(o.slot)
+            {
+            }
+
+            inline reference operator*() const
+            {
+                return *this->slot;
+            }
+
+            inline pointer operator->() const
+            {
+                return this->slot;
+            }
+
+            inline Iterator &operator++()
+            {
+                ++this->ctrl;
+                ++this->slot;
+                this->SkipFree();
+                return *this;
+            }
+
+            inline Iterator operator++(int)
+            {
+                auto result = *this;
+                ++*this;
+                return result;
+            }
+
+            friend inline bool operator==(const Iterator &a, const Iterator &b)
+            {
+                return a.ctrl == b.ctrl;
+            }
+        };
+
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+    protected:
+        using SlotAllocator = typename std::allocator_traits<A>::template rebind_alloc<T>;
+        using SlotTraits = std::allocator_traits<SlotAllocator>;
+        using CtrlAllocator = typename std::allocator_traits<A>::template rebind_alloc<int8_t>;
+
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        int8_t *ctrl = nullptr;
+        T *slots = nullptr;
+        size_t capacity = 0;
+        size_t used = 0;
+        size_t growth_left = 0;
+        float max_load = 0.875f;
+
+        [[no_unique_address]] H hash;
+        [[no_unique_address]] E equal;
+        [[no_unique_address]] SlotAllocator allocator;
+
+        // mezclamos la salida del hasher: std::hash es la identidad para enteros y los 7 bits bajos (h2) quedarían correlacionados con el grupo
+        template <typename Q>
+        inline size_t HashOf(const Q &key) const
+        {
+            uint64_t h = static_cast<uint64_t>(this->hash(key)) * 0x9E3779B97F4A7C15ULL;
+            return static_cast<size_t>(h ^ (h >> 32));
+        }
+
+        static inline int8_t H2(size_t h)
+        {
+            return static_cast<int8_t>(h & 0x7F);
+        }
+
+        inline size_t MaxLoad(size_t capacity) const
+        {
+            return static_cast<size_t>(static_cast<double>(capacity) * this->max_load);
+        }
+
+        inline size_t CapacityFor(size_t n) const
+        {
+            if (n == 0)
+                return 0;
+            size_t capacity = FlatGroup::Width;
+            while (this->MaxLoad(capacity) < n)
+                capacity *= 2;
+            return capacity;
+        }
+
+        // sondeo cuadrático por grupos completos (números triangulares): con potencia de 2 grupos visita todos
+        template <typename Q>
+        inline size_t FindIndex(const Q &key, size_t h) const
+        {
+            if (this->capacity == 0)
+                return npos;
+
+            const size_t groups = this->capacity / FlatGroup::Width;
+            const auto h2 = H2(h);
+            size_t g = (h >> 7) & (groups - 1);
+            for (size_t step = 1; step <= groups; ++step)
+            {
+                FlatGroup group(this->ctrl + g * FlatGroup::Width);
+                for (uint32_t match = group.Match(h2); match; match &= match - 1)
+                {
+                    size_t i = g * FlatGroup::Width + std::countr_zero(match);
+                    if (this->equal(KeyOf::Get(this->slots[i]), key))
+                        return i;
+                }
+                if (group.MatchEmpty())
+                    return npos;
+                g = (g + step) & (groups - 1);
+            }
+            return npos;
+        }
+
+        inline size_t FindInsertIndex(size_t h) const
+        {
+            const size_t groups = this->capacity / FlatGroup::Width;
+            size_t g = (h >> 7) & (groups - 1);
+            for (size_t step = 1;; ++step)
+            {
+                if (auto free = FlatGroup(this->ctrl + g * FlatGroup::Width).MatchEmptyOrDeleted(); free)
+                    return g * FlatGroup::Width + std::countr_zero(free);
+                g = (g + step) & (groups - 1);
+            }
+        }
+
+        inline iterator At(size_t i)
+        {
+            return iterator(this->ctrl + i, this->slots + i, this->ctrl + this->capacity);
+        }
+
+        inline const_iterator At(size_t i) const
+        {
+            return const_iterator(this->ctrl + i, this->slots + i, this->ctrl + this->capacity);
+        }
+
+        // el slot regresado está libre; si no hay crecimiento disponible se reacomoda la tabla antes
+        inline size_t PrepareInsert(size_t h)
+        {
+            if (this->capacity == 0)
+                this->Resize(FlatGroup::Width);
+
+            size_t i = this->FindInsertIndex(h);
+            if (this->growth_left == 0 && this->ctrl[i] != FlatGroup::Deleted)
+            {
+                // si la mitad son tumbas basta reacomodar en la misma capacidad
+                this->Resize(this->used * 2 < this->MaxLoad(this->capacity) ? this->capacity : this->capacity * 2);
+                i = this->FindInsertIndex(h);
+            }
+            return i;
+        }
+
+        inline void CommitInsert(size_t i, size_t h)
+        {
+            if (this->ctrl[i] == FlatGroup::Empty)
+                --this->growth_left;
+            this->ctrl[i] = H2(h);
+            ++this->used;
+        }
+
+        // busca la llave y sólo construye el elemento (con args) si no existe
+        // si hay que reacomodar la tabla el elemento se arma antes: key / args pueden apuntar a elementos de esta misma
+        // tabla (p.ej. d.Add(k, d[otra])) que el Resize mueve y libera
+        template <typename Q, typename... Args>
+        inline std::pair<iterator, bool> EmplaceKey(const Q &key, Args &&...args)
+        {
+            const size_t h = this->HashOf(key);
+            if (size_t i = this->FindIndex(key, h); i != npos)
+                return {this->At(i), false};
+
+            size_t i;
+            if (this->capacity != 0 && (i = this->FindInsertIndex(h), this->growth_left != 0 || this->ctrl[i] == FlatGroup::Deleted))
+            {
+                SlotTraits::construct(this->allocator, this->slots + i, std::forward<Args>(args)...);
+            }
+            else
+            {
+                T element(std::forward<Args>(args)...);
+                i = this->PrepareInsert(h);
+                SlotTraits::construct(this->allocator, this->slots + i, std::move(element));
+            }
+            this->CommitInsert(i, h);
+            return {this->At(i), true};
+        }
+
+        inline void EraseAt(size_t i)
+        {
+            SlotTraits::destroy(this->allocator, this->slots + i);
+            --this->used;
+
+            // si el grupo ya tenía un vacío ninguna búsqueda siguió de largo por aquí, podemos marcarlo vacío en vez de tumba
+            if (FlatGroup(this->ctrl + (i / FlatGroup::Width) * FlatGroup::Width).MatchEmpty())
+            {
+                this->ctrl[i] = FlatGroup::Empty;
+                ++this->growth_left;
+            }
+            else
+            {
+                this->ctrl[i] = FlatGroup::Deleted;
+            }
+        }
+
+        inline void Allocate(size_t capacity)
+        {
+            this->capacity = capacity;
+            if (capacity == 0)
+            {
+                this->ctrl = nullptr;
+                this->slots = nullptr;
+                this->growth_left = 0;
+                return;
+            }
+
+            CtrlAllocator ctrl_allocator(this->allocator);
+            this->ctrl = std::allocator_traits<CtrlAllocator>::allocate(ctrl_allocator, capacity);
+            std::memset(this->ctrl, static_cast<uint8_t>(FlatGroup::Empty), capacity);
+            this->slots = SlotTraits::allocate(this->allocator, capacity);
+            this->growth_left = this->MaxLoad(capacity);
+        }
+
+        inline void Deallocate(int8_t *ctrl, T *slots, size_t capacity)
+        {
+            if (capacity == 0)
+                return;
+
+            CtrlAllocator ctrl_allocator(this->allocator);
+            std::allocator_traits<CtrlAllocator>::deallocate(ctrl_allocator, ctrl, capacity);
+            SlotTraits::deallocate(this->allocator, slots, capacity);
+        }
+
+        inline void DestroyAll()
+        {
+            if constexpr (!std::is_trivially_destructible<T>::value)
+            {
+                for (size_t i = 0; i < this->capacity; ++i)
+                {
+                    if (this->ctrl[i] >= 0)
+                        SlotTraits::destroy(this->allocator, this->slots + i);
+                }
+            }
+        }
+
+        void Resize(size_t capacity)
+        {
+            auto old_ctrl = this->ctrl;
+            auto old_slots = this->slots;
+            auto old_capacity = this->capacity;
+
+            this->Allocate(capacity);
+            for (size_t i = 0; i < old_capacity; ++i)
+            {
+                if (old_ctrl[i] < 0)
+                    continue;
+
+                const size_t h = this->HashOf(KeyOf::Get(old_slots[i]));
+                const size_t j = this->FindInsertIndex(h);
+                SlotTraits::construct(this->allocator, this->slots + j, std::move(old_slots[i]));
+                SlotTraits::destroy(this->allocator, old_slots + i);
+                this->ctrl[j] = H2(h);
+            }
+            this->growth_left -= this->used;
+
+            this->Deallocate(old_ctrl, old_slots, old_capacity);
+        }
+
+        void CopyFrom(const FlatHashTable &o)
+        {
+            this->max_load = o.max_load;
+            this->Allocate(o.capacity);
+            for (size_t i = 0; i < o.capacity; ++i)
+            {
+                if (o.ctrl[i] >= 0)
+                    SlotTraits::construct(this->allocator, this->slots + i, o.slots[i]);
+                this->ctrl[i] = o.ctrl[i];
+            }
+            this->used = o.used;
+            this->growth_left = o.growth_left;
+        }
+
+        void Steal(FlatHashTable &o)
+        {
+            this->ctrl = std::exchange(o.ctrl, nullptr);
+            this->slots = std::exchange(o.slots, nullptr);
+            this->capacity = std::exchange(o.capacity, 0);
+            this->used = std::exchange(o.used, 0);
+            this->growth_left = std::exchange(o.growth_left, 0);
+            this->max_load = o.max_load;
+        }
+
+    public:
+        FlatHashTable() = default;
+
+        explicit FlatHashTable(const A &allocator) : allocator(allocator) {}
+
+        explicit FlatHashTable(size_t n, const H &hash = H(), const E &equal = E(), const A &allocator = A())
+            : hash(hash), equal(equal), allocator(allocator)
+        {
+            this->reserve(n);
+        }
+
+        FlatHashTable(const FlatHashTable &o)
+            : hash(o.hash), equal(o.equal), allocator(SlotTraits::select_on_container_copy_construction(o.allocator))
+        {
+            this->CopyFrom(o);
+        }
+
+        FlatHashTable(FlatHashTable &&o) noexcept
+            : hash(std::move(o.hash)), equal(std::move(o.equal)), allocator(std::move(o.allocator))
+        {
+            this->Steal(o);
+        }
+
+        FlatHashTable &operator=(const FlatHashTable &o)
+        {
+            if (this != &o)
+            {
+                this->DestroyAll();
+                this->Deallocate(this->ctrl, this->slots, this->capacity);
+                this->hash = o.hash;
+                this->equal = o.equal;
+                this->CopyFrom(o);
+            }
+            return *this;
+        }
+
+        FlatHashTable &operator=(FlatHashTable &&o) noexcept
+        {
+            if (this != &o)
+            {
+                this->DestroyAll();
+                this->Deallocate(this->ctrl, this->slots, this->capacity);
+                this->hash = std::move(o.hash);
+                this->equal = std::move(o.equal);
+                if constexpr (SlotTraits::propagate_on_container_move_assignment::value)
+                    this->allocator = std::move(o.allocator);
+
+                if (this->allocator == o.allocator)
+                {
+                    this->Steal(o);
+                }
+                else
+                {
+                    // allocators distintos (p.ej. pmr con otro resource): no podemos adueñarnos de su memoria
+                    this->used = 0;
+                    this->Allocate(0);
+                    this->reserve(o.used);
+                    for (auto &e : o)
+                    {
+                        const size_t h = this->HashOf(KeyOf::Get(e));
+                        const size_t i = this->PrepareInsert(h);
+                        SlotTraits::construct(this->allocator, this->slots + i, std::move(e));
+                        this->CommitInsert(i, h);
+                    }
+                    o.clear();
+                }
+            }
+            return *this;
+        }
+
+        ~FlatHashTable()
+        {
+            this->DestroyAll();
+            this->Deallocate(this->ctrl, this->slots, this->capacity);
+        }
+
+        inline iterator begin()
+        {
+            return iterator(this->ctrl, this->slots, this->ctrl + this->capacity);
+        }
+
+        inline iterator end()
+        {
+            return iterator(this->ctrl + this->capacity, this->slots + this->capacity, this->ctrl + this->capacity);
+        }
+
+        inline const_iterator begin() const
+        {
+            return const_iterator(this->ctrl, this->slots, this->ctrl + this->capacity);
+        }
+
+        inline const_iterator end() const
+        {
+            return const_iterator(this->ctrl + this->capacity, this->slots + this->capacity, this->ctrl + this->capacity);
+        }
+
+        inline size_t size() const
+        {
+            return this->used;
+        }
+
+        inline bool empty() const
+        {
+            return this->used == 0;
+        }
+
+        inline iterator find(const K &key)
+        {
+            auto i = this->FindIndex(key, this->HashOf(key));
+            return i == npos ? this->end() : this->At(i);
+        }
+
+        inline const_iterator find(const K &key) const
+        {
+            auto i = this->FindIndex(key, this->HashOf(key));
+            return i == npos ? this->end() : this->At(i);
+        }
+
+        // búsqueda heterogénea cuando el hasher y el comparador son transparentes (ver Hash.hpp)
+        template <typename Q>
+            requires TransparentHash<H, E>
+        inline iterator find(const Q &key)
+        {
+            auto i = this->FindIndex(key, this->HashOf(key));
+            return i == npos ? this->end() : this->At(i);
+        }
+
+        template <typename Q>
+            requires TransparentHash<H, E>
+        inline const_iterator find(const Q &key) const
+        {
+            auto i = this->FindIndex(key, this->HashOf(key));
+            return i == npos ? this->end() : this->At(i);
+        }
+
+        // búsqueda en dos fases para lotes (ver Dictionary::TryGetMany): hash_of + prefetch de todas las llaves primero
+        // y después find(key, h), así los misses del grupo de cada llave se traslapan y la llave se hashea una sola vez
+        template <typename Q>
+        inline size_t hash_of(const Q &key) const
+        {
+            return this->HashOf(key);
+        }
+
+        // pide el grupo de control y los slots donde empieza el sondeo de h
+        inline void prefetch(size_t h) const
+        {
+            if (this->capacity == 0)
+                return;
+            size_t g = (h >> 7) & (this->capacity / FlatGroup::Width - 1);
+            Prefetch(this->ctrl + g * FlatGroup::Width);
+            Prefetch(this->slots + g * FlatGroup::Width);
+        }
+
+        template <typename Q>
+        inline iterator find(const Q &key, size_t h)
+        {
+            auto i = this->FindIndex(key, h);
+            return i == npos ? this->end() : this->At(i);
+        }
+
+        inline size_t count(const K &key) const
+        {
+            return this->FindIndex(key, this->HashOf(key)) != npos;
+        }
+
+        inline bool contains(const K &key) const
+        {
+            return this->count(key) != 0;
+        }
+
+        inline size_t erase(const K &key)
+        {
+            if (auto i = this->FindIndex(key, this->HashOf(key)); i != npos)
+            {
+                this->EraseAt(i);
+                return 1;
+            }
+            return 0;
+        }
+
+        template <typename Q>
+            requires TransparentHash<H, E>
+        inline size_t erase(const Q &key)
+        {
+            if (auto i = this->FindIndex(key, this->HashOf(key)); i != npos)
+            {
+                this->EraseAt(i);
+                return 1;
+            }
+            return 0;
+        }
+
+        inline iterator erase(const_iterator position)
+        {
+            const size_t i = position.slot - this->slots;
+            this->EraseAt(i);
+            return this->At(i);
+        }
+
+        inline iterator erase(iterator position)
+        {
+            return this->erase(const_iterator(position));
+        }
+
+        void clear()
+        {
+            this->DestroyAll();
+            if (this->capacity)
+                std::memset(this->ctrl, static_cast<uint8_t>(FlatGroup::Empty), this->capacity);
+            this->used = 0;
+            this->growth_left = this->MaxLoad(this->capacity);
+        }
+
+        inline void reserve(size_t n)
+        {
+            if (auto capacity = this->CapacityFor(n); capacity > this->capacity)
+                this->Resize(capacity);
+        }
+
+        // rehash(0) compacta la tabla a la mínima capacidad para los elementos actuales
+        inline void rehash(size_t n)
+        {
+            auto capacity = std::max(this->CapacityFor(this->used), n ? std::bit_ceil(std::max(n, FlatGroup::Width)) : size_t(0));
+            if (capacity != this->capacity)
+                this->Resize(capacity);
+        }
+
+        inline size_t bucket_count() const
+        {
+            return this->capacity;
+        }
+
+        // control bytes + slots (ver ContainerMemoryUsage)
+        inline size_t memory_usage() const
+        {
+            return AllocationSize(this->capacity) + AllocationSize(this->capacity * sizeof(T));
+        }
+
+        inline float load_factor() const
+        {
+            return this->capacity ? static_cast<float>(this->used) / static_cast<float>(this->capacity) : 0.0f;
+        }
+
+        inline float max_load_factor() const
+        {
+            return this->max_load;
+        }
+
+        // arriba de ~15/16 el sondeo se degrada y nos quedaríamos sin grupos con vacíos
+        inline void max_load_factor(float max_load)
+        {
+            this->max_load = std::clamp(max_load, 0.25f, 0.9375f);
+            if (this->capacity)
+                this->Resize(std::max(this->capacity, this->CapacityFor(this->used)));
+        }
+
+        inline hasher hash_function() const
+        {
+            return this->hash;
+        }
+
+        inline key_equal key_eq() const
+        {
+            return this->equal;
+        }
+
+        inline allocator_type get_allocator() const
+        {
+            return allocator_type(this->allocator);
+        }
+    };
+
+    struct FlatMapKeyOf
+    {
+        template <typename P>
+        static inline const auto &Get(const P &p)
+        {
+            return p.first;
+        }
+    };
+
+    struct FlatSetKeyOf
+    {
+        template <typename T>
+        static inline const T &Get(const T &t)
+        {
+            return t;
+        }
+    };
+
+    // backend plano para Dictionary : Dictionary<K, V, FlatHashMap<K, V>>
+    template <typename K, typename V, typename H = Hash<K>, typename E = Equal<K>, typename A = std::allocator<std::pair<const K, V>>>
+    class FlatHashMap : public FlatHashTable<std::pair<const K, V>, K, FlatMapKeyOf, H, E, A>
+    {
+        using Base = FlatHashTable<std::pair<const K, V>, K, FlatMapKeyOf, H, E, A>;
+
+    public:
+        using mapped_type = V;
+        using typename Base::const_iterator;
+        using typename Base::iterator;
+        using typename Base::value_type;
+
+        using Base::Base;
+
+        template <typename I>
+        FlatHashMap(I first, I last, size_t n = 0, const H &hash = H(), const E &equal = E(), const A &allocator = A()) : Base(n, hash, equal, allocator)
+        {
+            for (; first != last; ++first)
+                this->insert(*first);
+        }
+
+        template <typename... Args>
+        inline std::pair<iterator, bool> try_emplace(const K &key, Args &&...args)
+        {
+            return this->EmplaceKey(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+
+        template <typename... Args>
+        inline std::pair<iterator, bool> try_emplace(K &&key, Args &&...args)
+        {
+            // la búsqueda usa key antes de moverla al construir
+            return this->EmplaceKey(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+
+        template <typename M>
+        inline std::pair<iterator, bool> insert_or_assign(const K &key, M &&value)
+        {
+            auto result = this->try_emplace(key, std::forward<M>(value));
+            if (!result.second)
+                result.first->second = std::forward<M>(value); // try_emplace no lo consumió
+            return result;
+        }
+
+        template <typename M>
+        inline std::pair<iterator, bool> insert_or_assign(K &&key, M &&value)
+        {
+            auto result = this->try_emplace(std::move(key), std::forward<M>(value));
+            if (!result.second)
+                result.first->second = std::forward<M>(value);
+            return result;
+        }
+
+        inline std::pair<iterator, bool> insert(const value_type &value)
+        {
+            return this->try_emplace(value.first, value.second);
+        }
+
+        inline std::pair<iterator, bool> insert(value_type &&value)
+        {
+            return this->try_emplace(value.first, std::move(value.second));
+        }
+
+        template <typename... Args>
+        inline std::pair<iterator, bool> emplace(Args &&...args)
+        {
+            value_type value(std::forward<Args>(args)...);
+            return this->try_emplace(value.first, std::move(value.second));
+        }
+
+        inline V &operator[](const K &key)
+        {
+            return this->try_emplace(key).first->second;
+        }
+
+        inline V &operator[](K &&key)
+        {
+            return this->try_emplace(std::move(key)).first->second;
+        }
+
+        inline V &at(const K &key)
+        {
+            if (auto result = this->find(key); result != this->end())
+                return result->second;
+            throw std::out_of_range("FlatHashMap::at");
+        }
+
+        inline const V &at(const K &key) const
+        {
+            if (auto result = this->find(key); result != this->end())
+                return result->second;
+            throw std::out_of_range("FlatHashMap::at");
+        }
+    };
+
+    // backend plano para HashSet : HashSet<T, FlatHashSet<T>>
+    template <typename T, typename H = Hash<T>, typename E = Equal<T>, typename A = std::allocator<T>>
+    class FlatHashSet : public FlatHashTable<T, T, FlatSetKeyOf, H, E, A>
+    {
+        using Base = FlatHashTable<T, T, FlatSetKeyOf, H, E, A>;
+
+    public:
+        using typename Base::const_iterator;
+        using typename Base::iterator;
+
+        using Base::Base;
+
+        template <typename I>
+        FlatHashSet(I first, I last, size_t n = 0, const H &hash = H(), const E &equal = E(), const A &allocator = A()) : Base(n, hash, equal, allocator)
+        {
+            for (; first != last; ++first)
+                this->insert(*first);
+        }
+
+        inline std::pair<iterator, bool> insert(const T &value)
+        {
+            return this->EmplaceKey(value, value);
+        }
+
+        inline std::pair<iterator, bool> insert(T &&value)
+        {
+            return this->EmplaceKey(value, std::move(value));
+        }
+
+        template <typename... Args>
+        inline std::pair<iterator, bool> emplace(Args &&...args)
+        {
+            T value(std::forward<Args>(args)...);
+            return this->insert(std::move(value));
+        }
+    };
+} // namespace Collections
+
+#endif // __COLLECTIONS_FLAT_HASH_TABLE
@@ -0,0 +1,511 @@
+#ifndef __COLLECTIONS_FROZEN_HASH_TABLE
+#define __COLLECTIONS_FROZEN_HASH_TABLE
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "FlatHashTable.hpp"
+#include "Hash.hpp"
+#include "MappedSnapshot.hpp"
+#include "MemoryUsage.hpp"
+
+namespace Collections
+{
+    // Tabla hash inmutable con hash perfecto mínimo (hash and displace, CHD): n elementos en exactamente n slots
+    // - cada llave cae en una cubeta (~2 llaves por cubeta) y cada cubeta guarda una semilla que manda a todas sus
+    //   llaves a slots distintos; las cubetas de una sola llave guardan su slot directo
+    // - buscar = un hash, leer la semilla de la cubeta y comparar contra el único slot posible: sin sondeo ni ramas
+    //   por colisiones, y una llave que no está cuesta lo mismo que una que sí
+    // - se construye una vez y sólo se lee: sin locks, se comparte entre todos los threads sin wrapper Concurrent
+    // Para datos de referencia que se cargan al arranque (símbolos, tablas de comisiones), ver FrozenDictionary / FrozenHashSet
+    template <typename T, typename K, typename KeyOf, typename H, typename E>
+    class FrozenHashTable
+    {
+    public:
+        using key_type = K;
+        using value_type = T;
+        using hasher = H;
+        using key_equal = E;
+        using const_iterator = const T *;
+
+    protected:
+        // semilla con el bit alto prendido: los bits bajos son el slot de la única llave de la cubeta
+        static constexpr uint32_t Direct = 0x80000000u;
+        // intentos por cubeta antes de empezar de nuevo con otra semilla global
+        static constexpr uint32_t MaxSeed = 1u << 20;
+        // semillas globales antes de rendirse: sin colisiones del hasher una sola casi siempre basta
+        static constexpr uint64_t MaxAttempts = 64;
+        static constexpr size_t KeysPerBucket = 2;
+
+        // dueño de los slots y las semillas: los vectores que armó Build o el archivo mapeado (ver MapSnapshot)
+        // la tabla nunca cambia, así que las copias lo comparten
+        std::shared_ptr<const void> storage;
+        const T *entries = nullptr;
+        const uint32_t *seeds = nullptr;
+        size_t count = 0, buckets = 0;
+        uint64_t seed = 0;
+        [[no_unique_address]] H hash;
+        [[no_unique_address]] E equal;
+
+        // fmix64 de murmur3: std::hash es la identidad para enteros
+        static inline uint64_t Mix(uint64_t h)
+        {
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+
+        // h en [0, n) sin división (multiply-shift de Lemire)
+        static inline size_t Range(uint64_t h, size_t n)
+        {
+#if defined(__SIZEOF_INT128__)
+            return static_cast<size_t>((static_cast<unsigned __int128>(h) * n) >> 64);
+#else
+            return static_cast<size_t>(h % n);
+#endif
+        }
+
+        template <typename Q>
+        inline uint64_t HashOf(const Q &key) const
+        {
+            return Mix(static_cast<uint64_t>(this->hash(key)) ^ this->seed);
+        }
+
+        static inline size_t Displace(uint64_t h, uint32_t seed, size_t n)
+        {
+            return Range(Mix(h + seed * 0x9E3779B97F4A7C15ULL), n);
+        }
+
+        inline size_t SlotOf(uint64_t h) const
+        {
+            auto seed = this->seeds[Range(h, this->buckets)];
+            return seed & Direct ? seed & ~Direct : Displace(h, seed, this->count);
+        }
+
+        template <typename Q>
+        inline const T *Find(const Q &key) const
+        {
+            if (this->count == 0)
+                return nullptr;
+            auto &entry = this->entries[this->SlotOf(this->HashOf(key))];
+            return this->equal(KeyOf::Get(entry), key) ? &entry : nullptr;
+        }
+
+        // acomoda items en sus slots; lanza std::invalid_argument con llaves repetidas o si el hasher da el mismo valor
+        // a dos llaves distintas (Mix es biyectiva: ninguna semilla global las separa)
+        inline void Build(std::vector<T> items)
+        {
+            const size_t n = items.size();
+            if (n >= Direct)
+                throw std::length_error("FrozenHashTable: too many elements");
+            this->storage.reset();
+            this->entries = nullptr;
+            this->seeds = nullptr;
+            this->count = this->buckets = 0;
+            if (n == 0)
+                return;
+
+            struct Owned
+            {
+                std::vector<T> entries;
+                std::vector<uint32_t> seeds;
+            };
+            {
+                std::vector<std::pair<uint64_t, size_t>> raw(n);
+                for (size_t i = 0; i < n; ++i)
+                    raw[i] = {static_cast<uint64_t>(this->hash(KeyOf::Get(items[i]))), i};
+                std::sort(raw.begin(), raw.end());
+                for (size_t i = 1; i < n; ++i)
+                {
+                    if (raw[i].first != raw[i - 1].first)
+                        continue;
+                    if (this->equal(KeyOf::Get(items[raw[i].second]), KeyOf::Get(items[raw[i - 1].second])))
+                        throw std::invalid_argument("FrozenHashTable: duplicate key");
+                    throw std::invalid_argument("FrozenHashTable: hasher collision");
+                }
+            }
+
+            auto owned = std::make_shared<Owned>();
+            const size_t buckets = (n + KeysPerBucket - 1) / KeysPerBucket;
+            std::vector<uint64_t> hashes(n);
+            std::vector<size_t> slot_of(n);
+            for (uint64_t attempt = 0;; ++attempt)
+            {
+                if (attempt == MaxAttempts)
+                    throw std::runtime_error("FrozenHashTable: no seed places every key");
+                this->seed = Mix(attempt + 1);
+                for (size_t i = 0; i < n; ++i)
+                    hashes[i] = this->HashOf(KeyOf::Get(items[i]));
+                if (this->Place(items, hashes, buckets, owned->seeds, slot_of))
+                    break;
+            }
+
+            // el orden de items por slot
+            std::vector<size_t> at(n);
+            for (size_t i = 0; i < n; ++i)
+                at[slot_of[i]] = i;
+            owned->entries.reserve(n);
+            for (size_t slot = 0; slot < n; ++slot)
+                owned->entries.push_back(std::move(items[at[slot]]));
+
+            this->entries = owned->entries.data();
+            this->seeds = owned->seeds.data();
+            this->count = n;
+            this->buckets = buckets;
+            this->storage = std::move(owned);
+        }
+
+        // ver SaveSnapshot / MapSnapshot de FrozenDictionary y FrozenHashSet
+        inline void Save(const std::string &path, SnapshotKind kind) const
+        {
+            WriteSnapshot<T, H>(path, kind, this->entries, this->count, this->seeds, this->buckets, this->seed);
+        }
+
+        inline void Map(const std::string &path, SnapshotKind kind, bool verify)
+        {
+            auto mapped = MapSnapshotFile<T, H>(path, kind, verify);
+            if (mapped.count >= Direct || (mapped.count != 0 && mapped.buckets != (mapped.count + KeysPerBucket - 1) / KeysPerBucket))
+                throw std::runtime_error("MapSnapshot: bad table size in " + path);
+            // un slot directo fuera de rango leería fuera del archivo: se revisa aunque no se pida verify
+            // (sólo las semillas, 2 bytes por llave; los slots siguen siendo lazy)
+            for (size_t b = 0; b < mapped.buckets; ++b)
+                if ((mapped.seeds[b] & Direct) && (mapped.seeds[b] & ~Direct) >= mapped.count)
+                    throw std::runtime_error("MapSnapshot: bad bucket seed in " + path);
+            this->entries = static_cast<const T *>(mapped.entries);
+            this->seeds = mapped.seeds;
+            this->count = mapped.count;
+            this->buckets = mapped.buckets;
+            this->seed = mapped.seed;
+            this->storage = std::move(mapped.file);
+        }
+
+    private:
+        // busca una semilla por cubeta, de la más grande a la más chica; false si hay que probar otra semilla global
+        inline bool Place(const std::vector<T> &items, const std::vector<uint64_t> &hashes, size_t buckets, std::vector<uint32_t> &seeds, std::vector<size_t> &slot_of)
+        {
+            const size_t n = items.size();
+            // items agrupados por cubeta (counting sort)
+            std::vector<size_t> start(buckets + 1), members(n);
+            for (size_t i = 0; i < n; ++i)
+                ++start[Range(hashes[i], buckets) + 1];
+            for (size_t b = 0; b < buckets; ++b)
+                start[b + 1] += start[b];
+            {
+                auto next = start;
+                for (size_t i = 0; i < n; ++i)
+                    members[next[Range(hashes[i], buckets)]++] = i;
+            }
+            std::vector<size_t> order(buckets);
+            for (size_t b = 0; b < buckets; ++b)
+                order[b] = b;
+            std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                             { return start[a + 1] - start[a] > start[b + 1] - start[b]; });
+
+            seeds.assign(buckets, 0);
+            std::vector<bool> taken(n);
+            std::vector<size_t> slots;
+
+            size_t first_single = buckets;
+            for (size_t o = 0; o < buckets; ++o)
+            {
+                size_t b = order[o], size = start[b + 1] - start[b];
+                if (size < 2)
+                {
+                    first_single = o;
+                    break;
+                }
+
+                uint32_t seed = 0;
+                for (; seed < MaxSeed; ++seed)
+                {
+                    slots.clear();
+                    bool fits = true;
+                    for (size_t i = start[b]; i < start[b + 1] && fits; ++i)
+                    {
+                        auto slot = Displace(hashes[members[i]], seed, n);
+                        fits = !taken[slot] && std::find(slots.begin(), slots.end(), slot) == slots.end();
+                        slots.push_back(slot);
+                    }
+                    if (fits)
+                        break;
+                }
+                if (seed == MaxSeed)
+                    return false;
+
+                seeds[b] = seed;
+                for (size_t i = start[b], k = 0; i < start[b + 1]; ++i, ++k)
+                {
+                    taken[slots[k]] = true;
+                    slot_of[members[i]] = slots[k];
+                }
+            }
+
+            // las cubetas de una llave toman directo los slots que quedaron libres
+            size_t free = 0;
+            for (size_t o = first_single; o < buckets; ++o)
+            {
+                size_t b = order[o];
+                if (start[b + 1] == start[b])
+                    break;
+                while (taken[free])
+                    ++free;
+                taken[free] = true;
+                seeds[b] = Direct | static_cast<uint32_t>(free);
+                slot_of[members[start[b]]] = free;
+            }
+            return true;
+        }
+
+    public:
+        FrozenHashTable() = default;
+
+        inline size_t size() const
+        {
+            return this->count;
+        }
+
+        inline bool empty() const
+        {
+            return this->count == 0;
+        }
+
+        // el orden es el de los slots, no el de inserción
+        inline const_iterator begin() const
+        {
+            return this->entries;
+        }
+
+        inline const_iterator end() const
+        {
+            return this->entries + this->count;
+        }
+
+        // bytes de la tabla: los elementos más 4 bytes por cubeta
+        inline size_t Bytes() const
+        {
+            return this->count * sizeof(T) + this->buckets * sizeof(uint32_t);
+        }
+
+        // ver Dictionary::MemoryUsage; con MapSnapshot los slots son páginas del archivo (page cache), no heap
+        inline size_t MemoryUsage(bool deep = false) const
+        {
+            size_t result = sizeof(*this) + AllocationSize(this->count * sizeof(T)) + AllocationSize(this->buckets * sizeof(uint32_t));
+            return result + (deep ? ElementsHeapSize(*this) : 0);
+        }
+    };
+
+    // Dictionary de sólo lectura con hash perfecto mínimo (ver FrozenHashTable); se obtiene con Dictionary::Freeze()
+    // o directo de un std::unordered_map / rango de pares
+    template <typename K, typename V, typename H = Hash<K>, typename E = Equal<K>>
+    class FrozenDictionary : public FrozenHashTable<std::pair<const K, V>, K, FlatMapKeyOf, H, E>
+    {
+        using Base = FrozenHashTable<std::pair<const K, V>, K, FlatMapKeyOf, H, E>;
+
+    public:
+        using mapped_type = V;
+
+        FrozenDictionary() = default;
+
+        template <typename I>
+        FrozenDictionary(I first, I last)
+        {
+            this->Build(std::vector<std::pair<const K, V>>(first, last));
+        }
+
+        template <typename H2, typename E2, typename A>
+        explicit FrozenDictionary(const std::unordered_map<K, V, H2, E2, A> &o) : FrozenDictionary(o.begin(), o.end())
+        {
+        }
+
+        inline size_t Size() const
+        {
+            return this->size();
+        }
+
+        inline bool Any() const
+        {
+            return !this->empty();
+        }
+
+        inline bool ContainsKey(const K &key) const
+        {
+            return this->Find(key) != nullptr;
+        }
+
+        template <typename Q>
+            requires TransparentHash<H, E> && (!std::is_same<std::remove_cvref_t<Q>, K>::value)
+        inline bool ContainsKey(const Q &key) const
+        {
+            return this->Find(key) != nullptr;
+        }
+
+        inline bool TryGetValue(const K &key, V &value) const
+        {
+            if (auto found = this->Find(key))
+            {
+                value = found->second;
+                return true;
+            }
+            return false;
+        }
+
+        template <typename Q>
+            requires TransparentHash<H, E> && (!std::is_same<std::remove_cvref_t<Q>, K>::value)
+        inline bool TryGetValue(const Q &key, V &value) const
+        {
+            if (auto found = this->Find(key))
+            {
+                value = found->second;
+                return true;
+            }
+            return false;
+        }
+
+        // el apuntador es válido mientras viva el diccionario (nunca cambia)
+        inline bool TryGetValue(const K &key, const V *&value) const
+        {
+            auto found = this->Find(key);
+            value = found ? &found->second : nullptr;
+            return found != nullptr;
+        }
+
+        template <typename Q>
+            requires TransparentHash<H, E> && (!std::is_same<std::remove_cvref_t<Q>, K>::value)
+        inline bool TryGetValue(const Q &key, const V *&value) const
+        {
+            auto found = this->Find(key);
+            value = found ? &found->second : nullptr;
+            return found != nullptr;
+        }
+
+        template <typename F>
+        inline bool TryGetValueExec(const K &key, const F &action) const
+        {
+            if (auto found = this->Find(key))
+            {
+                action(found->second);
+                return true;
+            }
+            return false;
+        }
+
+        // no inserta nada: lanza std::out_of_range si la llave no existe
+        inline const V &operator[](const K &key) const
+        {
+            if (auto found = this->Find(key))
+                return found->second;
+            throw std::out_of_range("FrozenDictionary: key not found");
+        }
+
+        template <typename F>
+        void ForEach(const F &action) const
+        {
+            std::for_each(this->begin(), this->end(), action);
+        }
+
+        inline std::vector<K> Keys() const
+        {
+            std::vector<K> result;
+            result.reserve(this->size());
+            for (auto &kvp : *this)
+                result.push_back(kvp.first);
+            return result;
+        }
+
+        inline std::vector<V> Values() const
+        {
+            std::vector<V> result;
+            result.reserve(this->size());
+            for (auto &kvp : *this)
+                result.push_back(kvp.second);
+            return result;
+        }
+
+        // ver MappedSnapshot.hpp; K y V trivialmente copiables
+        inline void SaveSnapshot(const std::string &path) const
+        {
+            this->Save(path, SnapshotKind::Dictionary);
+        }
+
+        // consulta directo sobre el archivo mapeado; verify lee todo el archivo para revisar el checksum
+        static FrozenDictionary MapSnapshot(const std::string &path, bool verify = false)
+        {
+            FrozenDictionary result;
+            result.Map(path, SnapshotKind::Dictionary, verify);
+            return result;
+        }
+    };
+
+    // HashSet de sólo lectura con hash perfecto mínimo (ver FrozenHashTable); se obtiene con HashSet::Freeze()
+    template <typename T, typename H = Hash<T>, typename E = Equal<T>>
+    class FrozenHashSet : public FrozenHashTable<T, T, FlatSetKeyOf, H, E>
+    {
+    public:
+        FrozenHashSet() = default;
+
+        template <typename I>
+        FrozenHashSet(I first, I last)
+        {
+            this->Build(std::vector<T>(first, last));
+        }
+
+        template <typename H2, typename E2, typename A>
+        explicit FrozenHashSet(const std::unordered_set<T, H2, E2, A> &o) : FrozenHashSet(o.begin(), o.end())
+        {
+        }
+
+        inline size_t Size() const
+        {
+            return this->size();
+        }
+
+        inline bool Any() const
+        {
+            return !this->empty();
+        }
+
+        inline bool Contains(const T &t) const
+        {
+            return this->Find(t) != nullptr;
+        }
+
+        template <typename Q>
+            requires TransparentHash<H, E> && (!std::is_same<std::remove_cvref_t<Q>, T>::value)
+        inline bool Contains(const Q &t) const
+        {
+            return this->Find(t) != nullptr;
+        }
+
+        inline bool Exists(const T &t) const
+        {
+            return this->Contains(t);
+        }
+
+        // ver MappedSnapshot.hpp; T trivialmente copiable
+        inline void SaveSnapshot(const std::string &path) const
+        {
+            this->Save(path, SnapshotKind::HashSet);
+        }
+
+        static FrozenHashSet MapSnapshot(const std::string &path, bool verify = false)
+        {
+            FrozenHashSet result;
+            result.Map(path, SnapshotKind::HashSet, verify);
+            return result;
+        }
+    };
+} // namespace Collections
+
+#endif // __COLLECTIONS_FROZEN_HASH_TABLE
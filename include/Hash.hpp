@@ -0,0 +1,237 @@
+#ifndef __COLLECTIONS_HASH
+#define __COLLECTIONS_HASH
+
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace Collections
+{
+    namespace Detail
+    {
+        // constantes de wyhash
+        inline constexpr uint64_t WySecret[4] = {0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL};
+
+        // producto de 128 bits plegado a 64 (parte baja ^ parte alta)
+        inline uint64_t WyMix(uint64_t a, uint64_t b)
+        {
+#if defined(__SIZEOF_INT128__)
+            unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+            return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+#else
+            uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+            uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32);
+            uint64_t lo = t + (rm1 << 32), hi = rh + (rm0 >> 32) + (rm1 >> 32) + (t < rl) + (lo < t);
+            return lo ^ hi;
+#endif
+        }
+
+        inline uint64_t WyRead8(const unsigned char *p)
+        {
+            uint64_t v;
+            std::memcpy(&v, p, 8);
+            return v;
+        }
+
+        inline uint64_t WyRead4(const unsigned char *p)
+        {
+            uint32_t v;
+            std::memcpy(&v, p, 4);
+            return v;
+        }
+    } // namespace Detail
+
+    // wyhash (final v4): 48 bytes por vuelta en tres cadenas independientes de multiplicaciones de 128 bits
+    // sin semilla aleatoria por proceso: el mismo hash en cualquier proceso (ver MappedSnapshot.hpp); no resiste HashDoS
+    inline uint64_t HashBytes(const void *data, size_t size, uint64_t seed = 0)
+    {
+        using namespace Detail;
+        auto p = static_cast<const unsigned char *>(data);
+        seed ^= WyMix(seed ^ WySecret[0], WySecret[1]);
+        uint64_t a, b;
+        if (size <= 16)
+        {
+            if (size >= 4)
+            {
+                a = (WyRead4(p) << 32) | WyRead4(p + ((size >> 3) << 2));
+                b = (WyRead4(p + size - 4) << 32) | WyRead4(p + size - 4 - ((size >> 3) << 2));
+            }
+            else if (size > 0)
+            {
+                a = (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[size >> 1]) << 8) | p[size - 1];
+                b = 0;
+            }
+            else
+                a = b = 0;
+        }
+        else
+        {
+            size_t i = size;
+            if (i > 48)
+            {
+                uint64_t see1 = seed, see2 = seed;
+                do
+                {
+                    seed = WyMix(WyRead8(p) ^ WySecret[1], WyRead8(p + 8) ^ seed);
+                    see1 = WyMix(WyRead8(p + 16) ^ WySecret[2], WyRead8(p + 24) ^ see1);
+                    see2 = WyMix(WyRead8(p + 32) ^ WySecret[3], WyRead8(p + 40) ^ see2);
+                    p += 48;
+                    i -= 48;
+                } while (i > 48);
+                seed ^= see1 ^ see2;
+            }
+            while (i > 16)
+            {
+                seed = WyMix(WyRead8(p) ^ WySecret[1], WyRead8(p + 8) ^ seed);
+                i -= 16;
+                p += 16;
+            }
+            a = WyRead8(p + i - 16);
+            b = WyRead8(p + i - 8);
+        }
+        a ^= WySecret[1];
+        b ^= seed;
+#if defined(__SIZEOF_INT128__)
+        unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+        a = static_cast<uint64_t>(r);
+        b = static_cast<uint64_t>(r >> 64);
+#else
+        {
+            uint64_t x = a;
+            a = x * b;
+            b = WyMix(x, b) ^ a;
+        }
+#endif
+        return WyMix(a ^ WySecret[0] ^ size, b ^ WySecret[1]);
+    }
+
+    // una multiplicación de 128 bits con la llave en los dos factores: con un factor constante los bits bajos del
+    // hash dependerían sólo de los bits bajos de la llave
+    inline uint64_t HashInteger(uint64_t x)
+    {
+        return Detail::WyMix(x ^ Detail::WySecret[0], x ^ Detail::WySecret[1]);
+    }
+
+    // hasher transparente para llaves std::string : std::string_view y const char* se hashean igual que la llave, sin construirla
+    struct StringHash
+    {
+        using is_transparent = void;
+
+        inline size_t operator()(std::string_view s) const noexcept
+        {
+            return static_cast<size_t>(HashBytes(s.data(), s.size()));
+        }
+    };
+
+    // hasher / comparador por default de Dictionary, HashSet y sus backends
+    // - enteros y enums: HashInteger; std::hash es la identidad y los ids secuenciales o con bits bajos fijos
+    //   (p.ej. id << 8 | mercado) se amontonan en tablas potencia de 2 y en los shards
+    // - strings: wyhash, y libstdc++ guarda el hash en cada nodo (ver __is_fast_hash abajo) para no recalcularlo
+    //   al crecer ni al comparar llaves en la misma cubeta
+    // - lo demás: std::hash<K> (las especializaciones del usuario siguen funcionando)
+    // para usar otro hasher se cambia el backend, p.ej. Dictionary<K, V, std::unordered_map<K, V, IdentityHash<K>>>
+    template <typename K>
+    struct Hash : std::hash<K>
+    {
+    };
+
+    template <typename K>
+        requires std::is_integral<K>::value || std::is_enum<K>::value
+    struct Hash<K>
+    {
+        inline size_t operator()(K key) const noexcept
+        {
+            if constexpr (std::is_enum<K>::value)
+                return static_cast<size_t>(HashInteger(static_cast<uint64_t>(static_cast<std::underlying_type_t<K>>(key))));
+            else
+                return static_cast<size_t>(HashInteger(static_cast<uint64_t>(key)));
+        }
+    };
+
+    template <>
+    struct Hash<std::string> : StringHash
+    {
+    };
+
+    template <>
+    struct Hash<std::string_view> : StringHash
+    {
+    };
+
+    // el hasher de la biblioteca estándar, tal cual (la identidad para enteros en libstdc++), para comparar o
+    // cuando las llaves ya vienen bien repartidas
+    template <typename K>
+    struct IdentityHash : std::hash<K>
+    {
+    };
+
+    template <typename K>
+    struct Equal : std::equal_to<K>
+    {
+    };
+
+    template <>
+    struct Equal<std::string> : std::equal_to<>
+    {
+    };
+
+    // shard (potencia de 2) que le toca a un hash
+    // fibonacci hashing: std::hash es la identidad para enteros y las llaves secuenciales caerían juntas
+    inline size_t ShardIndex(size_t hash, size_t shard_count)
+    {
+        return (static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ULL >> 32) & (shard_count - 1);
+    }
+
+    // pide la línea de caché de address sin esperarla (no-op si el compilador no tiene el builtin)
+    // para búsquedas en lote: se piden todas las cubetas primero y los misses se traslapan
+    inline void Prefetch(const void *address)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address, 0, 1);
+#endif
+    }
+
+    template <typename H, typename E>
+    concept TransparentHash = requires {
+        typename H::is_transparent;
+        typename E::is_transparent;
+    };
+
+    // Q se puede buscar directo en el backend B (búsqueda heterogénea), sin convertirlo antes a la llave
+    template <typename B, typename Q>
+    concept HeterogeneousKey = TransparentHash<typename B::hasher, typename B::key_equal> &&
+                               !std::is_same<std::remove_cvref_t<Q>, typename B::key_type>::value &&
+                               requires(const typename B::hasher &h, const Q &q) { h(q); };
+} // namespace Collections
+
+#if defined(__GLIBCXX__)
+// libstdc++ guarda el hash en el nodo de std::unordered_map / set cuando el hasher no es "rápido"
+namespace std
+{
+    template <typename K>
+    struct __is_fast_hash<Collections::Hash<K>> : __is_fast_hash<std::hash<K>>
+    {
+    };
+
+    template <>
+    struct __is_fast_hash<Collections::StringHash> : std::false_type
+    {
+    };
+
+    template <>
+    struct __is_fast_hash<Collections::Hash<std::string>> : std::false_type
+    {
+    };
+
+    template <>
+    struct __is_fast_hash<Collections::Hash<std::string_view>> : std::false_type
+    {
+    };
+} // namespace std
+#endif
+
+#endif // __COLLECTIONS_HASH
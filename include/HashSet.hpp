@@ -2,69 +2,134 @@
 #define __COLLECIONS_HASHSET
 
 #include <algorithm>
+#include <iterator>
 #include <mutex>
 #include <utility>
 #include <unordered_set>
+#include <vector>
+
+#include "FrozenHashTable.hpp"
+#include "Hash.hpp"
+#include "MemoryUsage.hpp"
 
 namespace Collections
 {
-    template <typename T>
-    class HashSet : protected std::unordered_set<T>
+    // B = std::unordered_set<T> (nodos) | FlatHashSet<T> (plano, swiss-table) | std::pmr::unordered_set (ver Collections::pmr)
+    //     | cualquier set con la interfaz de std::unordered_set
+    // con el Hash/Equal default los std::string aceptan búsquedas con std::string_view y const char* sin construir el elemento
+    template <typename T, typename B = std::unordered_set<T, Hash<T>, Equal<T>>>
+    class HashSet : protected B
     {
     public:
         HashSet() = default;
-        HashSet(const std::unordered_set<T> &o) : std::unordered_set<T>(o){};
+        HashSet(const std::unordered_set<T> &o) : B(o.begin(), o.end()){};
+        explicit HashSet(const typename B::allocator_type &allocator) : B(allocator) {}
 
-        typename HashSet<T>::iterator begin()
+        typename HashSet<T, B>::iterator begin()
         {
-            return std::unordered_set<T>::begin();
+            return B::begin();
         }
 
-        typename HashSet<T>::iterator end()
+        typename HashSet<T, B>::iterator end()
         {
-            return std::unordered_set<T>::end();
+            return B::end();
         }
 
-        typename HashSet<T>::const_iterator begin() const
+        typename HashSet<T, B>::const_iterator begin() const
         {
-            return std::unordered_set<T>::begin();
+            return B::begin();
         }
 
-        typename HashSet<T>::const_iterator end() const
+        typename HashSet<T, B>::const_iterator end() const
         {
-            return std::unordered_set<T>::end();
+            return B::end();
         }
 
         inline size_t Size()
         {
-            return std::unordered_set<T>::size();
+            return B::size();
+        }
+
+        // ver Dictionary::MemoryUsage
+        inline size_t MemoryUsage(bool deep = false) const
+        {
+            const B &backend = *this;
+            return sizeof(*this) + ContainerMemoryUsage(backend) + (deep ? ElementsHeapSize(backend) : 0);
         }
 
         inline bool Any()
         {
-            return !std::unordered_set<T>::empty();
+            return !B::empty();
         }
 
         std::unordered_set<T> Clone()
         {            
-            std::unordered_set<T> cloned_set;
-            std::for_each(this->begin(), this->end(), [&cloned_set](T e) { cloned_set.insert(e); });
-            return cloned_set;
+            return std::unordered_set<T>(this->begin(), this->end());
         }
 
         inline void Insert(const T &t)
         {
-            std::unordered_set<T>::emplace(t);
+            B::emplace(t);
+        }
+
+        inline void Insert(T &&t)
+        {
+            B::emplace(std::move(t));
+        }
+
+        // construye el elemento en su lugar; regresa false si ya existía
+        template <typename... Args>
+        inline bool Emplace(Args &&...args)
+        {
+            return B::emplace(std::forward<Args>(args)...).second;
         }
 
         inline bool TryInsert(const T &t)
         {
-            return std::unordered_set<T>::insert(t).second;
+            return B::insert(t).second;
+        }
+
+        inline bool TryInsert(T &&t)
+        {
+            return B::insert(std::move(t)).second;
+        }
+
+        // el elemento sólo se construye cuando de verdad es nuevo
+        template <typename Q>
+            requires HeterogeneousKey<B, Q> && std::constructible_from<T, const Q &>
+        inline bool TryInsert(const Q &t)
+        {
+            return B::find(t) == B::end() && B::emplace(t).second;
+        }
+
+        // [first, last) con una sola reserva; true si el elemento era nuevo, en el orden del lote
+        template <typename I>
+        inline std::vector<bool> InsertRange(I first, I last)
+        {
+            std::vector<bool> result;
+            if constexpr (std::forward_iterator<I>)
+            {
+                auto n = static_cast<size_t>(std::ranges::distance(first, last));
+                result.reserve(n);
+                // reserve() de std::unordered_set puede encoger la tabla: sólo se llama si de verdad hay que crecer
+                if (B::size() + n > B::bucket_count() * B::max_load_factor())
+                    B::reserve(B::size() + n);
+            }
+            for (; first != last; ++first)
+                result.push_back(B::insert(*first).second);
+            return result;
         }
 
         inline bool Exists(const T &t)
         {
-            return std::unordered_set<T>::find(t) != std::unordered_set<T>::end();
+            return B::find(t) != B::end();
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q>
+        inline bool Exists(const Q &t)
+        {
+            return B::find(t) != B::end();
         }
 
         inline bool Contains(const T &t)
@@ -72,19 +137,55 @@ namespace Collections
             return this->Exists(t);
         }
 
+        template <typename Q>
+            requires HeterogeneousKey<B, Q>
+        inline bool Contains(const Q &t)
+        {
+            return this->Exists(t);
+        }
+
         inline void Remove(const T &t)
         {
-            std::unordered_set<T>::erase(t);
+            B::erase(t);
         }
 
         inline bool TryRemove(const T &t)
         {
-            return std::unordered_set<T>::erase(t) > 0;
+            return B::erase(t) > 0;
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q>
+        inline bool TryRemove(const Q &t)
+        {
+            if (auto result = B::find(t); result != B::end())
+            {
+                B::erase(result);
+                return true;
+            }
+            return false;
         }
 
         inline void Clear()
         {
-            std::unordered_set<T>::clear();
+            B::clear();
+        }
+
+        // copia de sólo lectura con hash perfecto mínimo (ver FrozenHashTable)
+        inline FrozenHashSet<T, typename B::hasher, typename B::key_equal> Freeze() const
+        {
+            return FrozenHashSet<T, typename B::hasher, typename B::key_equal>(this->begin(), this->end());
+        }
+
+        // snapshot en disco con el layout de Freeze() (ver MappedSnapshot.hpp); T trivialmente copiable
+        inline void SaveSnapshot(const std::string &path) const
+        {
+            this->Freeze().SaveSnapshot(path);
+        }
+
+        static FrozenHashSet<T, typename B::hasher, typename B::key_equal> MapSnapshot(const std::string &path, bool verify = false)
+        {
+            return FrozenHashSet<T, typename B::hasher, typename B::key_equal>::MapSnapshot(path, verify);
         }
 
         template <typename F>
@@ -94,6 +195,17 @@ namespace Collections
         }
     };
 
+    namespace pmr
+    {
+        template <typename T>
+        using HashSet = Collections::HashSet<T, std::pmr::unordered_set<T, Hash<T>, Equal<T>>>;
+    } // namespace pmr
+
+    namespace counted
+    {
+        template <typename T>
+        using HashSet = Collections::HashSet<T, std::unordered_set<T, Hash<T>, Equal<T>, CountingAllocator<T>>>;
+    } // namespace counted
 }
 
 #endif // __COLLECIONS_HASHSET
@@ -0,0 +1,399 @@
+#ifndef __COLLECTIONS_INCREMENTAL_HASH_MAP
+#define __COLLECTIONS_INCREMENTAL_HASH_MAP
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include "Hash.hpp"
+#include "MemoryUsage.hpp"
+
+namespace Collections
+{
+
+    // Backend para Dictionary (interfaz de std::unordered_map) que crece sin rehash de golpe
+    // - al llenarse, la tabla actual pasa a ser la vieja y se abre una nueva del doble; cada inserción posterior mueve
+    //   unos cuantos nodos de la vieja a la nueva (extract/insert de nodos: sin copias ni allocations) hasta vaciarla
+    // - el costo de crecer se reparte entre las inserciones: al cruzar el load factor sólo se reserva el arreglo de
+    //   cubetas nuevo, en vez de recorrer y reubicar millones de nodos dentro de un solo TryAdd
+    // - mientras dura la migración una búsqueda fallida revisa las dos tablas
+    // - las búsquedas nunca migran (son seguras bajo ReadLock con std::shared_mutex); sólo las inserciones lo hacen
+    template <typename K, typename V, typename H = Hash<K>, typename E = Equal<K>, typename A = std::allocator<std::pair<const K, V>>>
+    class IncrementalHashMap
+    {
+        using Table = std::unordered_map<K, V, H, E, A>;
+
+        // nodos migrados por inserción: con 2 la tabla vieja se vacía antes de que la nueva vuelva a llenarse
+        static constexpr size_t MigrationStep = 2;
+
+        Table current, old;
+
+        template <bool Const>
+        class Iterator
+        {
+            friend class IncrementalHashMap;
+            template <bool>
+            friend class Iterator;
+            using Owner = std::conditional_t<Const, const IncrementalHashMap, IncrementalHashMap>;
+            using TableIterator = std::conditional_t<Const, typename Table::const_iterator, typename Table::iterator>;
+
+            Owner *map = nullptr;
+            TableIterator it;
+            bool in_old = false;
+
+            // al terminar la tabla actual sigue con la vieja
+            inline void Normalize()
+            {
+                if (!this->in_old && this->it == this->map->current.end())
+                {
+                    this->in_old = true;
+                    this->it = this->map->old.begin();
+                }
+            }
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = typename Table::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<Const, const value_type *, value_type *>;
+            using reference = std::conditional_t<Const, const value_type &, value_type &>;
+
+            Iterator() = default;
+            Iterator(Owner *map, TableIterator it, bool in_old) : map(map), it(it), in_old(in_old)
+            {
+                this->Normalize();
+            }
+
+            // iterator -> const_iterator
+            template <bool C = Const>
+                requires C
+            Iterator(const Iterator<false> &o) : map(o.map), it(o.it), in_old(o.in_old)
+            {
+            }
+
+            inline reference operator*() const
+            {
+                return *this->it;
+            }
+
+            inline pointer operator->() const
+            {
+                return &*this->it;
+            }
+
+            inline Iterator &operator++()
+            {
+                ++this->it;
+                this->Normalize();
+                return *this;
+            }
+
+            inline Iterator operator++(int)
+            {
+                auto result = *this;
+                ++*this;
+                return result;
+            }
+
+            inline bool operator==(const Iterator &o) const
+            {
+                return this->in_old == o.in_old && this->it == o.it;
+            }
+        };
+
+        // mueve hasta n nodos de la tabla vieja a la actual (la actual ya tiene cubetas para todos)
+        inline void Migrate(size_t n)
+        {
+            if (this->old.empty())
+                return;
+            for (; n && !this->old.empty(); --n)
+                this->current.insert(this->old.extract(this->old.begin()));
+            // ya vacía: se liberan sus cubetas
+            if (this->old.empty())
+                this->old.rehash(0);
+        }
+
+        // se llama antes de insertar una llave nueva
+        inline void PrepareInsert()
+        {
+            this->Migrate(MigrationStep);
+
+            // un poco antes que la tabla misma, para que la inserción nunca dispare su rehash completo
+            if (this->current.size() + 1 >= this->current.bucket_count() * this->current.max_load_factor())
+            {
+                this->Migrate(this->old.size());
+                this->old.swap(this->current);
+                // la actual quedó vacía: reservar sólo aloca cubetas, no recorre nodos
+                this->current.max_load_factor(this->old.max_load_factor());
+                this->current.reserve(std::max<size_t>(2 * this->old.size(), 16));
+            }
+        }
+
+        // si la llave sigue en la tabla vieja la mueve a la actual
+        template <typename Q>
+        inline typename Table::iterator Promote(const Q &key)
+        {
+            if (this->old.empty())
+                return this->current.end();
+            if (auto found = this->old.find(key); found != this->old.end())
+                return this->current.insert(this->old.extract(found)).position;
+            return this->current.end();
+        }
+
+    public:
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = typename Table::value_type;
+        using size_type = size_t;
+        using hasher = H;
+        using key_equal = E;
+        using allocator_type = A;
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        IncrementalHashMap() = default;
+        explicit IncrementalHashMap(const A &allocator) : current(allocator), old(allocator) {}
+
+        template <typename I>
+        IncrementalHashMap(I first, I last)
+        {
+            for (; first != last; ++first)
+                this->insert(*first);
+        }
+
+        iterator begin()
+        {
+            return iterator(this, this->current.begin(), false);
+        }
+
+        iterator end()
+        {
+            return iterator(this, this->old.end(), true);
+        }
+
+        const_iterator begin() const
+        {
+            return const_iterator(this, this->current.begin(), false);
+        }
+
+        const_iterator end() const
+        {
+            return const_iterator(this, this->old.end(), true);
+        }
+
+        const_iterator cbegin() const
+        {
+            return this->begin();
+        }
+
+        const_iterator cend() const
+        {
+            return this->end();
+        }
+
+        inline size_t size() const
+        {
+            return this->current.size() + this->old.size();
+        }
+
+        inline bool empty() const
+        {
+            return this->current.empty() && this->old.empty();
+        }
+
+        // true mientras quedan nodos por migrar
+        inline bool migrating() const
+        {
+            return !this->old.empty();
+        }
+
+        template <typename Q>
+        inline iterator find(const Q &key)
+        {
+            if (auto found = this->current.find(key); found != this->current.end())
+                return iterator(this, found, false);
+            return iterator(this, this->old.find(key), true);
+        }
+
+        template <typename Q>
+        inline const_iterator find(const Q &key) const
+        {
+            if (auto found = this->current.find(key); found != this->current.end())
+                return const_iterator(this, found, false);
+            return const_iterator(this, this->old.find(key), true);
+        }
+
+        inline iterator find(const K &key)
+        {
+            return this->find<K>(key);
+        }
+
+        inline const_iterator find(const K &key) const
+        {
+            return this->find<K>(key);
+        }
+
+        template <typename Q>
+        inline size_t count(const Q &key) const
+        {
+            return this->find(key) != this->end();
+        }
+
+        template <typename Q>
+        inline bool contains(const Q &key) const
+        {
+            return this->find(key) != this->end();
+        }
+
+        template <typename Kx, typename... Args>
+        inline std::pair<iterator, bool> try_emplace(Kx &&key, Args &&...args)
+        {
+            if (auto found = this->current.find(key); found != this->current.end())
+                return {iterator(this, found, false), false};
+            if (auto found = this->Promote(key); found != this->current.end())
+                return {iterator(this, found, false), false};
+
+            this->PrepareInsert();
+            auto result = this->current.try_emplace(std::forward<Kx>(key), std::forward<Args>(args)...);
+            return {iterator(this, result.first, false), result.second};
+        }
+
+        template <typename Kx, typename M>
+        inline std::pair<iterator, bool> insert_or_assign(Kx &&key, M &&value)
+        {
+            auto result = this->try_emplace(std::forward<Kx>(key), std::forward<M>(value));
+            if (!result.second)
+                result.first->second = std::forward<M>(value);
+            return result;
+        }
+
+        template <typename Kx, typename Vx>
+        inline std::pair<iterator, bool> emplace(Kx &&key, Vx &&value)
+        {
+            return this->try_emplace(std::forward<Kx>(key), std::forward<Vx>(value));
+        }
+
+        inline std::pair<iterator, bool> insert(const value_type &value)
+        {
+            return this->try_emplace(value.first, value.second);
+        }
+
+        inline std::pair<iterator, bool> insert(value_type &&value)
+        {
+            return this->try_emplace(value.first, std::move(value.second));
+        }
+
+        inline V &operator[](const K &key)
+        {
+            return this->try_emplace(key).first->second;
+        }
+
+        inline V &operator[](K &&key)
+        {
+            return this->try_emplace(std::move(key)).first->second;
+        }
+
+        inline V &at(const K &key)
+        {
+            if (auto found = this->find(key); found != this->end())
+                return found->second;
+            throw std::out_of_range("IncrementalHashMap::at");
+        }
+
+        template <typename Q>
+        inline size_t erase(const Q &key)
+        {
+            if (auto found = this->find(key); found != this->end())
+            {
+                this->erase(found);
+                return 1;
+            }
+            return 0;
+        }
+
+        inline size_t erase(const K &key)
+        {
+            return this->erase<K>(key);
+        }
+
+        inline iterator erase(const_iterator position)
+        {
+            if (position.in_old)
+                return iterator(this, this->old.erase(position.it), true);
+            return iterator(this, this->current.erase(position.it), false);
+        }
+
+        inline iterator erase(iterator position)
+        {
+            return this->erase(const_iterator(position));
+        }
+
+        inline void clear()
+        {
+            this->current.clear();
+            this->old.clear();
+        }
+
+        // reserve / rehash explícitos terminan la migración y sí reubican todo de golpe
+        inline void reserve(size_t n)
+        {
+            this->Migrate(this->old.size());
+            this->current.reserve(n);
+        }
+
+        inline void rehash(size_t n)
+        {
+            this->Migrate(this->old.size());
+            this->current.rehash(n);
+        }
+
+        // cubetas de la tabla actual, que ya tiene lugar para todas las llaves (también las que faltan por migrar)
+        inline size_t bucket_count() const
+        {
+            return this->current.bucket_count();
+        }
+
+        // las dos tablas mientras dura la migración (ver ContainerMemoryUsage)
+        inline size_t memory_usage() const
+        {
+            return ContainerMemoryUsage(this->current) + ContainerMemoryUsage(this->old);
+        }
+
+        inline float load_factor() const
+        {
+            return static_cast<float>(this->size()) / static_cast<float>(this->bucket_count());
+        }
+
+        inline float max_load_factor() const
+        {
+            return this->current.max_load_factor();
+        }
+
+        inline void max_load_factor(float ml)
+        {
+            this->current.max_load_factor(ml);
+            this->old.max_load_factor(ml);
+        }
+
+        inline hasher hash_function() const
+        {
+            return this->current.hash_function();
+        }
+
+        inline key_equal key_eq() const
+        {
+            return this->current.key_eq();
+        }
+
+        inline allocator_type get_allocator() const
+        {
+            return this->current.get_allocator();
+        }
+    };
+} // namespace Collections
+
+#endif // __COLLECTIONS_INCREMENTAL_HASH_MAP
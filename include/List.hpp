@@ -3,73 +3,88 @@
 
 #include <algorithm>
 #include <functional>
+#include <memory>
+#include <memory_resource>
 #include <mutex>
 #include <optional>
+#include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "MappedSnapshot.hpp"
+#include "MemoryUsage.hpp"
+
 namespace Collections
 {
 
-    template <typename V>
-    class List : protected std::vector<V>
+    // A = std::allocator<V> | std::pmr::polymorphic_allocator<V> (ver Collections::pmr) | propietario
+    template <typename V, typename A = std::allocator<V>>
+    class List : protected std::vector<V, A>
     {
     public:
     
         List() = default ;
-        List(const std::vector<V> &o) : std::vector<V>(o) {} ;
+        List(const std::vector<V> &o) : std::vector<V, A>(o.begin(), o.end()) {} ;
+        explicit List(const A &allocator) : std::vector<V, A>(allocator) {}
 
         // el operador[] insertará el valor por default en primitivas en donde exista default, de lo contrario, usar GetOrAdd
         inline V &operator[](int i)
         {
-            return std::vector<V>::operator[](i);
+            return std::vector<V, A>::operator[](i);
         }
 
         // el operador[] insertará el valor por default en primitivas en donde exista default, de lo contrario, usar GetOrAdd
         const inline V &operator[](int i) const
         {
-            return std::vector<V>::operator[](i);
+            return std::vector<V, A>::operator[](i);
         }
 
-        typename List<V>::iterator begin()
+        typename List<V, A>::iterator begin()
         {
-            return std::vector<V>::begin();
+            return std::vector<V, A>::begin();
         }
 
-        typename List<V>::iterator end()
+        typename List<V, A>::iterator end()
         {
-            return std::vector<V>::end();
+            return std::vector<V, A>::end();
         }
 
-        typename List<V>::const_iterator begin() const
+        typename List<V, A>::const_iterator begin() const
         {
-            return std::vector<V>::begin();
+            return std::vector<V, A>::begin();
         }
 
-        typename List<V>::const_iterator end() const
+        typename List<V, A>::const_iterator end() const
         {
-            return std::vector<V>::end();
+            return std::vector<V, A>::end();
         }
 
         inline bool Any()
         {
-            return !std::vector<V>::empty();
+            return !std::vector<V, A>::empty();
         }
 
         inline size_t Size()
         {
-            return std::vector<V>::size();
+            return std::vector<V, A>::size();
+        }
+
+        // ver Dictionary::MemoryUsage; cuenta la capacidad reservada, no sólo Size()
+        inline size_t MemoryUsage(bool deep = false) const
+        {
+            const std::vector<V, A> &vector = *this;
+            return sizeof(*this) + ContainerMemoryUsage(vector) + (deep ? ElementsHeapSize(vector) : 0);
         }
 
         inline void Clear()
         {
-            return std::vector<V>::clear();
+            return std::vector<V, A>::clear();
         }
 
         inline void Remove(int i)
         {
-            std::vector<V>::erase(std::vector<V>::begin() + i);
+            std::vector<V, A>::erase(std::vector<V, A>::begin() + i);
         }
 
         inline void Add(const V &value)
@@ -77,21 +92,38 @@ namespace Collections
             this->Push(value);
         }
 
+        inline void Add(V &&value)
+        {
+            this->Push(std::move(value));
+        }
+
         inline void Push(const V &value)
         {
-            std::vector<V>::emplace_back(value);
+            std::vector<V, A>::emplace_back(value);
+        }
+
+        inline void Push(V &&value)
+        {
+            std::vector<V, A>::emplace_back(std::move(value));
+        }
+
+        // construye el elemento directamente al final de la lista
+        template <typename... Args>
+        inline V &Emplace(Args &&...args)
+        {
+            return std::vector<V, A>::emplace_back(std::forward<Args>(args)...);
         }
 
         inline bool Contains(const V &t)
         {
-            return std::find(std::vector<V>::begin(), std::vector<V>::end(), t) != std::vector<V>::end();
+            return std::find(std::vector<V, A>::begin(), std::vector<V, A>::end(), t) != std::vector<V, A>::end();
         }
 
         inline bool Pop(V& value)
         {
-            if (!std::vector<V>::empty()) {
-                value = std::vector<V>::back();
-                std::vector<V>::pop_back();
+            if (!std::vector<V, A>::empty()) {
+                value = std::move(std::vector<V, A>::back());
+                std::vector<V, A>::pop_back();
                 return true;
             } else {
                 return false;
@@ -100,8 +132,11 @@ namespace Collections
 
         inline std::optional<V> Pop()
         {                        
-            V value;
-            return this->Pop(value) ? std::optional<V>(value) : std::nullopt;
+            if (std::vector<V, A>::empty())
+                return std::nullopt;
+            std::optional<V> value(std::move(std::vector<V, A>::back()));
+            std::vector<V, A>::pop_back();
+            return value;
         }
 
         template <typename F>
@@ -110,6 +145,17 @@ namespace Collections
             std::transform(this->begin(), this->end(), this->begin(), action);
         }
 
+        // snapshot en disco con el mismo layout del arreglo (ver MappedSnapshot.hpp); V trivialmente copiable
+        inline void SaveSnapshot(const std::string &path) const
+        {
+            WriteSnapshot<V, void>(path, SnapshotKind::List, std::vector<V, A>::data(), std::vector<V, A>::size(), nullptr, 0, 0);
+        }
+
+        static MappedList<V> MapSnapshot(const std::string &path, bool verify = false)
+        {
+            return MappedList<V>::Map(path, verify);
+        }
+
         void FromVector(const std::vector<V> &vector)
         {
             this->Clear();
@@ -119,6 +165,18 @@ namespace Collections
             }
         }
     };
+
+    namespace pmr
+    {
+        template <typename V>
+        using List = Collections::List<V, std::pmr::polymorphic_allocator<V>>;
+    } // namespace pmr
+
+    namespace counted
+    {
+        template <typename V>
+        using List = Collections::List<V, CountingAllocator<V>>;
+    } // namespace counted
 } // namespace Collections
 
 #endif // __COLLECTIONS_DICTIONARY
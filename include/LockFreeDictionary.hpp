@@ -0,0 +1,470 @@
+#ifndef __COLLECTIONS_LOCK_FREE_DICTIONARY
+#define __COLLECTIONS_LOCK_FREE_DICTIONARY
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "MemoryUsage.hpp"
+
+namespace Collections
+{
+
+    // Diccionario sin locks (open addressing con slots atómicos, linear probing) para llaves enteras o apuntadores
+    // - las lecturas no escriben memoria compartida; con V atómico tampoco esperan a nadie (ver abajo el seqlock)
+    // - la capacidad es fija (se redondea a potencia de 2): dimensionar ~2x las llaves distintas esperadas
+    // - una llave, una vez reclamada, se queda en su slot aunque se remueva (se marca el valor como vacío), así que la
+    //   capacidad se consume por llaves distintas alguna vez insertadas, no por las presentes
+    // - EmptyKey (default K{}) queda reservada: no se puede usar como llave
+    // - V entero, enum o apuntador: el valor es un std::atomic<V> y V{} queda reservado (no se puede usar como valor)
+    // - la llave o el valor reservados, o una llave nueva con la tabla llena: los Try* regresan false y los que no
+    //   pueden reportarlo (Add, GetOrAdd, AddOrUpdate) lanzan std::invalid_argument / std::length_error
+    // - V cualquier otro trivialmente copiable (p.ej. struct Quote): el valor vive en un seqlock, ver SeqlockSlot;
+    //   las lecturas copian optimistas sin tocar la línea del slot y reintentan si un escritor pasó a la mitad, así
+    //   que una lectura de esa llave espera (yield) mientras haya un escritor a la mitad: uno suspendido ahí la detiene;
+    //   las demás llaves no se enteran
+    template <typename K, typename V, K EmptyKey = K{}>
+    class LockFreeDictionary
+    {
+        static_assert(std::is_integral<K>::value || std::is_pointer<K>::value, "K must be integral or pointer");
+        static_assert(std::atomic<K>::is_always_lock_free, "K must be a lock free atomic");
+        static_assert(std::is_trivially_copyable<V>::value, "V must be trivially copyable");
+
+        // un escalar que cabe en un atómico sin lock: un CAS publica el valor completo
+        struct AtomicSlot
+        {
+            static constexpr V NullValue = V{};
+
+            std::atomic<K> key{EmptyKey};
+            std::atomic<V> value{NullValue};
+
+            static inline bool Storable(const V &value)
+            {
+                return value != NullValue;
+            }
+
+            inline std::optional<V> Load() const
+            {
+                if (auto found = this->value.load(std::memory_order_acquire); found != NullValue)
+                    return found;
+                return std::nullopt;
+            }
+
+            // regresa el valor que ya estaba, o nada si se insertó
+            inline std::optional<V> Insert(const V &value)
+            {
+                if (V expected = NullValue; !this->value.compare_exchange_strong(expected, value, std::memory_order_acq_rel))
+                    return expected;
+                return std::nullopt;
+            }
+
+            // true si el slot estaba vacío
+            inline bool Exchange(const V &value)
+            {
+                return this->value.exchange(value, std::memory_order_acq_rel) == NullValue;
+            }
+
+            inline std::optional<V> Take()
+            {
+                if (auto old = this->value.exchange(NullValue, std::memory_order_acq_rel); old != NullValue)
+                    return old;
+                return std::nullopt;
+            }
+
+            // publica next(actual o nullptr) con CAS, reintentando con contención; true si el slot estaba vacío
+            template <typename F>
+            inline bool Update(const F &next)
+            {
+                for (auto current = this->value.load(std::memory_order_acquire);;)
+                {
+                    V value = current == NullValue ? next(nullptr) : next(&current);
+                    if (value == NullValue)
+                        throw std::invalid_argument("LockFreeDictionary: reserved value");
+                    if (this->value.compare_exchange_weak(current, value, std::memory_order_acq_rel))
+                        return current == NullValue;
+                }
+            }
+        };
+
+        // seqlock por slot: version impar = un escritor a la mitad
+        // - los lectores copian los words con cargas relajadas y validan que version no cambió (no escriben nada)
+        // - los escritores toman el slot con un CAS de version par -> impar, así que dos escritores de la misma llave se
+        //   excluyen y uno que leyó una versión vieja reintenta (mismas reglas que el CAS de AtomicSlot)
+        // un slot por línea de caché: escribir una llave no invalida las lecturas de las vecinas
+        struct alignas(64) SeqlockSlot
+        {
+            static constexpr size_t Words = (sizeof(V) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+            struct Copy
+            {
+                std::array<uint64_t, Words> words;
+                bool present;
+
+                inline V Value() const
+                {
+                    std::array<unsigned char, sizeof(V)> bytes;
+                    std::memcpy(bytes.data(), this->words.data(), sizeof(V));
+                    return std::bit_cast<V>(bytes);
+                }
+            };
+
+            std::atomic<K> key{EmptyKey};
+            std::atomic<uint64_t> version{0};
+            std::atomic<bool> present{false};
+            std::array<std::atomic<uint64_t>, Words> words{};
+
+            static inline bool Storable(const V &)
+            {
+                return true;
+            }
+
+            // copia consistente del slot y la versión (par) con la que se leyó; espera mientras version sea impar
+            inline uint64_t Read(Copy &copy) const
+            {
+                for (;;)
+                {
+                    auto seen = this->version.load(std::memory_order_acquire);
+                    if (seen & 1)
+                    {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    copy.present = this->present.load(std::memory_order_relaxed);
+                    for (size_t i = 0; i < Words; ++i)
+                        copy.words[i] = this->words[i].load(std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (this->version.load(std::memory_order_relaxed) == seen)
+                        return seen;
+                }
+            }
+
+            // publica value (nullptr = vacío) si nadie escribió desde la versión `seen`
+            inline bool TryWrite(uint64_t seen, const V *value)
+            {
+                if (!this->version.compare_exchange_strong(seen, seen + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                    return false;
+                std::atomic_thread_fence(std::memory_order_release);
+                this->present.store(value != nullptr, std::memory_order_relaxed);
+                if (value)
+                {
+                    std::array<uint64_t, Words> words{};
+                    std::memcpy(words.data(), value, sizeof(V));
+                    for (size_t i = 0; i < Words; ++i)
+                        this->words[i].store(words[i], std::memory_order_relaxed);
+                }
+                this->version.store(seen + 2, std::memory_order_release);
+                return true;
+            }
+
+            inline std::optional<V> Load() const
+            {
+                Copy copy;
+                this->Read(copy);
+                if (copy.present)
+                    return copy.Value();
+                return std::nullopt;
+            }
+
+            inline std::optional<V> Insert(const V &value)
+            {
+                for (Copy copy;;)
+                {
+                    auto seen = this->Read(copy);
+                    if (copy.present)
+                        return copy.Value();
+                    if (this->TryWrite(seen, &value))
+                        return std::nullopt;
+                }
+            }
+
+            inline bool Exchange(const V &value)
+            {
+                for (Copy copy;;)
+                {
+                    if (auto seen = this->Read(copy); this->TryWrite(seen, &value))
+                        return !copy.present;
+                }
+            }
+
+            inline std::optional<V> Take()
+            {
+                for (Copy copy;;)
+                {
+                    auto seen = this->Read(copy);
+                    if (!copy.present)
+                        return std::nullopt;
+                    if (this->TryWrite(seen, nullptr))
+                        return copy.Value();
+                }
+            }
+
+            template <typename F>
+            inline bool Update(const F &next)
+            {
+                for (Copy copy;;)
+                {
+                    auto seen = this->Read(copy);
+                    std::optional<V> current;
+                    if (copy.present)
+                        current = copy.Value();
+                    V value = next(current ? &*current : nullptr);
+                    if (this->TryWrite(seen, &value))
+                        return !copy.present;
+                }
+            }
+        };
+
+        using Slot = std::conditional_t<(std::is_integral<V>::value || std::is_pointer<V>::value || std::is_enum<V>::value) && std::atomic<V>::is_always_lock_free,
+                                        AtomicSlot, SeqlockSlot>;
+
+        std::unique_ptr<Slot[]> slots;
+        size_t mask;
+        std::atomic<size_t> count{0};
+
+        static inline size_t Hash(K key)
+        {
+            // fmix64 de murmur3: las llaves secuenciales (ids de órdenes) se dispersan por toda la tabla
+            uint64_t h;
+            if constexpr (std::is_pointer<K>::value)
+                h = reinterpret_cast<uintptr_t>(key);
+            else
+                h = static_cast<uint64_t>(key);
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+            return static_cast<size_t>(h);
+        }
+
+        // regresa el slot de la llave o nullptr; si claim, reclama un slot vacío para la llave
+        // EmptyKey nunca se encuentra ni se reclama: reclamarla dejaría el slot libre para la siguiente llave
+        inline Slot *Find(K key, bool claim) const
+        {
+            if (key == EmptyKey)
+                return nullptr;
+            for (size_t i = Hash(key) & this->mask, n = 0; n <= this->mask; i = (i + 1) & this->mask, ++n)
+            {
+                auto &slot = this->slots[i];
+                auto found = slot.key.load(std::memory_order_acquire);
+                if (found == key)
+                    return &slot;
+
+                if (found == EmptyKey)
+                {
+                    if (!claim)
+                        return nullptr;
+
+                    // si otro thread ganó el slot con la misma llave también nos sirve
+                    if (slot.key.compare_exchange_strong(found, key, std::memory_order_acq_rel) || found == key)
+                        return &slot;
+                }
+            }
+            return nullptr; // tabla llena
+        }
+
+        // para los que no pueden regresar false: Add, GetOrAdd, AddOrUpdate
+        inline Slot &Claim(K key) const
+        {
+            if (key == EmptyKey)
+                throw std::invalid_argument("LockFreeDictionary: reserved key");
+            auto slot = this->Find(key, true);
+            if (!slot)
+                throw std::length_error("LockFreeDictionary: table full");
+            return *slot;
+        }
+
+        static inline void CheckStorable(const V &value)
+        {
+            if (!Slot::Storable(value))
+                throw std::invalid_argument("LockFreeDictionary: reserved value");
+        }
+
+    public:
+        explicit LockFreeDictionary(size_t capacity = 1024)
+            : slots(new Slot[std::bit_ceil(std::max<size_t>(capacity, 2))]), mask(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1)
+        {
+        }
+
+        inline size_t Capacity() const
+        {
+            return this->mask + 1;
+        }
+
+        inline size_t Size() const
+        {
+            return this->count.load(std::memory_order_relaxed);
+        }
+
+        inline bool Any() const
+        {
+            return this->Size() != 0;
+        }
+
+        // ver Dictionary::MemoryUsage; la tabla es fija, no depende de cuántas llaves hay
+        inline size_t MemoryUsage(bool deep = false) const
+        {
+            size_t result = sizeof(*this) + AllocationSize((this->mask + 1) * sizeof(Slot));
+            if (deep)
+                this->ForEach([&result](K key, const V &value)
+                              { result += HeapSizeOf(key) + HeapSizeOf(value); });
+            return result;
+        }
+
+        inline bool ContainsKey(K key) const
+        {
+            auto slot = this->Find(key, false);
+            return slot && slot->Load();
+        }
+
+        inline bool TryGetValue(K key, V &value) const
+        {
+            if (auto slot = this->Find(key, false); slot)
+            {
+                if (auto found = slot->Load())
+                {
+                    value = *found;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        template <typename F>
+        inline bool TryGetValueExec(K key, const F &action) const
+        {
+            if (auto slot = this->Find(key, false); slot)
+            {
+                if (auto found = slot->Load())
+                {
+                    action(*found);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // regresa false si ya existía la llave, si la tabla está llena o si la llave o el valor son los reservados
+        inline bool TryAdd(K key, V value)
+        {
+            if (!Slot::Storable(value))
+                return false;
+            if (auto slot = this->Find(key, true); slot && !slot->Insert(value))
+            {
+                this->count.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            return false;
+        }
+
+        // regresa true si la llave es nueva (igual que insert_or_assign)
+        inline bool Add(K key, V value)
+        {
+            CheckStorable(value);
+            if (this->Claim(key).Exchange(value))
+            {
+                this->count.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            return false;
+        }
+
+        inline bool TryRemove(K key, V &value)
+        {
+            if (auto slot = this->Find(key, false); slot)
+            {
+                if (auto old = slot->Take())
+                {
+                    this->count.fetch_sub(1, std::memory_order_relaxed);
+                    value = *old;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        inline bool TryRemove(K key)
+        {
+            if (auto slot = this->Find(key, false); slot && slot->Take())
+            {
+                this->count.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+            return false;
+        }
+
+        // ojo : con contención add() puede ejecutarse y descartarse, debe ser barato y sin efectos secundarios
+        inline V GetOrAdd(K key, const std::function<V()> &add)
+        {
+            auto &slot = this->Claim(key);
+
+            if (auto found = slot.Load())
+                return *found;
+
+            V value = add();
+            CheckStorable(value);
+            if (auto existing = slot.Insert(value))
+                return *existing; // otro thread lo agregó primero
+            this->count.fetch_add(1, std::memory_order_relaxed);
+            return value;
+        }
+
+        // update trabaja sobre una copia que se publica con CAS; con contención add()/update() pueden reintentarse
+        inline void AddOrUpdate(K key, const std::function<V()> &add, const std::function<void(V &)> &update)
+        {
+            if (this->Claim(key).Update([&](const V *current)
+                             {
+                if (!current)
+                    return add();
+                V value = *current;
+                update(value);
+                return value; }))
+                this->count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // recorrido débilmente consistente: ve las llaves presentes al momento de pasar por su slot
+        template <typename F>
+        void ForEach(const F &action) const
+        {
+            for (size_t i = 0; i <= this->mask; ++i)
+            {
+                auto key = this->slots[i].key.load(std::memory_order_acquire);
+                if (key == EmptyKey)
+                    continue;
+                if (auto value = this->slots[i].Load())
+                    action(key, *value);
+            }
+        }
+
+        inline std::vector<K> Keys() const
+        {
+            std::vector<K> result;
+            result.reserve(this->Size());
+            this->ForEach([&result](K key, V)
+                          { result.push_back(key); });
+            return result;
+        }
+
+        // vacía los valores; los slots se quedan reservados para sus llaves
+        inline void Clear()
+        {
+            for (size_t i = 0; i <= this->mask; ++i)
+            {
+                if (this->slots[i].Take())
+                    this->count.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+    };
+} // namespace Collections
+
+#endif // __COLLECTIONS_LOCK_FREE_DICTIONARY
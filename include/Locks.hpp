@@ -0,0 +1,330 @@
+#ifndef __COLLECTIONS_LOCKS
+#define __COLLECTIONS_LOCKS
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Collections
+{
+    // cualquier mutex con lock_shared (std::shared_mutex, std::shared_timed_mutex, ...) permite lectores simultáneos
+    template <typename M>
+    concept SharedLockable = requires(M &m) {
+        m.lock_shared();
+        m.unlock_shared();
+    };
+
+    // estadísticas de un lock (ver InstrumentedMutex)
+    struct LockStats
+    {
+        // histogramas log2 en nanosegundos: la cubeta i cuenta las esperas / retenciones en [2^i, 2^(i+1)) ns
+        static constexpr size_t Buckets = 40;
+
+        uint64_t acquisitions = 0;
+        // adquisiciones que encontraron el lock tomado y tuvieron que esperar
+        uint64_t contended = 0;
+        std::array<uint64_t, Buckets> wait{};
+        std::array<uint64_t, Buckets> hold{};
+        // (método, adquisiciones) de más a menos
+        std::vector<std::pair<std::string, uint64_t>> callers;
+
+        inline double ContentionRatio() const
+        {
+            return this->acquisitions ? static_cast<double>(this->contended) / static_cast<double>(this->acquisitions) : 0.0;
+        }
+
+        // cota superior en ns del percentil p (0..1) del histograma
+        static inline uint64_t Percentile(const std::array<uint64_t, Buckets> &histogram, double p)
+        {
+            uint64_t total = 0;
+            for (auto count : histogram)
+                total += count;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < Buckets; ++i)
+            {
+                seen += histogram[i];
+                if (seen && static_cast<double>(seen) >= p * static_cast<double>(total))
+                    return uint64_t(1) << (i + 1);
+            }
+            return 0;
+        }
+
+        inline uint64_t WaitPercentile(double p) const
+        {
+            return Percentile(this->wait, p);
+        }
+
+        inline uint64_t HoldPercentile(double p) const
+        {
+            return Percentile(this->hold, p);
+        }
+
+        inline LockStats &operator+=(const LockStats &o)
+        {
+            this->acquisitions += o.acquisitions;
+            this->contended += o.contended;
+            for (size_t i = 0; i < Buckets; ++i)
+            {
+                this->wait[i] += o.wait[i];
+                this->hold[i] += o.hold[i];
+            }
+            for (auto &[name, count] : o.callers)
+            {
+                auto found = std::find_if(this->callers.begin(), this->callers.end(), [&](auto &caller)
+                                          { return caller.first == name; });
+                if (found == this->callers.end())
+                    this->callers.emplace_back(name, count);
+                else
+                    found->second += count;
+            }
+            std::sort(this->callers.begin(), this->callers.end(), [](auto &a, auto &b)
+                      { return a.second > b.second; });
+            return *this;
+        }
+    };
+
+    // mutex que mide sus adquisiciones, contención, tiempos de espera y de retención y quién lo pide,
+    // para encontrar el lock caliente sin perf. Se usa como M de los Concurrent* (o como default con COLLECTIONS_LOCK_STATS)
+    // - los contadores son atómicos relajados: medir no agrega otro lock
+    // - el que llama es la función que construye el ReadLock / WriteLock (std::source_location); lock() directo,
+    //   p.ej. desde std::lock_guard, cuenta como "?"
+    // M = std::mutex | std::shared_mutex | cualquier mutex con try_lock
+    template <typename M = std::mutex>
+    class InstrumentedMutex
+    {
+        static constexpr size_t CallerSlots = 64;
+
+        M mutex;
+        std::atomic<uint64_t> acquisitions = 0, contended = 0;
+        std::array<std::atomic<uint64_t>, LockStats::Buckets> wait{}, hold{};
+        // tabla abierta por apuntador a function_name (estático): sin reservar memoria ni lock al contar
+        std::array<std::atomic<const char *>, CallerSlots> caller_names{};
+        std::array<std::atomic<uint64_t>, CallerSlots> caller_counts{};
+        // inicio de la retención exclusiva actual: sólo la escribe quien tiene el lock
+        uint64_t exclusive_since = 0;
+
+        static inline uint64_t Now()
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        static inline void Record(std::array<std::atomic<uint64_t>, LockStats::Buckets> &histogram, uint64_t nanos)
+        {
+            histogram[std::min<size_t>(nanos ? std::bit_width(nanos) - 1 : 0, LockStats::Buckets - 1)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        inline void Count(const char *caller)
+        {
+            this->acquisitions.fetch_add(1, std::memory_order_relaxed);
+            auto slot = (reinterpret_cast<uintptr_t>(caller) >> 4) % CallerSlots;
+            for (size_t probe = 0; probe < CallerSlots; ++probe, slot = (slot + 1) % CallerSlots)
+            {
+                auto name = this->caller_names[slot].load(std::memory_order_acquire);
+                if (!name && this->caller_names[slot].compare_exchange_strong(name, caller, std::memory_order_acq_rel))
+                    name = caller;
+                if (name == caller)
+                {
+                    this->caller_counts[slot].fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+            }
+            // tabla llena: sólo cuenta en el total
+        }
+
+        // "bool Collections::ConcurrentDictionary<K, V, M, B>::TryAdd(const K&, const V&) [with ...]" -> "TryAdd"
+        static inline std::string MethodName(std::string_view function)
+        {
+            function = function.substr(0, function.find('('));
+            if (auto colon = function.rfind("::"); colon != std::string_view::npos)
+                function = function.substr(colon + 2);
+            if (auto space = function.rfind(' '); space != std::string_view::npos)
+                function = function.substr(space + 1);
+            return std::string(function);
+        }
+
+        template <typename Lock, typename TryLock>
+        inline uint64_t Acquire(const char *caller, const Lock &acquire, const TryLock &try_acquire)
+        {
+            auto start = Now();
+            if (!try_acquire())
+            {
+                this->contended.fetch_add(1, std::memory_order_relaxed);
+                acquire();
+            }
+            auto acquired = Now();
+            Record(this->wait, acquired - start);
+            this->Count(caller);
+            return acquired;
+        }
+
+    public:
+        InstrumentedMutex() = default;
+        InstrumentedMutex(const InstrumentedMutex &) = delete;
+        InstrumentedMutex &operator=(const InstrumentedMutex &) = delete;
+
+        inline void lock(const char *caller = "?")
+        {
+            this->exclusive_since = this->Acquire(caller, [this]()
+                                                  { this->mutex.lock(); }, [this]()
+                                                  { return this->mutex.try_lock(); });
+        }
+
+        inline bool try_lock()
+        {
+            if (!this->mutex.try_lock())
+                return false;
+            this->Count("?");
+            this->exclusive_since = Now();
+            return true;
+        }
+
+        inline void unlock()
+        {
+            Record(this->hold, Now() - this->exclusive_since);
+            this->mutex.unlock();
+        }
+
+        // los lectores retienen al mismo tiempo: cada uno guarda su inicio (ver ReadLock)
+        inline uint64_t lock_shared(const char *caller = "?")
+            requires SharedLockable<M>
+        {
+            return this->Acquire(caller, [this]()
+                                 { this->mutex.lock_shared(); }, [this]()
+                                 { return this->mutex.try_lock_shared(); });
+        }
+
+        inline void unlock_shared(uint64_t since = 0)
+            requires SharedLockable<M>
+        {
+            if (since)
+                Record(this->hold, Now() - since);
+            this->mutex.unlock_shared();
+        }
+
+        // foto de los contadores; los callers se agrupan por nombre de método
+        inline LockStats Stats() const
+        {
+            LockStats result;
+            result.acquisitions = this->acquisitions.load(std::memory_order_relaxed);
+            result.contended = this->contended.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < LockStats::Buckets; ++i)
+            {
+                result.wait[i] = this->wait[i].load(std::memory_order_relaxed);
+                result.hold[i] = this->hold[i].load(std::memory_order_relaxed);
+            }
+
+            LockStats callers;
+            for (size_t slot = 0; slot < CallerSlots; ++slot)
+            {
+                auto name = this->caller_names[slot].load(std::memory_order_acquire);
+                if (auto count = this->caller_counts[slot].load(std::memory_order_relaxed); name && count)
+                    callers.callers.emplace_back(MethodName(name), count);
+            }
+            // += junta las sobrecargas del mismo método y ordena
+            result += callers;
+            return result;
+        }
+
+        inline void ResetStats()
+        {
+            this->acquisitions = 0;
+            this->contended = 0;
+            for (size_t i = 0; i < LockStats::Buckets; ++i)
+            {
+                this->wait[i] = 0;
+                this->hold[i] = 0;
+            }
+            for (size_t slot = 0; slot < CallerSlots; ++slot)
+                this->caller_counts[slot] = 0;
+        }
+    };
+
+    template <typename M>
+    concept InstrumentedLockable = requires(const M &m) {
+        { m.Stats() } -> std::same_as<LockStats>;
+    };
+
+    // mutex default de los Concurrent*: con -DCOLLECTIONS_LOCK_STATS todos se miden, sin él es std::mutex y no cuesta nada
+#ifdef COLLECTIONS_LOCK_STATS
+    using DefaultMutex = InstrumentedMutex<std::mutex>;
+#else
+    using DefaultMutex = std::mutex;
+#endif
+    // lock para caminos de sólo lectura: compartido si el mutex lo soporta, exclusivo en caso contrario (std::mutex)
+    // con un InstrumentedMutex, el método que toma el lock queda registrado como caller
+    template <typename M>
+    class ReadLock
+    {
+        struct Untimed
+        {
+        };
+
+        M &mutex;
+        // inicio de la retención compartida, sólo con InstrumentedMutex
+        [[no_unique_address]] std::conditional_t<InstrumentedLockable<M> && SharedLockable<M>, uint64_t, Untimed> since;
+
+    public:
+        explicit ReadLock(M &mutex, std::source_location caller = std::source_location::current()) : mutex(mutex)
+        {
+            if constexpr (InstrumentedLockable<M> && SharedLockable<M>)
+                this->since = this->mutex.lock_shared(caller.function_name());
+            else if constexpr (InstrumentedLockable<M>)
+                this->mutex.lock(caller.function_name());
+            else if constexpr (SharedLockable<M>)
+                this->mutex.lock_shared();
+            else
+                this->mutex.lock();
+        }
+
+        ~ReadLock()
+        {
+            if constexpr (InstrumentedLockable<M> && SharedLockable<M>)
+                this->mutex.unlock_shared(this->since);
+            else if constexpr (SharedLockable<M>)
+                this->mutex.unlock_shared();
+            else
+                this->mutex.unlock();
+        }
+
+        ReadLock(const ReadLock &) = delete;
+        ReadLock &operator=(const ReadLock &) = delete;
+    };
+
+    // lock para caminos que modifican: siempre exclusivo
+    template <typename M>
+    class WriteLock
+    {
+        M &mutex;
+
+    public:
+        explicit WriteLock(M &mutex, std::source_location caller = std::source_location::current()) : mutex(mutex)
+        {
+            if constexpr (InstrumentedLockable<M>)
+                this->mutex.lock(caller.function_name());
+            else
+                this->mutex.lock();
+        }
+
+        ~WriteLock()
+        {
+            this->mutex.unlock();
+        }
+
+        WriteLock(const WriteLock &) = delete;
+        WriteLock &operator=(const WriteLock &) = delete;
+    };
+} // namespace Collections
+
+#endif // __COLLECTIONS_LOCKS
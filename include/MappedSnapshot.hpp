@@ -0,0 +1,370 @@
+#ifndef __COLLECTIONS_MAPPED_SNAPSHOT
+#define __COLLECTIONS_MAPPED_SNAPSHOT
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Collections
+{
+    // Snapshots en disco con el mismo layout que en memoria: al arrancar se hace mmap del archivo y se consulta
+    // directo, sin deserializar; el sistema operativo va subiendo las páginas conforme se tocan
+    // - Dictionary / HashSet se guardan como su FrozenHashTable (slots + semillas), List como su arreglo
+    // - sólo para elementos trivialmente copiables (ver SnapshotElement) y hashers que den lo mismo en cualquier proceso
+    //   (std::hash de enteros y enums sí; apuntadores no tienen sentido)
+    // - el archivo es de la máquina que lo escribió: mismo endianness, mismo ABI, misma versión del formato
+    //
+    // formato: SnapshotHeader | elementos (alineados a 64) | semillas uint32_t (alineadas a 64)
+    enum class SnapshotKind : uint32_t
+    {
+        Dictionary = 1,
+        HashSet = 2,
+        List = 3
+    };
+
+    // sube con cualquier cambio de layout o de Hash<K> (los slots dependen del hash); un archivo de otra versión no se mapea
+    // 2: Hash<K> de enteros y strings con wyhash
+    inline constexpr uint32_t SnapshotVersion = 2;
+    inline constexpr char SnapshotMagic[8] = {'C', 'O', 'L', 'L', 'S', 'N', 'A', 'P'};
+
+    struct SnapshotHeader
+    {
+        char magic[8];
+        uint32_t version;
+        SnapshotKind kind;
+        // huella de tipo del elemento y del hasher (nombre, sizeof y alignof): no se mapea un archivo de otro tipo
+        uint64_t type;
+        uint64_t count;
+        uint64_t buckets;
+        uint64_t seed;
+        uint64_t entries_offset;
+        uint64_t seeds_offset;
+        uint64_t size;
+        // de todo lo que sigue al encabezado; sólo se revisa con verify (leer todo el archivo le quita lo lazy al mmap)
+        uint64_t checksum;
+        // de los campos anteriores: siempre se revisa
+        uint64_t header_checksum;
+    };
+
+    // T trivialmente copiable, o el std::pair<const K, V> de un diccionario con K y V trivialmente copiables
+    template <typename T>
+    struct SnapshotElement : std::is_trivially_copyable<T>
+    {
+    };
+
+    template <typename K, typename V>
+    struct SnapshotElement<std::pair<const K, V>> : std::bool_constant<std::is_trivially_copyable<K>::value && std::is_trivially_copyable<V>::value>
+    {
+    };
+
+    // checksum de 64 bits palabra por palabra (un multiply por cada 8 bytes); detecta archivos truncados o corruptos,
+    // no es criptográfico
+    // - se alimenta por pedazos: las palabras se arman sobre el flujo completo, así que el resultado no depende de
+    //   cómo se partan los bytes (el escritor lo calcula por secciones y quien mapea de una pasada)
+    class SnapshotChecksum
+    {
+        uint64_t h = 0;
+        unsigned char pending[8];
+        size_t pending_size = 0;
+
+        inline void Word(const unsigned char *bytes)
+        {
+            uint64_t word;
+            std::memcpy(&word, bytes, 8);
+            this->h = (std::rotl(this->h, 23) ^ word) * 0x9E3779B97F4A7C15ULL;
+        }
+
+    public:
+        SnapshotChecksum() = default;
+
+        SnapshotChecksum(const void *data, size_t size)
+        {
+            this->Add(data, size);
+        }
+
+        inline void Add(const void *data, size_t size)
+        {
+            // una tabla vacía no tiene arreglo: data puede ser nullptr
+            if (size == 0)
+                return;
+            auto bytes = static_cast<const unsigned char *>(data);
+            if (this->pending_size)
+            {
+                size_t take = std::min(size, 8 - this->pending_size);
+                std::memcpy(this->pending + this->pending_size, bytes, take);
+                this->pending_size += take;
+                bytes += take;
+                size -= take;
+                if (this->pending_size < 8)
+                    return;
+                this->Word(this->pending);
+                this->pending_size = 0;
+            }
+            for (; size >= 8; bytes += 8, size -= 8)
+                this->Word(bytes);
+            std::memcpy(this->pending, bytes, size);
+            this->pending_size = size;
+        }
+
+        // los bytes que no completan una palabra van uno por uno
+        inline uint64_t Value() const
+        {
+            uint64_t result = this->h;
+            for (size_t i = 0; i < this->pending_size; ++i)
+                result = (std::rotl(result, 23) ^ this->pending[i]) * 0x9E3779B97F4A7C15ULL;
+            return result;
+        }
+    };
+
+    template <typename T, typename H>
+    inline uint64_t SnapshotType()
+    {
+        // FNV-1a
+        uint64_t h = 0xcbf29ce484222325ULL;
+        auto add = [&](std::string_view s)
+        {
+            for (unsigned char c : s)
+                h = (h ^ c) * 0x100000001b3ULL;
+        };
+        add(typeid(T).name());
+        add(typeid(H).name());
+        add(std::to_string(sizeof(T)) + ":" + std::to_string(alignof(T)));
+        return h;
+    }
+
+    namespace Detail
+    {
+        inline uint64_t AlignSnapshot(uint64_t offset, size_t alignment)
+        {
+            return (offset + alignment - 1) / alignment * alignment;
+        }
+
+        // archivo mapeado de sólo lectura; se desmapea al soltar el último shared_ptr
+        class SnapshotMapping
+        {
+            void *address = nullptr;
+            size_t size = 0;
+
+        public:
+            explicit SnapshotMapping(const std::string &path)
+            {
+                int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0)
+                    throw std::system_error(errno, std::generic_category(), "MapSnapshot: " + path);
+                struct stat st;
+                if (::fstat(fd, &st) != 0)
+                {
+                    int error = errno;
+                    ::close(fd);
+                    throw std::system_error(error, std::generic_category(), "MapSnapshot: " + path);
+                }
+                this->size = static_cast<size_t>(st.st_size);
+                if (this->size < sizeof(SnapshotHeader))
+                {
+                    ::close(fd);
+                    throw std::runtime_error("MapSnapshot: truncated file " + path);
+                }
+                this->address = ::mmap(nullptr, this->size, PROT_READ, MAP_SHARED, fd, 0);
+                int error = errno;
+                ::close(fd);
+                if (this->address == MAP_FAILED)
+                    throw std::system_error(error, std::generic_category(), "MapSnapshot: " + path);
+            }
+
+            SnapshotMapping(const SnapshotMapping &) = delete;
+            SnapshotMapping &operator=(const SnapshotMapping &) = delete;
+
+            ~SnapshotMapping()
+            {
+                ::munmap(this->address, this->size);
+            }
+
+            inline const unsigned char *Data() const
+            {
+                return static_cast<const unsigned char *>(this->address);
+            }
+
+            inline size_t Size() const
+            {
+                return this->size;
+            }
+
+            // las búsquedas en tablas hash brincan por todo el archivo: que el kernel no lea de más
+            inline void AdviseRandom() const
+            {
+                ::madvise(this->address, this->size, MADV_RANDOM);
+            }
+        };
+    } // namespace Detail
+
+    // lo que regresa MapSnapshotFile: apuntadores dentro del archivo, válidos mientras viva file
+    struct MappedSnapshot
+    {
+        std::shared_ptr<const void> file;
+        const void *entries = nullptr;
+        const uint32_t *seeds = nullptr;
+        size_t count = 0, buckets = 0;
+        uint64_t seed = 0;
+    };
+
+    // escribe a path + ".tmp" y renombra: quien mapea path nunca ve un archivo a medias
+    template <typename T, typename H>
+    void WriteSnapshot(const std::string &path, SnapshotKind kind, const T *entries, size_t count, const uint32_t *seeds, size_t buckets, uint64_t seed)
+    {
+        static_assert(SnapshotElement<T>::value, "snapshots are only for trivially copyable elements");
+        constexpr size_t Alignment = std::max<size_t>(64, alignof(T));
+
+        SnapshotHeader header{};
+        std::memcpy(header.magic, SnapshotMagic, sizeof(SnapshotMagic));
+        header.version = SnapshotVersion;
+        header.kind = kind;
+        header.type = SnapshotType<T, H>();
+        header.count = count;
+        header.buckets = buckets;
+        header.seed = seed;
+        header.entries_offset = Detail::AlignSnapshot(sizeof(SnapshotHeader), Alignment);
+        header.seeds_offset = Detail::AlignSnapshot(header.entries_offset + count * sizeof(T), 64);
+        header.size = header.seeds_offset + buckets * sizeof(uint32_t);
+
+        static const unsigned char zeros[Alignment] = {};
+        const size_t entries_padding = header.entries_offset - sizeof(SnapshotHeader);
+        const size_t seeds_padding = header.seeds_offset - header.entries_offset - count * sizeof(T);
+        // exactamente los bytes que se escriben después del relleno del encabezado, en el mismo orden
+        SnapshotChecksum checksum(entries, count * sizeof(T));
+        checksum.Add(zeros, seeds_padding);
+        checksum.Add(seeds, buckets * sizeof(uint32_t));
+        header.checksum = checksum.Value();
+        header.header_checksum = SnapshotChecksum(&header, offsetof(SnapshotHeader, header_checksum)).Value();
+
+        const std::string temporary = path + ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char *>(zeros), static_cast<std::streamsize>(entries_padding));
+            out.write(reinterpret_cast<const char *>(entries), static_cast<std::streamsize>(count * sizeof(T)));
+            out.write(reinterpret_cast<const char *>(zeros), static_cast<std::streamsize>(seeds_padding));
+            out.write(reinterpret_cast<const char *>(seeds), static_cast<std::streamsize>(buckets * sizeof(uint32_t)));
+            out.flush();
+            if (!out)
+            {
+                out.close();
+                std::filesystem::remove(temporary);
+                throw std::runtime_error("SaveSnapshot: cannot write " + temporary);
+            }
+        }
+        std::filesystem::rename(temporary, path);
+    }
+
+    // valida encabezado, tipo y tamaño (y el checksum completo con verify); lanza std::system_error si no se puede
+    // abrir y std::runtime_error si el archivo no es un snapshot válido de este tipo
+    template <typename T, typename H>
+    MappedSnapshot MapSnapshotFile(const std::string &path, SnapshotKind kind, bool verify)
+    {
+        static_assert(SnapshotElement<T>::value, "snapshots are only for trivially copyable elements");
+        auto file = std::make_shared<const Detail::SnapshotMapping>(path);
+
+        SnapshotHeader header;
+        std::memcpy(&header, file->Data(), sizeof(header));
+        if (std::memcmp(header.magic, SnapshotMagic, sizeof(SnapshotMagic)) != 0)
+            throw std::runtime_error("MapSnapshot: not a snapshot " + path);
+        if (header.header_checksum != SnapshotChecksum(&header, offsetof(SnapshotHeader, header_checksum)).Value())
+            throw std::runtime_error("MapSnapshot: corrupt header in " + path);
+        if (header.version != SnapshotVersion)
+            throw std::runtime_error("MapSnapshot: unsupported version " + std::to_string(header.version) + " in " + path);
+        if (header.kind != kind || header.type != SnapshotType<T, H>())
+            throw std::runtime_error("MapSnapshot: type mismatch in " + path);
+        if (header.size != file->Size() || header.entries_offset % alignof(T) != 0 ||
+            header.entries_offset < sizeof(SnapshotHeader) || header.count > (header.size - header.entries_offset) / sizeof(T) ||
+            header.seeds_offset < header.entries_offset + header.count * sizeof(T) || header.seeds_offset % alignof(uint32_t) != 0 ||
+            header.buckets > (header.size - std::min(header.size, header.seeds_offset)) / sizeof(uint32_t))
+            throw std::runtime_error("MapSnapshot: truncated file " + path);
+        if (verify && header.checksum != SnapshotChecksum(file->Data() + header.entries_offset, header.size - header.entries_offset).Value())
+            throw std::runtime_error("MapSnapshot: checksum mismatch in " + path);
+
+        MappedSnapshot result;
+        result.entries = file->Data() + header.entries_offset;
+        result.seeds = reinterpret_cast<const uint32_t *>(file->Data() + header.seeds_offset);
+        result.count = header.count;
+        result.buckets = header.buckets;
+        result.seed = header.seed;
+        if (kind != SnapshotKind::List)
+            file->AdviseRandom();
+        result.file = std::move(file);
+        return result;
+    }
+
+    // List de sólo lectura sobre un snapshot mapeado (ver List::MapSnapshot); copiarla es barato (comparte el archivo)
+    template <typename V>
+    class MappedList
+    {
+        std::shared_ptr<const void> file;
+        const V *data = nullptr;
+        size_t count = 0;
+
+    public:
+        using value_type = V;
+        using const_iterator = const V *;
+
+        MappedList() = default;
+
+        static MappedList Map(const std::string &path, bool verify = false)
+        {
+            auto mapped = MapSnapshotFile<V, void>(path, SnapshotKind::List, verify);
+            MappedList result;
+            result.data = static_cast<const V *>(mapped.entries);
+            result.count = mapped.count;
+            result.file = std::move(mapped.file);
+            return result;
+        }
+
+        inline const V &operator[](size_t i) const
+        {
+            return this->data[i];
+        }
+
+        inline const_iterator begin() const
+        {
+            return this->data;
+        }
+
+        inline const_iterator end() const
+        {
+            return this->data + this->count;
+        }
+
+        inline size_t Size() const
+        {
+            return this->count;
+        }
+
+        inline bool Any() const
+        {
+            return this->count != 0;
+        }
+
+        inline bool Contains(const V &value) const
+        {
+            return std::find(this->begin(), this->end(), value) != this->end();
+        }
+    };
+} // namespace Collections
+
+#endif // __COLLECTIONS_MAPPED_SNAPSHOT
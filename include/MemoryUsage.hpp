@@ -0,0 +1,244 @@
+#ifndef __COLLECTIONS_MEMORY_USAGE
+#define __COLLECTIONS_MEMORY_USAGE
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Collections
+{
+    // Contabilidad de memoria de los contenedores (ver MemoryUsage() en cada uno)
+    // - MemoryUsage() es O(1): el objeto, los nodos, el arreglo de cubetas y el redondeo de malloc
+    //   - con un backend de CountingAllocator (ver Collections::counted) es lo que de verdad se pidió al allocator
+    //   - con cualquier otro allocator es un estimado a partir de size / capacity / bucket_count y el layout de libstdc++
+    // - MemoryUsage(true) además recorre los elementos y suma lo que cuelga de ellos en el heap (ver HeapSize): strings
+    //   largos, vectores, y lo apuntado por valores apuntador (p.ej. los new de Dictionary::GetOrAddNew); es O(n)
+
+    // bytes que malloc de glibc aparta para una petición de n: 8 de encabezado, múltiplos de 16, mínimo 32
+    inline constexpr size_t AllocationSize(size_t n)
+    {
+        return n ? std::max<size_t>(32, (n + 8 + 15) & ~size_t(15)) : 0;
+    }
+
+    // bytes (con el redondeo de malloc) y asignaciones vivas de un CountingAllocator y todas sus copias / rebinds
+    struct MemoryCounter
+    {
+        std::atomic<int64_t> bytes{0};
+        std::atomic<int64_t> allocations{0};
+    };
+
+    // allocator que cuenta lo que pide sobre A (std::allocator o cualquier otro, p.ej. polymorphic_allocator)
+    // - cada contenedor construido por default tiene su propio MemoryCounter; los rebinds internos (nodos, cubetas)
+    //   lo comparten, así que el contador es exactamente la memoria de ese contenedor
+    // - copiar el contenedor crea un contador nuevo; moverlo o hacer swap se lleva el contador con la memoria
+    // - mover el allocator lo copia: el contenedor movido sigue compartiendo el contador con el destino (nunca queda
+    //   sin contador), así que si se reusa lo que asigne después se suma al destino
+    // - dos incrementos relaxed por asignación
+    template <typename T, typename A = std::allocator<T>>
+    class CountingAllocator
+    {
+        template <typename U, typename A2>
+        friend class CountingAllocator;
+
+        using Traits = std::allocator_traits<A>;
+
+        A base;
+        std::shared_ptr<MemoryCounter> counter;
+
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::false_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+        using is_always_equal = std::false_type;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = CountingAllocator<U, typename Traits::template rebind_alloc<U>>;
+        };
+
+        CountingAllocator() : counter(std::make_shared<MemoryCounter>()) {}
+        explicit CountingAllocator(const A &base) : base(base), counter(std::make_shared<MemoryCounter>()) {}
+
+        // sin movimientos implícitos: un shared_ptr movido dejaría al origen con el contador en null
+        CountingAllocator(const CountingAllocator &) = default;
+        CountingAllocator &operator=(const CountingAllocator &) = default;
+
+        template <typename U, typename A2>
+        CountingAllocator(const CountingAllocator<U, A2> &o) : base(o.base), counter(o.counter)
+        {
+        }
+
+        inline T *allocate(size_t n)
+        {
+            T *result = Traits::allocate(this->base, n);
+            this->counter->bytes.fetch_add(static_cast<int64_t>(AllocationSize(n * sizeof(T))), std::memory_order_relaxed);
+            this->counter->allocations.fetch_add(1, std::memory_order_relaxed);
+            return result;
+        }
+
+        inline void deallocate(T *p, size_t n)
+        {
+            Traits::deallocate(this->base, p, n);
+            this->counter->bytes.fetch_sub(static_cast<int64_t>(AllocationSize(n * sizeof(T))), std::memory_order_relaxed);
+            this->counter->allocations.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        inline CountingAllocator select_on_container_copy_construction() const
+        {
+            return CountingAllocator(Traits::select_on_container_copy_construction(this->base));
+        }
+
+        inline const MemoryCounter &Counter() const
+        {
+            return *this->counter;
+        }
+
+        template <typename U, typename A2>
+        inline bool operator==(const CountingAllocator<U, A2> &o) const
+        {
+            return this->counter == o.counter && this->base == o.base;
+        }
+    };
+
+    // bytes en el heap que cuelgan de un valor, sin contar sizeof(T) (eso ya lo cuenta su contenedor)
+    // se especializa para los tipos propios: template <> struct Collections::HeapSize<Orden> { size_t operator()(const Orden &) const; };
+    // los apuntadores se suponen dueños de lo que apuntan
+    template <typename T>
+    struct HeapSize
+    {
+        inline size_t operator()(const T &) const
+        {
+            return 0;
+        }
+    };
+
+    template <typename T>
+    inline size_t HeapSizeOf(const T &value)
+    {
+        return HeapSize<T>{}(value);
+    }
+
+    template <typename C, typename Tr, typename A>
+    struct HeapSize<std::basic_string<C, Tr, A>>
+    {
+        inline size_t operator()(const std::basic_string<C, Tr, A> &s) const
+        {
+            // con small string optimization los datos viven dentro del objeto
+            auto data = reinterpret_cast<const char *>(s.data());
+            bool inside = data >= reinterpret_cast<const char *>(&s) && data < reinterpret_cast<const char *>(&s + 1);
+            return inside ? 0 : AllocationSize((s.capacity() + 1) * sizeof(C));
+        }
+    };
+
+    template <typename T>
+        requires std::is_object<T>::value
+    struct HeapSize<T *>
+    {
+        inline size_t operator()(const T *p) const
+        {
+            return p ? AllocationSize(sizeof(T)) + HeapSizeOf(*p) : 0;
+        }
+    };
+
+    template <typename T, typename D>
+    struct HeapSize<std::unique_ptr<T, D>>
+    {
+        inline size_t operator()(const std::unique_ptr<T, D> &p) const
+        {
+            return p ? AllocationSize(sizeof(T)) + HeapSizeOf(*p) : 0;
+        }
+    };
+
+    // como make_shared: el bloque de control y el objeto en una sola asignación
+    template <typename T>
+    struct HeapSize<std::shared_ptr<T>>
+    {
+        inline size_t operator()(const std::shared_ptr<T> &p) const
+        {
+            return p ? AllocationSize(sizeof(T) + 2 * sizeof(void *)) + HeapSizeOf(*p) : 0;
+        }
+    };
+
+    template <typename T, typename A>
+    struct HeapSize<std::vector<T, A>>
+    {
+        inline size_t operator()(const std::vector<T, A> &v) const
+        {
+            size_t result = AllocationSize(v.capacity() * sizeof(T));
+            for (auto &element : v)
+                result += HeapSizeOf(element);
+            return result;
+        }
+    };
+
+    template <typename T1, typename T2>
+    struct HeapSize<std::pair<T1, T2>>
+    {
+        inline size_t operator()(const std::pair<T1, T2> &p) const
+        {
+            return HeapSizeOf(p.first) + HeapSizeOf(p.second);
+        }
+    };
+
+    // memoria propia de un contenedor std (o de un backend con memory_usage()), sin sizeof(c) ni lo que cuelga de sus elementos
+    template <typename C>
+    size_t ContainerMemoryUsage(const C &c)
+    {
+        using T = typename C::value_type;
+        if constexpr (requires { c.memory_usage(); })
+            return c.memory_usage();
+        else if constexpr (requires { c.get_allocator().Counter(); })
+            return static_cast<size_t>(std::max<int64_t>(0, c.get_allocator().Counter().bytes.load(std::memory_order_relaxed)));
+        else if constexpr (requires { c.bucket_count(); typename C::hasher; })
+        {
+            // nodo de std::unordered_*: siguiente + valor (+ hash guardado si el hasher no es "rápido", ver Hash.hpp)
+            constexpr bool cached =
+#if defined(__GLIBCXX__)
+                !std::__is_fast_hash<typename C::hasher>::value;
+#else
+                false;
+#endif
+            constexpr size_t node = (sizeof(void *) + sizeof(T) + alignof(T) - 1) / alignof(T) * alignof(T) + (cached ? sizeof(size_t) : 0);
+            // con una sola cubeta libstdc++ usa la que trae adentro
+            size_t buckets = c.bucket_count() > 1 ? AllocationSize(c.bucket_count() * sizeof(void *)) : 0;
+            return buckets + c.size() * AllocationSize(node);
+        }
+        else if constexpr (requires { c.key_comp(); })
+        {
+            // nodo de std::map / set: color, padre, izquierdo, derecho + valor
+            return c.size() * AllocationSize(4 * sizeof(void *) + sizeof(T));
+        }
+        else if constexpr (requires { c.capacity(); c.data(); })
+            return AllocationSize(c.capacity() * sizeof(T));
+        else if constexpr (requires(C &m) { m.push_front(std::declval<T>()); m[0]; })
+        {
+            // std::deque: bloques de 512 bytes (o de un elemento si no cabe) y el mapa de apuntadores a bloques
+            constexpr size_t per_block = sizeof(T) < 512 ? 512 / sizeof(T) : 1;
+            size_t blocks = c.size() / per_block + 1;
+            return blocks * AllocationSize(per_block * sizeof(T)) + AllocationSize(std::max<size_t>(8, blocks + 2) * sizeof(void *));
+        }
+        else if constexpr (requires(C &m) { m.push_front(std::declval<T>()); m.splice(m.begin(), m); })
+            return c.size() * AllocationSize(2 * sizeof(void *) + sizeof(T));
+        else
+            return c.size() * sizeof(T);
+    }
+
+    // suma de HeapSize de los elementos: O(n)
+    template <typename C>
+    size_t ElementsHeapSize(const C &c)
+    {
+        size_t result = 0;
+        for (auto &&element : c)
+            result += HeapSizeOf(element);
+        return result;
+    }
+} // namespace Collections
+
+#endif // __COLLECTIONS_MEMORY_USAGE
@@ -0,0 +1,83 @@
+#ifndef __COLLECTIONS_PARALLEL
+#define __COLLECTIONS_PARALLEL
+
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Collections
+{
+    // workers = 0 : un worker por core
+    inline size_t ParallelWorkers(size_t workers)
+    {
+        return workers ? workers : std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    // parte [0, n) en `workers` rangos contiguos y llama body(begin, end, worker) con cada uno en su propio thread
+    // (el último rango corre en el thread que llama); la primera excepción de cualquier worker se relanza al final
+    template <typename F>
+    void ParallelFor(size_t n, size_t workers, const F &body)
+    {
+        workers = std::max<size_t>(1, std::min(ParallelWorkers(workers), n));
+        std::exception_ptr error;
+        std::mutex error_mutex;
+        auto run = [&](size_t worker)
+        {
+            try
+            {
+                body(n * worker / workers, n * (worker + 1) / workers, worker);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> m(error_mutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(workers - 1);
+        for (size_t worker = 0; worker + 1 < workers; ++worker)
+            threads.emplace_back(run, worker);
+        run(workers - 1);
+        for (auto &thread : threads)
+            thread.join();
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    // recorre los elementos del contenedor en paralelo: action(elemento, worker)
+    // - con interfaz de cubetas (std::unordered_map / set) cada worker toma un rango de cubetas, sin copiar nada
+    // - con cualquier otro contenedor primero se juntan apuntadores a los elementos en una pasada y después se reparten
+    template <typename C, typename F>
+    void ParallelVisit(C &container, size_t workers, const F &action)
+    {
+        if constexpr (requires(C &c, size_t n) { c.bucket_count(); c.begin(n); c.end(n); })
+        {
+            ParallelFor(container.bucket_count(), workers, [&](size_t begin, size_t end, size_t worker)
+                        {
+                for (size_t bucket = begin; bucket < end; ++bucket)
+                {
+                    for (auto element = container.begin(bucket); element != container.end(bucket); ++element)
+                        action(*element, worker);
+                } });
+        }
+        else
+        {
+            std::vector<decltype(&*container.begin())> elements;
+            elements.reserve(container.size());
+            for (auto &element : container)
+                elements.push_back(&element);
+
+            ParallelFor(elements.size(), workers, [&](size_t begin, size_t end, size_t worker)
+                        {
+                for (size_t i = begin; i < end; ++i)
+                    action(*elements[i], worker); });
+        }
+    }
+} // namespace Collections
+
+#endif // __COLLECTIONS_PARALLEL
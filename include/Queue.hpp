@@ -1,48 +1,89 @@
 #ifndef __COLLECIONS_QUEUE
 #define __COLLECIONS_QUEUE
 
+#include <deque>
 #include <queue>
 #include <optional>
+#include <utility>
+
+#include "MemoryUsage.hpp"
 
 namespace Collections
 {
-    template <typename T>
-    class Queue : protected std::queue<T>
+    // C = std::deque<T> | std::pmr::deque<T> (ver Collections::pmr) | cualquier contenedor que acepte std::queue
+    template <typename T, typename C = std::deque<T>>
+    class Queue : protected std::queue<T, C>
     {
 
         // ojo : containers always, always destroy their contained objects when they're removed from the container BUT  A pointer object does NOT have a destructo
         // https://stackoverflow.com/questions/2002282/c-stdqueuepop-calls-destructor-what-of-pointer-types
 
     public:
-        
+        Queue() = default;
+        explicit Queue(const typename C::allocator_type &allocator) : std::queue<T, C>(allocator) {}
+
         // en std la std::queue no tiene iteradores
         inline int Size()
         {
-            return std::queue<T>::size();
+            return std::queue<T, C>::size();
+        }
+
+        // ver Dictionary::MemoryUsage
+        inline size_t MemoryUsage(bool deep = false) const
+        {
+            return sizeof(*this) + ContainerMemoryUsage(this->c) + (deep ? ElementsHeapSize(this->c) : 0);
         }
 
         inline bool Any()
         {
-            return !std::queue<T>::empty();
+            return !std::queue<T, C>::empty();
         }
 
         inline void Enqueue(const T &t)
         {
-            std::queue<T>::emplace(t);
+            std::queue<T, C>::emplace(t);
+        }
+
+        inline void Enqueue(T &&t)
+        {
+            std::queue<T, C>::emplace(std::move(t));
+        }
+
+        // construye el elemento directamente en la cola
+        template <typename... Args>
+        inline void Emplace(Args &&...args)
+        {
+            std::queue<T, C>::emplace(std::forward<Args>(args)...);
+        }
+
+        // [first, last) se encola en orden; regresa cuántos elementos se encolaron
+        template <typename I>
+        inline size_t EnqueueRange(I first, I last)
+        {
+            size_t count = 0;
+            for (; first != last; ++first, ++count)
+                std::queue<T, C>::emplace(*first);
+            return count;
         }
 
         inline bool TryEnqueue(const T &t)
         {
-            std::queue<T>::emplace(t);
+            std::queue<T, C>::emplace(t);
             return false; // este método es más un dummy para poderlo meter en IF's
         }
 
+        inline bool TryEnqueue(T &&t)
+        {
+            std::queue<T, C>::emplace(std::move(t));
+            return false;
+        }
+
         inline bool TryDequeue(T *&t)
         {
-            if (!std::queue<T>::empty())
+            if (!std::queue<T, C>::empty())
             {
-                t = &std::queue<T>::front();
-                std::queue<T>::pop();
+                t = &std::queue<T, C>::front();
+                std::queue<T, C>::pop();
                 return true;
             }
             return false;
@@ -50,20 +91,21 @@ namespace Collections
 
         inline bool TryPeek(T &t)
         {
-            if (!std::queue<T>::empty())
+            if (!std::queue<T, C>::empty())
             {
-                t = std::queue<T>::front();
+                t = std::queue<T, C>::front();
                 return true;
             }
             return false;
         }
 
+        // el elemento se mueve hacia afuera (sin copia)
         inline bool TryDequeue(T &t)
         {
-            if (!std::queue<T>::empty())
+            if (!std::queue<T, C>::empty())
             {
-                t = std::queue<T>::front();
-                std::queue<T>::pop();
+                t = std::move(std::queue<T, C>::front());
+                std::queue<T, C>::pop();
                 return true;
             }
             return false;
@@ -71,11 +113,11 @@ namespace Collections
 
         inline std::optional<T> Dequeue()
         {
-            if (!std::queue<T>::empty())
+            if (!std::queue<T, C>::empty())
             {
-                auto t = std::queue<T>::front();
-                std::queue<T>::pop();
-                return std::optional<T>(t);
+                std::optional<T> t(std::move(std::queue<T, C>::front()));
+                std::queue<T, C>::pop();
+                return t;
             }
             return std::nullopt;
         }
@@ -83,9 +125,9 @@ namespace Collections
         template <typename F>
         inline bool TryPeek(const F &action)
         {
-            if (!std::queue<T>::empty())
+            if (!std::queue<T, C>::empty())
             {
-                action(std::queue<T>::front());
+                action(std::queue<T, C>::front());
                 return true;
             }
             return false;
@@ -94,10 +136,10 @@ namespace Collections
         template <typename F>
         inline bool TryDequeue(const F &action)
         {
-            if (!std::queue<T>::empty())
+            if (!std::queue<T, C>::empty())
             {
-                action(std::queue<T>::front());
-                std::queue<T>::pop();
+                action(std::queue<T, C>::front());
+                std::queue<T, C>::pop();
                 return true;
             }
             return false;
@@ -113,11 +155,22 @@ namespace Collections
 
         inline void Clear()
         {
-            while (!std::queue<T>::empty())
-                std::queue<T>::pop();
+            while (!std::queue<T, C>::empty())
+                std::queue<T, C>::pop();
         }
     };
 
+    namespace pmr
+    {
+        template <typename T>
+        using Queue = Collections::Queue<T, std::pmr::deque<T>>;
+    } // namespace pmr
+
+    namespace counted
+    {
+        template <typename T>
+        using Queue = Collections::Queue<T, std::deque<T, CountingAllocator<T>>>;
+    } // namespace counted
 } // namespace Collections
 
 #endif // __COLLECIONS_QUEUE
@@ -143,6 +143,9 @@ namespace Collections
         inline std::vector<std::pair<const K, const V>> ToVector()
         {
             std::vector<std::pair<const K, const V>> result;
+            // estimado barato de rocksdb, sin recorrer la base
+            if (uint64_t estimate; this->db->GetIntProperty("rocksdb.estimate-num-keys", &estimate))
+                result.reserve(estimate);
             auto it = std::unique_ptr<rocksdb::Iterator>(this->db->NewIterator(rocksdb::ReadOptions()));
             for (it->SeekToFirst(); it->Valid(); it->Next())
             {
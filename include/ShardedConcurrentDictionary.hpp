@@ -0,0 +1,669 @@
+#ifndef __COLLECTIONS_SHARDED_CONCURRENT_DICTIONARY
+#define __COLLECTIONS_SHARDED_CONCURRENT_DICTIONARY
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <shared_mutex>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Dictionary.hpp"
+#include "DictionarySnapshot.hpp"
+#include "Locks.hpp"
+#include "Parallel.hpp"
+
+namespace Collections
+{
+
+    // Igual que ConcurrentDictionary pero reparte las llaves en N Dictionary (shards), cada uno con su propio mutex,
+    // así los threads que tocan llaves distintas casi nunca se bloquean entre sí (lock striping)
+    // M = std::mutex | std::shared_mutex (lectores simultáneos dentro de cada shard)
+    //     | InstrumentedMutex<...> (contención sumada de todos los shards, ver Stats) | propietario
+    // B = backend del Dictionary de cada shard (ver Dictionary)
+    template <typename K, typename V, typename M = DefaultMutex, typename B = std::unordered_map<K, V, Hash<K>, Equal<K>>>
+    class ShardedConcurrentDictionary
+    {
+        // alineado a línea de cache para que los mutex de shards vecinos no se peleen la misma línea
+        struct alignas(64) Shard
+        {
+            M mutex;
+            Dictionary<K, V, B> dictionary;
+        };
+
+        std::unique_ptr<Shard[]> shards;
+        size_t shard_count;
+
+        // con el hasher del backend, para que una búsqueda heterogénea caiga en el mismo shard que su llave
+        template <typename Q>
+        inline size_t ShardIndexOf(const Q &key) const
+        {
+            return ShardIndex(typename B::hasher{}(key), this->shard_count);
+        }
+
+        template <typename Q>
+        inline Shard &ShardOf(const Q &key)
+        {
+            return this->shards[this->ShardIndexOf(key)];
+        }
+
+        // agrupa un lote por shard (counting sort de las posiciones) y llama apply(dictionary, posiciones) una sola vez
+        // por shard con su lock tomado; las posiciones de cada shard quedan en el orden original del lote
+        template <typename L, typename F>
+        void ForEachShardBatch(const std::vector<size_t> &shard_of, const F &apply)
+        {
+            std::vector<size_t> offsets(this->shard_count + 1), order(shard_of.size());
+            for (auto shard : shard_of)
+                ++offsets[shard + 1];
+            for (size_t i = 0; i < this->shard_count; ++i)
+                offsets[i + 1] += offsets[i];
+
+            auto next = offsets;
+            for (size_t i = 0; i < shard_of.size(); ++i)
+                order[next[shard_of[i]]++] = i;
+
+            for (size_t i = 0; i < this->shard_count; ++i)
+            {
+                if (offsets[i] == offsets[i + 1])
+                    continue;
+                L m(this->shards[i].mutex);
+                apply(this->shards[i].dictionary, std::span<const size_t>(order).subspan(offsets[i], offsets[i + 1] - offsets[i]));
+            }
+        }
+
+        // F = TryAddRange / AddRange / RemoveRange del Dictionary de cada shard, sobre los elementos que le tocan
+        template <typename I, typename KeyOf, typename F>
+        std::vector<bool> ApplyRange(I first, I last, const KeyOf &key_of, const F &range)
+        {
+            static_assert(std::forward_iterator<I>, "sharded batches need forward iterators");
+            std::vector<I> items;
+            std::vector<size_t> shard_of;
+            for (; first != last; ++first)
+            {
+                items.push_back(first);
+                shard_of.push_back(this->ShardIndexOf(key_of(*first)));
+            }
+
+            std::vector<bool> result(items.size());
+            this->template ForEachShardBatch<WriteLock<M>>(shard_of, [&](Dictionary<K, V, B> &dictionary, std::span<const size_t> positions)
+                                                           {
+                auto batch = positions | std::views::transform([&items](size_t i) -> decltype(auto)
+                                                               { return *items[i]; });
+                auto partial = range(dictionary, batch.begin(), batch.end());
+                for (size_t j = 0; j < positions.size(); ++j)
+                    result[positions[j]] = partial[j]; });
+            return result;
+        }
+
+    public:
+        // 4 shards por core (redondeado a potencia de 2) reduce bastante la probabilidad de colisión entre threads
+        static size_t DefaultShardCount()
+        {
+            return std::bit_ceil(std::max(1U, std::thread::hardware_concurrency()) * 4U);
+        }
+
+        explicit ShardedConcurrentDictionary(size_t shards = DefaultShardCount())
+            : shards(new Shard[std::bit_ceil(std::max<size_t>(shards, 1))]), shard_count(std::bit_ceil(std::max<size_t>(shards, 1)))
+        {
+        }
+
+        ShardedConcurrentDictionary(const std::unordered_map<K, V> &o, size_t shards = DefaultShardCount()) : ShardedConcurrentDictionary(shards)
+        {
+            this->FromMap(o);
+        }
+
+        // contención de todos los shards sumada, sólo con M = InstrumentedMutex (o COLLECTIONS_LOCK_STATS)
+        inline LockStats Stats() const
+            requires InstrumentedLockable<M>
+        {
+            LockStats result;
+            for (size_t i = 0; i < this->shard_count; ++i)
+                result += this->shards[i].mutex.Stats();
+            return result;
+        }
+
+        inline size_t ShardCount() const
+        {
+            return this->shard_count;
+        }
+
+        // el operador[] insertará el valor por default en primitivas en donde exista default, de lo contrario, usar GetOrAdd
+        V &operator[](const K &key)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary[key];
+        }
+
+        // el tamaño para reservar es aproximado: los shards pueden crecer entre el conteo y la copia
+        inline std::vector<K> Keys()
+        {
+            std::vector<K> result;
+            result.reserve(this->Size());
+            for (size_t i = 0; i < this->shard_count; ++i)
+            {
+                ReadLock<M> m(this->shards[i].mutex);
+                for (auto &kvp : this->shards[i].dictionary)
+                    result.push_back(kvp.first);
+            }
+            return result;
+        }
+
+        template <typename F>
+        inline std::vector<K> Keys(const F &condition)
+        {
+            std::vector<K> result;
+            for (size_t i = 0; i < this->shard_count; ++i)
+            {
+                ReadLock<M> m(this->shards[i].mutex);
+                for (auto &kvp : this->shards[i].dictionary)
+                {
+                    if (condition(kvp.first))
+                        result.push_back(kvp.first);
+                }
+            }
+            return result;
+        }
+
+        inline std::vector<V> Values()
+        {
+            std::vector<V> result;
+            result.reserve(this->Size());
+            for (size_t i = 0; i < this->shard_count; ++i)
+            {
+                ReadLock<M> m(this->shards[i].mutex);
+                for (auto &kvp : this->shards[i].dictionary)
+                    result.push_back(kvp.second);
+            }
+            return result;
+        }
+
+        // ojo : no es una foto atómica de todo el diccionario, cada shard se cuenta con su propio lock
+        inline size_t Size()
+        {
+            size_t result = 0;
+            for (size_t i = 0; i < this->shard_count; ++i)
+            {
+                ReadLock<M> m(this->shards[i].mutex);
+                result += this->shards[i].dictionary.Size();
+            }
+            return result;
+        }
+
+        // ver Dictionary::MemoryUsage; shard por shard
+        inline size_t MemoryUsage(bool deep = false)
+        {
+            size_t result = sizeof(*this) + AllocationSize(this->shard_count * sizeof(Shard));
+            for (size_t i = 0; i < this->shard_count; ++i)
+            {
+                ReadLock<M> m(this->shards[i].mutex);
+                result += this->shards[i].dictionary.MemoryUsage(deep) - sizeof(Dictionary<K, V, B>);
+            }
+            return result;
+        }
+
+        inline bool Any()
+        {
+            for (size_t i = 0; i < this->shard_count; ++i)
+            {
+                ReadLock<M> m(this->shards[i].mutex);
+                if (this->shards[i].dictionary.Any())
+                    return true;
+            }
+            return false;
+        }
+
+        inline void Clear()
+        {
+            for (size_t i = 0; i < this->shard_count; ++i)
+            {
+                WriteLock<M> m(this->shards[i].mutex);
+                this->shards[i].dictionary.Clear();
+            }
+        }
+
+        inline bool TryRemove(const K &key)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.TryRemove(key);
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q>
+        inline bool TryRemove(const Q &key)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.TryRemove(key);
+        }
+
+        inline V &Incr(const K &key, const V &value)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary[key] += value;
+        }
+
+        inline bool TryRemove(const K &key, V &value)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.TryRemove(key, value);
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q>
+        inline bool TryRemove(const Q &key, V &value)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.TryRemove(key, value);
+        }
+
+        inline bool TryRemove(const K &key, V *&value)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.TryRemove(key, value);
+        }
+
+        inline bool TryRemoveIf(const K &key, const std::function<bool(V &)> &cond)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.TryRemoveIf(key, cond);
+        }
+
+        inline bool TryRemoveWhen(const K &key, const std::function<bool(V &)> &cond)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.TryRemoveWhen(key, cond);
+        }
+
+        template <typename F>
+        inline bool TryRemoveExec(const K &key, const F &action)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.TryRemoveExec(key, action);
+        }
+
+        inline bool ContainsKey(const K &key)
+        {
+            auto &shard = this->ShardOf(key);
+            ReadLock<M> m(shard.mutex);
+            return shard.dictionary.ContainsKey(key);
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q>
+        inline bool ContainsKey(const Q &key)
+        {
+            auto &shard = this->ShardOf(key);
+            ReadLock<M> m(shard.mutex);
+            return shard.dictionary.ContainsKey(key);
+        }
+
+        inline bool TryCheckValue(const K &key, const std::function<bool(V &)> &cond)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.TryCheckValue(key, cond);
+        }
+
+        inline bool TryGetValue(const K &key, V &value)
+        {
+            auto &shard = this->ShardOf(key);
+            ReadLock<M> m(shard.mutex);
+            return shard.dictionary.TryGetValue(key, value);
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q>
+        inline bool TryGetValue(const Q &key, V &value)
+        {
+            auto &shard = this->ShardOf(key);
+            ReadLock<M> m(shard.mutex);
+            return shard.dictionary.TryGetValue(key, value);
+        }
+
+        inline bool TryGetValue(const K &key, V *&value)
+        {
+            auto &shard = this->ShardOf(key);
+            ReadLock<M> m(shard.mutex);
+            return shard.dictionary.TryGetValue(key, value);
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q>
+        inline bool TryGetValue(const Q &key, V *&value)
+        {
+            auto &shard = this->ShardOf(key);
+            ReadLock<M> m(shard.mutex);
+            return shard.dictionary.TryGetValue(key, value);
+        }
+
+        template <typename F>
+        inline bool TryGetValueExec(const K &key, const F &action)
+        {
+            auto &shard = this->ShardOf(key);
+            ReadLock<M> m(shard.mutex);
+            return shard.dictionary.TryGetValueExec(key, action);
+        }
+
+        inline bool TryAdd(const K &key, const V &value)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.TryAdd(key, value);
+        }
+
+        inline bool TryAdd(const K &key, V &&value)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.TryAdd(key, std::move(value));
+        }
+
+        inline bool TryAdd(K &&key, V &&value)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.TryAdd(std::move(key), std::move(value));
+        }
+
+        template <typename... Args>
+        inline bool TryEmplace(const K &key, Args &&...args)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.TryEmplace(key, std::forward<Args>(args)...);
+        }
+
+        template <typename... Args>
+        inline bool TryEmplace(K &&key, Args &&...args)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.TryEmplace(std::move(key), std::forward<Args>(args)...);
+        }
+
+        template <typename Q, typename U>
+            requires HeterogeneousKey<B, Q> && std::constructible_from<K, const Q &> && std::constructible_from<V, U &&>
+        inline bool TryAdd(const Q &key, U &&value)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.TryAdd(key, std::forward<U>(value));
+        }
+
+        // a diferencia de ConcurrentDictionary la llave se calcula fuera del lock, pues hasta tenerla no sabemos su shard
+        inline bool TryAdd(const std::function<K()> &key, const V &value)
+        {
+            return this->TryAdd(key(), value);
+        }
+
+        inline bool TryAdd(const K &key, const std::function<V()> &function)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.TryAdd(key, function);
+        }
+
+        inline bool Add(const K &key, const V &value)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.Add(key, value);
+        }
+
+        inline bool Add(const K &key, V &&value)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.Add(key, std::move(value));
+        }
+
+        inline bool Add(K &&key, V &&value)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.Add(std::move(key), std::move(value));
+        }
+
+        inline V &GetOrAdd(const K &key, const std::function<V()> &add)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.GetOrAdd(key, add);
+        }
+
+        template <typename Q>
+            requires HeterogeneousKey<B, Q> && std::constructible_from<K, const Q &>
+        inline V & GetOrAdd(const Q &key, const std::function<V()> &add)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.GetOrAdd(key, add);
+        }
+
+        inline V &GetOrAdd(const K &key)
+        {
+            return this->GetOrAddNew(key);
+        }
+
+        inline V &GetOrAddNew(const K &key)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.GetOrAddNew(key);
+        }
+
+        inline V &GetOrAddOrNull(const K &key, const std::function<V()> &add)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            return shard.dictionary.GetOrAddOrNull(key, add);
+        }
+
+        inline void AddOrUpdate(const K &key, const std::function<V()> &add, const std::function<void(V &)> &update)
+        {
+            auto &shard = this->ShardOf(key);
+            WriteLock<M> m(shard.mutex);
+            shard.dictionary.AddOrUpdate(key, add, update);
+        }
+
+        // n es el total: cada shard reserva su parte (las llaves se reparten de forma pareja)
+        inline void Reserve(size_t n)
+        {
+            for (size_t i = 0; i < this->shard_count; ++i)
+            {
+                WriteLock<M> m(this->shards[i].mutex);
+                this->shards[i].dictionary.Reserve((n + this->shard_count - 1) / this->shard_count);
+            }
+        }
+
+        inline void SetMaxLoadFactor(float max_load_factor)
+        {
+            for (size_t i = 0; i < this->shard_count; ++i)
+            {
+                WriteLock<M> m(this->shards[i].mutex);
+                this->shards[i].dictionary.SetMaxLoadFactor(max_load_factor);
+            }
+        }
+
+        inline void ShrinkToFit()
+        {
+            for (size_t i = 0; i < this->shard_count; ++i)
+            {
+                WriteLock<M> m(this->shards[i].mutex);
+                this->shards[i].dictionary.ShrinkToFit();
+            }
+        }
+
+        // los lotes se agrupan por shard: cada shard involucrado se bloquea una sola vez y los resultados regresan en
+        // el orden del lote (ver Dictionary::TryAddRange). Ojo : el lote no es atómico entre shards
+        template <typename I>
+        inline std::vector<bool> TryAddRange(I first, I last)
+        {
+            return this->ApplyRange(first, last, [](const auto &kvp) -> const K &
+                                    { return kvp.first; },
+                                    [](Dictionary<K, V, B> &dictionary, auto begin, auto end)
+                                    { return dictionary.TryAddRange(begin, end); });
+        }
+
+        template <typename I>
+        inline std::vector<bool> AddRange(I first, I last)
+        {
+            return this->ApplyRange(first, last, [](const auto &kvp) -> const K &
+                                    { return kvp.first; },
+                                    [](Dictionary<K, V, B> &dictionary, auto begin, auto end)
+                                    { return dictionary.AddRange(begin, end); });
+        }
+
+        template <typename I>
+        inline std::vector<bool> RemoveRange(I first, I last)
+        {
+            return this->ApplyRange(first, last, [](const auto &key) -> const auto &
+                                    { return key; },
+                                    [](Dictionary<K, V, B> &dictionary, auto begin, auto end)
+                                    { return dictionary.RemoveRange(begin, end); });
+        }
+
+        inline std::vector<bool> TryGetMany(std::span<const K> keys, std::span<V> values)
+        {
+            assert(values.size() >= keys.size());
+            std::vector<size_t> shard_of(keys.size());
+            for (size_t i = 0; i < keys.size(); ++i)
+                shard_of[i] = this->ShardIndexOf(keys[i]);
+
+            std::vector<bool> result(keys.size());
+            this->template ForEachShardBatch<ReadLock<M>>(shard_of, [&](Dictionary<K, V, B> &dictionary, std::span<const size_t> positions)
+                                                          {
+                for (auto i : positions)
+                    result[i] = dictionary.TryGetValue(keys[i], values[i]); });
+            return result;
+        }
+
+        // foto de sólo lectura copiada shard por shard: cada escritor espera a lo más la copia de su shard
+        // ojo : cada shard es una foto en su momento, no hay un instante único para todo el diccionario
+        DictionarySnapshot<K, V, B> Snapshot()
+        {
+            std::vector<std::shared_ptr<const B>> parts;
+            parts.reserve(this->shard_count);
+            for (size_t i = 0; i < this->shard_count; ++i)
+            {
+                ReadLock<M> m(this->shards[i].mutex);
+                parts.push_back(std::make_shared<const B>(this->shards[i].dictionary.begin(), this->shards[i].dictionary.end()));
+            }
+            return DictionarySnapshot<K, V, B>(std::move(parts));
+        }
+
+        // recorre shard por shard: sólo bloquea un shard a la vez, los escritores de los demás shards siguen trabajando
+        template <typename F>
+        void ForEach(const F &action)
+        {
+            for (size_t i = 0; i < this->shard_count; ++i)
+            {
+                WriteLock<M> m(this->shards[i].mutex);
+                this->shards[i].dictionary.ForEach(action);
+            }
+        }
+
+        // versiones paralelas: cada worker toma shards enteros y bloquea sólo el que está recorriendo
+        template <typename F>
+        void ParallelForEach(const F &action, size_t workers = 0)
+        {
+            ParallelFor(this->shard_count, workers, [&](size_t begin, size_t end, size_t)
+                        {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    WriteLock<M> m(this->shards[i].mutex);
+                    this->shards[i].dictionary.ForEach(action);
+                } });
+        }
+
+        // kvp.second = action(kvp.first, kvp.second) para cada elemento
+        template <typename F>
+        void ParallelTransform(const F &action, size_t workers = 0)
+        {
+            ParallelFor(this->shard_count, workers, [&](size_t begin, size_t end, size_t)
+                        {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    WriteLock<M> m(this->shards[i].mutex);
+                    for (auto &kvp : this->shards[i].dictionary)
+                        kvp.second = action(kvp.first, static_cast<const V &>(kvp.second));
+                } });
+        }
+
+        template <typename F>
+        std::vector<K> ParallelKeys(const F &condition, size_t workers = 0)
+        {
+            std::vector<std::vector<K>> partial(this->shard_count);
+            ParallelFor(this->shard_count, workers, [&](size_t begin, size_t end, size_t)
+                        {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    ReadLock<M> m(this->shards[i].mutex);
+                    for (auto &kvp : this->shards[i].dictionary)
+                    {
+                        if (condition(kvp.first))
+                            partial[i].push_back(kvp.first);
+                    }
+                } });
+
+            std::vector<K> result;
+            for (auto &keys : partial)
+                result.insert(result.end(), keys.begin(), keys.end());
+            return result;
+        }
+
+        // combine debe ser asociativa (ver Dictionary::Reduce)
+        template <typename T, typename Map, typename Combine>
+        T Reduce(T init, const Map &map, const Combine &combine, size_t workers = 0)
+        {
+            std::vector<std::optional<T>> partial(this->shard_count);
+            ParallelFor(this->shard_count, workers, [&](size_t begin, size_t end, size_t)
+                        {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    ReadLock<M> m(this->shards[i].mutex);
+                    for (auto &kvp : this->shards[i].dictionary)
+                    {
+                        auto &local = partial[i];
+                        if (local)
+                            local = combine(std::move(*local), map(kvp));
+                        else
+                            local.emplace(map(kvp));
+                    }
+                } });
+
+            for (auto &local : partial)
+            {
+                if (local)
+                    init = combine(std::move(init), std::move(*local));
+            }
+            return init;
+        }
+
+        void FromMap(const std::unordered_map<K, V> &map)
+        {
+            this->Clear();
+            for (const auto &[k, v] : map)
+                this->Add(k, v);
+        }
+    };
+} // namespace Collections
+
+#endif // __COLLECTIONS_SHARDED_CONCURRENT_DICTIONARY
@@ -1,59 +1,105 @@
 #ifndef __COLLECTIONS_SORTED_DICTIONARY
 #define __COLLECTIONS_SORTED_DICTIONARY
 
+#include <algorithm>
+#include <cassert>
 #include <map>
+#include <numeric>
+#include <ranges>
+#include <span>
 #include <utility>
 #include <vector>
 
+#include "BPlusTreeMap.hpp"
+#include "MemoryUsage.hpp"
+
 namespace Collections
 {
     // C = std::less<K> | std::greater<K> | o propietaria
-    template <typename K, typename V, typename C>
-    class SortedDictionary : std::map<K, V, C>
+    // B = std::map<K, V, C> | std::pmr::map<K, V, C> (ver Collections::pmr)
+    //     | BPlusTreeMap<K, V, C> (nodos anchos y hojas ligadas: búsquedas y recorridos con menos cache misses)
+    //     | cualquier mapa ordenado con la interfaz de std::map
+    template <typename K, typename V, typename C, typename B = std::map<K, V, C>>
+    class SortedDictionary : B
     {        
+        // pasos hacia adelante que se intentan antes de volver a bajar por el árbol
+        static constexpr size_t ForwardSteps = 4;
+
+        // found(i, V* o nullptr) por cada keys[i]: en un árbol no hay cubetas que pedir por adelantado, así que las
+        // llaves se resuelven en el orden de C con un solo recorrido: una llave cercana a la anterior se alcanza
+        // avanzando el iterador, y si no, lower_bound baja por la parte alta del árbol que ya quedó en caché
+        template <typename F>
+        inline void FindMany(std::span<const K> keys, const F &found)
+        {
+            std::vector<size_t> order(keys.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                      { return B::key_comp()(keys[a], keys[b]); });
+
+            auto kvp = B::begin();
+            for (size_t i : order)
+            {
+                const K &key = keys[i];
+                size_t steps = 0;
+                while (kvp != B::end() && steps < ForwardSteps && B::key_comp()(kvp->first, key))
+                {
+                    ++kvp;
+                    ++steps;
+                }
+                if (kvp != B::end() && B::key_comp()(kvp->first, key))
+                    kvp = B::lower_bound(key);
+                found(i, kvp != B::end() && !B::key_comp()(key, kvp->first) ? &kvp->second : nullptr);
+            }
+        }
+
 
     public:
-        void From(const SortedDictionary<K, V, C> &src)
+        SortedDictionary() = default;
+        explicit SortedDictionary(const typename B::allocator_type &allocator) : B(allocator) {}
+
+        void From(const SortedDictionary<K, V, C, B> &src)
         {            
-            for (auto& [k,v] : src)
+            for (const auto &[k, v] : src)
                 this->operator[](k) = v;
         }
 
         // el operador[] insertará el valor por default en primitivas en donde exista default, de lo contrario, usar GetOrAdd
         inline V &operator[](const K &key)
         {
-            return std::map<K, V, C>::operator[](key);
+            return B::operator[](key);
         }
 
         // el operador[] insertará el valor por default en primitivas en donde exista default, de lo contrario, usar GetOrAdd
         const inline V &operator[](const K &key) const
         {
-            return std::map<K, V, C>::operator[](key);
+            return B::operator[](key);
         }
 
-        typename SortedDictionary<K, V, C>::iterator begin()
+        typename SortedDictionary<K, V, C, B>::iterator begin()
         {
-            return std::map<K, V, C>::begin();
+            return B::begin();
         }
 
-        typename SortedDictionary<K, V, C>::iterator end()
+        typename SortedDictionary<K, V, C, B>::iterator end()
         {
-            return std::map<K, V, C>::end();
+            return B::end();
         }
 
-        typename SortedDictionary<K, V, C>::const_iterator begin() const
+        typename SortedDictionary<K, V, C, B>::const_iterator begin() const
         {
-            return std::map<K, V, C>::begin();
+            return B::begin();
         }
 
-        typename SortedDictionary<K, V, C>::const_iterator end() const
+        typename SortedDictionary<K, V, C, B>::const_iterator end() const
         {
-            return std::map<K, V, C>::end();
+            return B::end();
         }
 
+        // copias: para recorrer una sola vez usar KeysView / ValuesView / Where, que no reservan memoria
         inline std::vector<K> Keys()
         {            
             std::vector<K> result;
+            result.reserve(B::size());
             for (auto kvp = this->begin(); kvp != this->end(); ++kvp)
                 result.push_back(kvp->first);
             return result;
@@ -62,24 +108,66 @@ namespace Collections
         inline std::vector<V> Values()
         {            
             std::vector<V> result;
+            result.reserve(B::size());
             for (auto kvp = this->begin(); kvp != this->end(); ++kvp)
                 result.push_back(kvp->second);
             return result;
         }
 
+        // vistas perezosas en orden de C (ver Dictionary::KeysView); válidas mientras no se modifique el diccionario
+        inline auto KeysView() const
+        {
+            return static_cast<const B &>(*this) | std::views::keys;
+        }
+
+        inline auto ValuesView()
+        {
+            return static_cast<B &>(*this) | std::views::values;
+        }
+
+        inline auto ValuesView() const
+        {
+            return static_cast<const B &>(*this) | std::views::values;
+        }
+
+        template <typename F>
+        inline auto Where(F condition)
+        {
+            return static_cast<B &>(*this) | std::views::filter(std::move(condition));
+        }
+
+        template <typename F>
+        inline auto Select(F selector)
+        {
+            return static_cast<B &>(*this) | std::views::transform(std::move(selector));
+        }
+
+        // los n primeros según C, p.ej. los mejores n niveles de un libro
+        inline auto Take(size_t n)
+        {
+            return static_cast<B &>(*this) | std::views::take(static_cast<std::ranges::range_difference_t<B>>(n));
+        }
+
         inline size_t Size() const
         {
-            return std::map<K, V, C>::size();
+            return B::size();
+        }
+
+        // ver Dictionary::MemoryUsage
+        inline size_t MemoryUsage(bool deep = false) const
+        {
+            const B &backend = *this;
+            return sizeof(*this) + ContainerMemoryUsage(backend) + (deep ? ElementsHeapSize(backend) : 0);
         }
 
         inline bool Any() const
         {
-            return !std::map<K, V, C>::empty();
+            return !B::empty();
         }
 
         inline void Clear()
         {
-            return std::map<K, V, C>::clear();
+            return B::clear();
         }
 
         const inline std::pair<K, V> First() const
@@ -95,15 +183,15 @@ namespace Collections
 
         inline bool TryRemove(const K &key)
         {
-            return std::map<K, V, C>::erase(key);
+            return B::erase(key);
         }
 
         inline bool TryRemove(const K &key, V &value)
         {            
-            if (auto result = std::map<K, V, C>::find(key); result != std::map<K, V, C>::end())
+            if (auto result = B::find(key); result != B::end())
             {
-                value = result->second;
-                std::map<K, V, C>::erase(key);
+                value = std::move(result->second);
+                B::erase(result);
                 return true;
             }
             return false;
@@ -111,10 +199,10 @@ namespace Collections
 
         inline bool TryRemove(const K &key, V *&value)
         {            
-            if (auto result = std::map<K, V, C>::find(key); result != std::map<K, V, C>::end())
+            if (auto result = B::find(key); result != B::end())
             {
                 value = &result->second;
-                std::map<K, V, C>::erase(key);
+                B::erase(key);
                 return true;
             }
             return false;
@@ -133,12 +221,12 @@ namespace Collections
 
         inline bool ContainsKey(const K &key)
         {
-            return std::map<K, V, C>::find(key) != std::map<K, V, C>::end();
+            return B::find(key) != B::end();
         }
 
         inline bool TryGetValue(const K &key, V &value)
         {            
-            if (auto result = std::map<K, V, C>::find(key); result != std::map<K, V, C>::end())
+            if (auto result = B::find(key); result != B::end())
             {
                 value = result->second;
                 return true;
@@ -148,7 +236,7 @@ namespace Collections
 
         inline bool TryGetValue(const K &key, V *&value)
         {            
-            if (auto result = std::map<K, V, C>::find(key); result != std::map<K, V, C>::end())
+            if (auto result = B::find(key); result != B::end())
             {
                 value = &result->second;
                 return true;
@@ -156,6 +244,33 @@ namespace Collections
             return false;
         }
 
+        // values[i] recibe una copia del valor de keys[i]; si la llave no existe values[i] no se toca
+        inline std::vector<bool> TryGetMany(std::span<const K> keys, std::span<V> values)
+        {
+            assert(values.size() >= keys.size());
+            std::vector<bool> result(keys.size());
+            this->FindMany(keys, [&](size_t i, V *value)
+                           {
+                if (value)
+                {
+                    values[i] = *value;
+                    result[i] = true;
+                } });
+            return result;
+        }
+
+        // values[i] apunta al valor de keys[i] o es nullptr; regresa cuántas llaves se encontraron (ver FindMany)
+        inline size_t TryGetMany(std::span<const K> keys, std::span<V *> values)
+        {
+            assert(values.size() >= keys.size());
+            size_t found_count = 0;
+            this->FindMany(keys, [&](size_t i, V *value)
+                           {
+                values[i] = value;
+                found_count += value != nullptr; });
+            return found_count;
+        }
+
         template <typename F>
         inline bool TryGetValue(const K &key, const F &action)
         {            
@@ -170,23 +285,40 @@ namespace Collections
         inline bool TryAdd(const K &key, const V &value)
         {
             // el emplace es mas efectivo pues no genera nueva copia
-            return std::map<K, V, C>::try_emplace(key, value).second;
+            return B::try_emplace(key, value).second;
+        }
+
+        inline bool TryAdd(const K &key, V &&value)
+        {
+            return B::try_emplace(key, std::move(value)).second;
+        }
+
+        // construye el valor en su lugar con args, sólo si la llave no existe
+        template <typename... Args>
+        inline bool TryEmplace(const K &key, Args &&...args)
+        {
+            return B::try_emplace(key, std::forward<Args>(args)...).second;
         }
 
         inline bool Add(const K &key, const V &value)
         {
-            return std::map<K, V, C>::insert_or_assign(key, value).second;
+            return B::insert_or_assign(key, value).second;
+        }
+
+        inline bool Add(const K &key, V &&value)
+        {
+            return B::insert_or_assign(key, std::move(value)).second;
         }
 
         template <typename F>
         inline V &GetOrAdd(const K &key, const F &add)
         {            
-            if (auto result = std::map<K, V, C>::find(key); result != std::map<K, V, C>::end())
+            if (auto result = B::find(key); result != B::end())
             {
                 return result->second;
             }
             
-            return std::map<K, V, C>::operator[](key) = add();
+            return B::operator[](key) = add();
             
         }
 
@@ -197,7 +329,7 @@ namespace Collections
 
         inline V &GetOrAddNew(const K &key)
         {            
-            if (auto result = std::map<K, V, C>::find(key); result != std::map<K, V, C>::end())
+            if (auto result = B::find(key); result != B::end())
             {
                 return result->second;
             }
@@ -211,7 +343,7 @@ namespace Collections
         template <typename F>
         inline V &GetOrAddOrNull(const K &key, const F &action)
         {            
-            if (auto result = std::map<K, V, C>::find(key); result != std::map<K, V, C>::end() && result->second)
+            if (auto result = B::find(key); result != B::end() && result->second)
             {
                 return result->second;
             }
@@ -227,6 +359,18 @@ namespace Collections
         }
 
     };
+
+    namespace pmr
+    {
+        template <typename K, typename V, typename C>
+        using SortedDictionary = Collections::SortedDictionary<K, V, C, std::pmr::map<K, V, C>>;
+    } // namespace pmr
+
+    namespace counted
+    {
+        template <typename K, typename V, typename C>
+        using SortedDictionary = Collections::SortedDictionary<K, V, C, std::map<K, V, C, CountingAllocator<std::pair<const K, V>>>>;
+    } // namespace counted
 } // namespace Collections
 
 #endif // __COLLECTIONS_SORTED_DICTIONARY
@@ -0,0 +1,154 @@
+#ifndef __COLLECTIONS_TIMING_WHEEL
+#define __COLLECTIONS_TIMING_WHEEL
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "MemoryUsage.hpp"
+
+namespace Collections
+{
+
+    // Rueda de tiempos jerárquica (4 niveles de 64 slots) para programar vencimientos en ticks
+    // - Schedule y cada vencimiento cuestan O(1) amortizado: un elemento baja a lo más 3 veces de nivel
+    // - Advance sólo toca los slots por los que pasa el tiempo, nunca recorre todo lo programado
+    // - el nivel l tiene slots de 64^l ticks: cubre hasta 64^4 ticks hacia adelante (con ticks de 1ms, ~4.6 horas);
+    //   los vencimientos más lejanos se guardan en el último slot y se reprograman al llegar a él
+    // - no hay cancelación: quien programa decide al vencer si el elemento sigue vigente (ver ConcurrentExpiringDictionary)
+    template <typename T>
+    class TimingWheel
+    {
+        static constexpr unsigned Bits = 6;
+        static constexpr uint64_t Slots = 1 << Bits, Mask = Slots - 1;
+        static constexpr unsigned Levels = 4;
+
+        struct Timer
+        {
+            T item;
+            uint64_t deadline;
+        };
+
+        std::array<std::array<std::vector<Timer>, Slots>, Levels> wheel;
+        uint64_t now;
+        size_t count = 0;
+
+        inline void Place(T &&item, uint64_t deadline)
+        {
+            auto delta = deadline > this->now ? deadline - this->now : 0;
+            unsigned level = 0;
+            while (level + 1 < Levels && delta >= (uint64_t(1) << (Bits * (level + 1))))
+                ++level;
+            // más allá del último nivel: al último slot alcanzable, desde ahí se vuelve a programar
+            auto at = level + 1 == Levels && delta >= (uint64_t(1) << (Bits * Levels)) ? this->now + (Mask << (Bits * level)) : std::max(deadline, this->now);
+            this->wheel[level][(at >> (Bits * level)) & Mask].push_back(Timer{std::move(item), deadline});
+        }
+
+        // baja los timers de un slot de nivel superior a los niveles de abajo
+        inline void Cascade(unsigned level)
+        {
+            auto timers = std::move(this->wheel[level][(this->now >> (Bits * level)) & Mask]);
+            this->wheel[level][(this->now >> (Bits * level)) & Mask].clear();
+            for (auto &timer : timers)
+                this->Place(std::move(timer.item), timer.deadline);
+        }
+
+    public:
+        explicit TimingWheel(uint64_t now = 0) : now(now) {}
+
+        inline uint64_t Now() const
+        {
+            return this->now;
+        }
+
+        inline size_t Size() const
+        {
+            return this->count;
+        }
+
+        inline bool Any() const
+        {
+            return this->count != 0;
+        }
+
+        // ver Dictionary::MemoryUsage; recorre los 256 slots (no los timers, salvo con deep)
+        inline size_t MemoryUsage(bool deep = false) const
+        {
+            size_t result = sizeof(*this);
+            for (auto &level : this->wheel)
+            {
+                for (auto &slot : level)
+                {
+                    result += ContainerMemoryUsage(slot);
+                    if (deep)
+                    {
+                        for (auto &timer : slot)
+                            result += HeapSizeOf(timer.item);
+                    }
+                }
+            }
+            return result;
+        }
+
+        // un deadline en el pasado vence en el siguiente Advance
+        inline void Schedule(T item, uint64_t deadline)
+        {
+            this->Place(std::move(item), deadline);
+            ++this->count;
+        }
+
+        // avanza hasta el tick `to` y llama expired(item, deadline) por cada timer vencido, en orden de tick;
+        // expired puede volver a llamar Schedule. Regresa cuántos timers vencieron
+        template <typename F>
+        size_t Advance(uint64_t to, const F &expired)
+        {
+            size_t result = 0;
+            // los vencidos al programar (deadline <= now) esperan en el slot actual
+            for (bool first = true; this->now < to || first; first = false)
+            {
+                if (!first)
+                {
+                    // sin timers no hay nada que recorrer tick por tick
+                    if (!this->count)
+                    {
+                        this->now = to;
+                        break;
+                    }
+
+                    ++this->now;
+                    for (unsigned level = Levels - 1; level > 0; --level)
+                    {
+                        if ((this->now & ((uint64_t(1) << (Bits * level)) - 1)) == 0)
+                            this->Cascade(level);
+                    }
+                }
+
+                auto &slot = this->wheel[0][this->now & Mask];
+                // expired puede programar en este mismo slot: se procesa por índice y se limpia al final
+                for (size_t i = 0; i < slot.size(); ++i)
+                {
+                    auto timer = std::move(slot[i]);
+                    --this->count;
+                    ++result;
+                    expired(std::move(timer.item), timer.deadline);
+                }
+                slot.clear();
+            }
+            return result;
+        }
+
+        inline void Clear()
+        {
+            for (auto &level : this->wheel)
+            {
+                for (auto &slot : level)
+                    slot.clear();
+            }
+            this->count = 0;
+        }
+    };
+} // namespace Collections
+
+#endif // __COLLECTIONS_TIMING_WHEEL
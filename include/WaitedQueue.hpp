@@ -1,14 +1,16 @@
 #ifndef __COLLECIONS_WAITED_QUEUE
 #define __COLLECIONS_WAITED_QUEUE
 
+#include <deque>
 #include <mutex>
 #include <condition_variable>
+#include <utility>
 
 using namespace std::literals::chrono_literals;
 namespace Collections
 {
-    template <typename T>
-    class WaitedQueue : private ConcurrentQueue<T>
+    template <typename T, typename C = std::deque<T>>
+    class WaitedQueue : private ConcurrentQueue<T, C>
     {
         std::mutex wait_mtx;
         std::unique_lock<std::mutex> wait_lck;
@@ -16,43 +18,77 @@ namespace Collections
 
     public:
         WaitedQueue() : wait_lck(this->wait_mtx) {}
+        explicit WaitedQueue(const typename C::allocator_type &allocator) : ConcurrentQueue<T, C>(allocator), wait_lck(this->wait_mtx) {}
         virtual ~WaitedQueue() { this->wait_event.notify_one(); }
 
         void Enqueue(const T &t)
         {
-            ConcurrentQueue<T>::Enqueue(t);
+            ConcurrentQueue<T, C>::Enqueue(t);
             this->wait_event.notify_one();
         }
 
+        void Enqueue(T &&t)
+        {
+            ConcurrentQueue<T, C>::Enqueue(std::move(t));
+            this->wait_event.notify_one();
+        }
+
+        template <typename... Args>
+        void Emplace(Args &&...args)
+        {
+            ConcurrentQueue<T, C>::Emplace(std::forward<Args>(args)...);
+            this->wait_event.notify_one();
+        }
+
+        inline size_t MemoryUsage(bool deep = false)
+        {
+            return sizeof(*this) - sizeof(ConcurrentQueue<T, C>) + ConcurrentQueue<T, C>::MemoryUsage(deep);
+        }
+
+        // una sola notificación para todo el lote
+        template <typename I>
+        size_t EnqueueRange(I first, I last)
+        {
+            auto count = ConcurrentQueue<T, C>::EnqueueRange(first, last);
+            if (count)
+                this->wait_event.notify_one();
+            return count;
+        }
+
         template <class Rep, class Period>
         bool TryDequeue(T *&t, std::chrono::duration<Rep, Period> const &timeout_duration)
         {
             this->wait_event.wait_for(this->wait_lck, timeout_duration);
-            return ConcurrentQueue<T>::TryDequeue(t);
+            return ConcurrentQueue<T, C>::TryDequeue(t);
         }
 
         template <class Rep, class Period>
         bool TryDequeue(T &t, std::chrono::duration<Rep, Period> const &timeout_duration)
         {
             this->wait_event.wait_for(this->wait_lck, timeout_duration);
-            return ConcurrentQueue<T>::TryDequeue(t);
+            return ConcurrentQueue<T, C>::TryDequeue(t);
         }
 
         template <typename F, class Rep, class Period>
         bool TryDequeue(const F &action, std::chrono::duration<Rep, Period> const &timeout_duration)
         {
             this->wait_event.wait_for(this->wait_lck, timeout_duration);
-            return ConcurrentQueue<T>::TryDequeue(action);
+            return ConcurrentQueue<T, C>::TryDequeue(action);
         }
 
         template <typename F, class Rep, class Period>
         void WhileTryDequeue(const F &action, std::chrono::duration<Rep, Period> const &timeout_duration)
         {
             this->wait_event.wait_for(this->wait_lck, timeout_duration);
-            ConcurrentQueue<T>::WhileTryDequeue(action);
+            ConcurrentQueue<T, C>::WhileTryDequeue(action);
         }
     };
 
+    namespace pmr
+    {
+        template <typename T>
+        using WaitedQueue = Collections::WaitedQueue<T, std::pmr::deque<T>>;
+    } // namespace pmr
 } // namespace Collections
 
 #endif // __COLLECIONS_WAITED_QUEUE
@@ -2,6 +2,15 @@
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
 
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <memory_resource>
+#include <numeric>
+#include <ranges>
+#include <random>
+#include <set>
 #include <thread>
 #include <boost/chrono.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
@@ -461,6 +470,2173 @@ BOOST_AUTO_TEST_CASE(DictionaryGetOrAddNew)
               { std::cerr << k.first << ' ' << *(k.second) << std::endl ; delete k.second ; });
 }
 
+BOOST_AUTO_TEST_CASE(ShardedDictionary)
+{
+    static const int NUM_THREADS = 8;
+    static const int NUM_REGISTERS = 100'000;
+
+    Collections::ShardedConcurrentDictionary<int, int> dict(16);
+    BOOST_CHECK_EQUAL(dict.ShardCount(), 16);
+
+    std::thread ThreadsDict[NUM_THREADS];
+    for (int t = 0; t < NUM_THREADS; ++t)
+    {
+        ThreadsDict[t] = std::thread([&dict, t]()
+                                     {
+                                         for (int i = t * NUM_REGISTERS; i < (t + 1) * NUM_REGISTERS; ++i)
+                                         {
+                                             dict.TryAdd(i, i);
+                                             dict.Incr(-1, 1);
+                                         } });
+    }
+
+    for (int t = 0; t < NUM_THREADS; ++t)
+        ThreadsDict[t].join();
+
+    BOOST_CHECK_EQUAL(dict.Size(), NUM_THREADS * NUM_REGISTERS + 1);
+    BOOST_CHECK_EQUAL(dict[-1], NUM_THREADS * NUM_REGISTERS);
+
+    int value;
+    BOOST_CHECK(dict.TryGetValue(1234, value));
+    BOOST_CHECK_EQUAL(value, 1234);
+    BOOST_CHECK(!dict.TryAdd(1234, 0));
+
+    BOOST_CHECK(dict.TryRemoveIf(1234, [](int &v)
+                                 { return v == 1234; }));
+    BOOST_CHECK(!dict.ContainsKey(1234));
+
+    BOOST_CHECK_EQUAL(dict.GetOrAdd(1234, []()
+                                    { return 4321; }),
+                      4321);
+
+    dict.AddOrUpdate(
+        1234, []()
+        { return 0; },
+        [](int &v)
+        { v++; });
+    BOOST_CHECK_EQUAL(dict[1234], 4322);
+
+    int64_t suma = 0;
+    dict.ForEach([&suma](auto &kvp)
+                 { suma += kvp.first >= 0 ? 1 : 0; });
+    BOOST_CHECK_EQUAL(suma, NUM_THREADS * NUM_REGISTERS);
+
+    dict.Clear();
+    BOOST_CHECK(!dict.Any());
+}
+
+template <typename D>
+int64_t ReadMostlyMilliseconds(D &dict)
+{
+    static const int NUM_READERS = 8;
+    static const int NUM_READS = 200'000;
+    static const int NUM_KEYS = 1'000;
+
+    for (int i = 0; i < NUM_KEYS; ++i)
+        dict.TryAdd(i, i);
+
+    auto now1 = boost::posix_time::microsec_clock::local_time();
+
+    std::atomic<bool> done = false;
+    std::thread writer([&dict, &done]()
+                       {
+                           for (int i = 0; !done; i = (i + 1) % NUM_KEYS)
+                               dict.AddOrUpdate(i, [i]() { return i; }, [](int &v) { v = v; }); });
+
+    // Boost.Test no es thread safe: los threads sólo cuentan, se revisa después del join
+    std::atomic<int> misses = 0;
+    std::thread readers[NUM_READERS];
+    for (auto &reader : readers)
+    {
+        reader = std::thread([&dict, &misses]()
+                             {
+                                 int value;
+                                 for (int i = 0; i < NUM_READS; ++i)
+                                 {
+                                     if (!dict.TryGetValue(i % NUM_KEYS, value))
+                                         ++misses;
+                                     if (!dict.ContainsKey(i % NUM_KEYS))
+                                         ++misses;
+                                 } });
+    }
+
+    for (auto &reader : readers)
+        reader.join();
+    done = true;
+    writer.join();
+    BOOST_CHECK_EQUAL(misses, 0);
+
+    return (boost::posix_time::microsec_clock::local_time() - now1).total_milliseconds();
+}
+
+BOOST_AUTO_TEST_CASE(SharedMutexDictionary)
+{
+    Collections::ConcurrentDictionary<int, int> exclusive;
+    Collections::ConcurrentDictionary<int, int, std::shared_mutex> shared;
+
+    auto exclusive_ms = ReadMostlyMilliseconds(exclusive);
+    auto shared_ms = ReadMostlyMilliseconds(shared);
+    std::cout << "ConcurrentDictionary std::mutex " << exclusive_ms << "ms vs std::shared_mutex " << shared_ms << "ms" << std::endl;
+
+    BOOST_CHECK_EQUAL(shared.Size(), exclusive.Size());
+    BOOST_CHECK_EQUAL(shared.Keys().size(), 1'000);
+
+    Collections::ConcurrentHashSet<std::string, std::shared_mutex> set;
+    set.Insert("uno");
+    BOOST_CHECK(set.Exists("uno"));
+    BOOST_CHECK(!set.Exists("dos"));
+    BOOST_CHECK_EQUAL(set.Size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(LockFreeDictionary)
+{
+    static const int NUM_THREADS = 8;
+    static const int NUM_REGISTERS = 10'000;
+
+    Collections::LockFreeDictionary<int64_t, int64_t> dict(NUM_THREADS * NUM_REGISTERS * 2);
+
+    // Boost.Test no es thread safe: los threads sólo cuentan, se revisa después del join
+    std::atomic<int> failures = 0;
+    std::thread ThreadsDict[NUM_THREADS];
+    for (int t = 0; t < NUM_THREADS; ++t)
+    {
+        ThreadsDict[t] = std::thread([&dict, &failures, t]()
+                                     {
+                                         for (int64_t i = t * NUM_REGISTERS + 1; i <= (t + 1) * NUM_REGISTERS; ++i)
+                                         {
+                                             if (!dict.TryAdd(i, i))
+                                                 ++failures;
+                                             dict.AddOrUpdate(-1, []() { return 1; }, [](int64_t &v) { v++; });
+                                         } });
+    }
+
+    for (int t = 0; t < NUM_THREADS; ++t)
+        ThreadsDict[t].join();
+    BOOST_CHECK_EQUAL(failures, 0);
+
+    BOOST_CHECK_EQUAL(dict.Size(), NUM_THREADS * NUM_REGISTERS + 1);
+
+    int64_t value;
+    BOOST_CHECK(dict.TryGetValue(-1, value));
+    BOOST_CHECK_EQUAL(value, NUM_THREADS * NUM_REGISTERS);
+
+    BOOST_CHECK(dict.TryGetValue(1234, value));
+    BOOST_CHECK_EQUAL(value, 1234);
+    BOOST_CHECK(!dict.TryAdd(1234, 1));
+
+    BOOST_CHECK(dict.TryRemove(1234, value));
+    BOOST_CHECK(!dict.ContainsKey(1234));
+    BOOST_CHECK(!dict.TryRemove(1234));
+    BOOST_CHECK_EQUAL(dict.GetOrAdd(1234, []()
+                                    { return 4321; }),
+                      4321);
+    BOOST_CHECK_EQUAL(dict.GetOrAdd(1234, []()
+                                    { return 1; }),
+                      4321);
+
+    BOOST_CHECK_EQUAL(dict.Keys().size(), dict.Size());
+
+    dict.Clear();
+    BOOST_CHECK(!dict.Any());
+    BOOST_CHECK(!dict.ContainsKey(1));
+
+    // llena : no hay slot libre para una llave nueva
+    Collections::LockFreeDictionary<int, int *> small(2);
+    int uno = 1, dos = 2;
+    BOOST_CHECK(small.TryAdd(1, &uno));
+    BOOST_CHECK(small.TryAdd(2, &dos));
+    BOOST_CHECK(!small.TryAdd(3, &dos));
+    BOOST_CHECK_THROW(small.GetOrAdd(3, [&dos]()
+                                     { return &dos; }),
+                      std::length_error);
+    BOOST_CHECK_THROW(small.AddOrUpdate(3, [&dos]()
+                                        { return &dos; }, [](int *&) {}),
+                      std::length_error);
+    BOOST_CHECK_THROW(small.Add(3, &dos), std::length_error);
+    BOOST_CHECK_EQUAL(small.Size(), 2);
+
+    // llave y valor reservados (0): fallan también en release, sin gastar slots ni contar
+    Collections::LockFreeDictionary<int, int> reserved(4);
+    BOOST_CHECK(!reserved.TryAdd(0, 5));
+    BOOST_CHECK(!reserved.TryAdd(1, 0));
+    BOOST_CHECK(!reserved.ContainsKey(0));
+    BOOST_CHECK(!reserved.ContainsKey(1));
+    BOOST_CHECK_EQUAL(reserved.Size(), 0);
+    BOOST_CHECK_THROW(reserved.Add(0, 5), std::invalid_argument);
+    BOOST_CHECK_THROW(reserved.Add(1, 0), std::invalid_argument);
+    BOOST_CHECK_THROW(reserved.GetOrAdd(0, []()
+                                        { return 5; }),
+                      std::invalid_argument);
+    BOOST_CHECK_THROW(reserved.GetOrAdd(1, []()
+                                        { return 0; }),
+                      std::invalid_argument);
+    BOOST_CHECK_THROW(reserved.AddOrUpdate(1, []()
+                                           { return 0; }, [](int &) {}),
+                      std::invalid_argument);
+    BOOST_CHECK_EQUAL(reserved.Size(), 0);
+    // ninguna de las anteriores le quitó lugar a las llaves válidas
+    for (int i = 1; i <= 4; ++i)
+        BOOST_CHECK(reserved.TryAdd(i, i));
+    BOOST_CHECK_EQUAL(reserved.Size(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(FlatHashMapBackend)
+{
+    // mismas operaciones contra std::unordered_map, incluyendo borrados (tumbas) y crecimiento
+    Collections::FlatHashMap<int64_t, int64_t> flat;
+    std::unordered_map<int64_t, int64_t> reference;
+
+    std::srand(1234);
+    for (int i = 0; i < 200'000; ++i)
+    {
+        int64_t key = std::rand() % 20'000;
+        switch (std::rand() % 3)
+        {
+        case 0:
+            BOOST_CHECK_EQUAL(flat.try_emplace(key, i).second, reference.try_emplace(key, i).second);
+            break;
+        case 1:
+            BOOST_CHECK_EQUAL(flat.erase(key), reference.erase(key));
+            break;
+        default:
+            BOOST_CHECK_EQUAL(flat.find(key) == flat.end(), reference.find(key) == reference.end());
+            break;
+        }
+    }
+
+    BOOST_CHECK_EQUAL(flat.size(), reference.size());
+    for (auto &[k, v] : flat)
+        BOOST_CHECK_EQUAL(reference[k], v);
+
+    auto copy = flat;
+    BOOST_CHECK_EQUAL(copy.size(), flat.size());
+    flat.clear();
+    BOOST_CHECK(flat.empty());
+    BOOST_CHECK(flat.begin() == flat.end());
+    BOOST_CHECK_EQUAL(copy.size(), reference.size());
+
+    Collections::Dictionary<std::string, int, Collections::FlatHashMap<std::string, int>> dict;
+    BOOST_CHECK(dict.TryAdd("uno", 1));
+    BOOST_CHECK(!dict.TryAdd("uno", 2));
+    BOOST_CHECK(dict.Add("dos", 2));
+    dict["tres"] = 3;
+    BOOST_CHECK_EQUAL(dict.Size(), 3);
+
+    int value;
+    BOOST_CHECK(dict.TryGetValue("dos", value));
+    BOOST_CHECK_EQUAL(value, 2);
+    BOOST_CHECK(dict.TryRemove("dos", value));
+    BOOST_CHECK(!dict.ContainsKey("dos"));
+    BOOST_CHECK_EQUAL(dict.Keys().size(), 2);
+
+    Collections::ConcurrentDictionary<int, int, std::mutex, Collections::FlatHashMap<int, int>> concurrent;
+    concurrent.TryAdd(0, 0);
+    BOOST_CHECK_EQUAL(concurrent.Incr(0, 5), 5);
+
+    Collections::ConcurrentHashSet<std::string, std::mutex, Collections::FlatHashSet<std::string>> set;
+    set.Insert("uno");
+    BOOST_CHECK(set.Exists("uno"));
+    BOOST_CHECK(set.TryRemove("uno"));
+    BOOST_CHECK(!set.Any());
+
+    // insertar un valor que vive en la misma tabla, pasando por varios crecimientos (igual que con std::unordered_map)
+    Collections::Dictionary<int, std::string, Collections::FlatHashMap<int, std::string>> self;
+    self.Add(0, std::string(40, 'x'));
+    for (int i = 1; i < 1000; ++i)
+        self.Add(i, self[i - 1]);
+    Collections::FlatHashMap<int, std::string> self_flat;
+    self_flat.try_emplace(0, std::string(40, 'y'));
+    for (int i = 1; i < 1000; ++i)
+        self_flat.try_emplace(i, self_flat.find(i - 1)->second);
+    for (int i = 0; i < 1000; ++i)
+    {
+        BOOST_REQUIRE_EQUAL(self[i], std::string(40, 'x'));
+        BOOST_REQUIRE_EQUAL(self_flat.find(i)->second, std::string(40, 'y'));
+    }
+
+    // búsquedas: nodos vs plano
+    {
+        static const int NUM_KEYS = 500'000;
+        Collections::Dictionary<std::string, int64_t> nodes;
+        Collections::Dictionary<std::string, int64_t, Collections::FlatHashMap<std::string, int64_t>> plain;
+        for (int64_t i = 0; i < NUM_KEYS; ++i)
+        {
+            nodes.TryAdd("SYM" + std::to_string(i), i);
+            plain.TryAdd("SYM" + std::to_string(i), i);
+        }
+
+        std::vector<std::string> keys;
+        for (int64_t i = 0; i < 2 * NUM_KEYS; ++i)
+            keys.push_back("SYM" + std::to_string((i * 104729) % NUM_KEYS));
+
+        auto lookups = [&keys](auto &dict)
+        {
+            int64_t found = 0, value;
+            auto now1 = boost::posix_time::microsec_clock::local_time();
+            for (auto &key : keys)
+                found += dict.TryGetValue(key, value);
+            BOOST_CHECK_EQUAL(found, keys.size());
+            return (boost::posix_time::microsec_clock::local_time() - now1).total_milliseconds();
+        };
+
+        auto nodes_ms = lookups(nodes);
+        auto plain_ms = lookups(plain);
+        std::cout << "Dictionary TryGetValue std::unordered_map " << nodes_ms << "ms vs FlatHashMap " << plain_ms << "ms" << std::endl;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(HeterogeneousLookup)
+{
+    // símbolos largos (sin SSO): con búsqueda heterogénea no se construye ningún std::string temporal
+    const char *buffer = "MEXBOLSA:WALMEX*:ORDINARIAS|MEXBOLSA:GFNORTEO:ORDINARIAS";
+    std::string_view walmex(buffer, 27), gfnorte(buffer + 28, 28);
+
+    Collections::Dictionary<std::string, int> dict;
+    BOOST_CHECK(dict.TryAdd(walmex, 1));
+    BOOST_CHECK(!dict.TryAdd(walmex, 2));
+    BOOST_CHECK(dict.ContainsKey(walmex));
+    BOOST_CHECK(dict.ContainsKey("MEXBOLSA:WALMEX*:ORDINARIAS"));
+    BOOST_CHECK(!dict.ContainsKey(gfnorte));
+
+    int value;
+    BOOST_CHECK(dict.TryGetValue(walmex, value));
+    BOOST_CHECK_EQUAL(value, 1);
+    BOOST_CHECK_EQUAL(dict.GetOrAdd(gfnorte, []()
+                                    { return 2; }),
+                      2);
+    BOOST_CHECK(dict.TryRemove(gfnorte, value));
+    BOOST_CHECK_EQUAL(value, 2);
+    BOOST_CHECK(dict.TryRemove(walmex));
+    BOOST_CHECK(!dict.Any());
+
+    Collections::ConcurrentDictionary<std::string, int> concurrent;
+    BOOST_CHECK(concurrent.TryAdd(walmex, 1));
+    BOOST_CHECK(concurrent.TryGetValue(walmex, value));
+    BOOST_CHECK(concurrent.TryRemove(walmex));
+
+    Collections::ShardedConcurrentDictionary<std::string, int> sharded;
+    BOOST_CHECK(sharded.TryAdd(std::string(walmex), 1));
+    BOOST_CHECK(sharded.ContainsKey(walmex)); // mismo shard para std::string y std::string_view
+    BOOST_CHECK(sharded.TryRemove(walmex));
+
+    Collections::ConcurrentHashSet<std::string> set;
+    BOOST_CHECK(set.TryInsert(walmex));
+    BOOST_CHECK(!set.TryInsert(walmex));
+    BOOST_CHECK(set.Exists(walmex));
+    BOOST_CHECK(!set.Exists(gfnorte));
+    BOOST_CHECK(set.TryRemove(walmex));
+
+    Collections::HashSet<std::string, Collections::FlatHashSet<std::string>> flat_set;
+    BOOST_CHECK(flat_set.TryInsert(gfnorte));
+    BOOST_CHECK(flat_set.Contains(gfnorte));
+    BOOST_CHECK(flat_set.TryRemove(gfnorte));
+}
+
+// mensaje grande que cuenta sus copias : por las rutas de move/emplace no debe copiarse nunca
+struct CountedMessage
+{
+    static inline int copies = 0;
+
+    int id = 0;
+    std::string payload;
+
+    CountedMessage() = default;
+    CountedMessage(int id, std::string payload) : id(id), payload(std::move(payload)) {}
+    CountedMessage(const CountedMessage &o) : id(o.id), payload(o.payload) { ++copies; }
+    CountedMessage(CountedMessage &&) = default;
+    CountedMessage &operator=(const CountedMessage &o)
+    {
+        id = o.id;
+        payload = o.payload;
+        ++copies;
+        return *this;
+    }
+    CountedMessage &operator=(CountedMessage &&) = default;
+};
+
+BOOST_AUTO_TEST_CASE(MoveAndEmplace)
+{
+    CountedMessage::copies = 0;
+    const std::string payload(256, 'x');
+
+    Collections::WaitedQueue<CountedMessage> queue;
+    queue.Enqueue(CountedMessage(1, payload));
+    queue.Emplace(2, payload);
+
+    CountedMessage message;
+    BOOST_CHECK(queue.TryDequeue(message, 1ms));
+    BOOST_CHECK_EQUAL(message.id, 1);
+    BOOST_CHECK_EQUAL(message.payload, payload);
+
+    Collections::Dictionary<int, CountedMessage> dict;
+    BOOST_CHECK(dict.TryAdd(message.id, std::move(message)));
+    BOOST_CHECK(dict.TryEmplace(3, 3, payload));
+    BOOST_CHECK(!dict.TryEmplace(3, 4, payload));
+    dict.Add(4, CountedMessage(4, payload));
+    BOOST_CHECK(dict.TryRemove(3, message));
+    BOOST_CHECK_EQUAL(message.id, 3);
+    BOOST_CHECK_EQUAL(message.payload, payload);
+
+    Collections::ConcurrentDictionary<int, CountedMessage> concurrent;
+    BOOST_CHECK(concurrent.TryEmplace(5, 5, payload));
+    BOOST_CHECK(concurrent.TryRemove(5, message));
+
+    Collections::Queue<CountedMessage> plain;
+    plain.Emplace(6, payload);
+    auto dequeued = plain.Dequeue();
+    BOOST_CHECK(dequeued && dequeued->id == 6);
+
+    Collections::List<CountedMessage> list;
+    list.Emplace(7, payload);
+    list.Push(CountedMessage(8, payload));
+    BOOST_CHECK(list.Pop(message));
+    BOOST_CHECK_EQUAL(message.id, 8);
+
+    Collections::ConcurrentList<CountedMessage> concurrent_list;
+    concurrent_list.Emplace(9, payload);
+    BOOST_CHECK(concurrent_list.Pop(message));
+    BOOST_CHECK_EQUAL(message.id, 9);
+
+    Collections::SortedDictionary<int, CountedMessage, std::less<int>> sorted;
+    BOOST_CHECK(sorted.TryEmplace(10, 10, payload));
+    BOOST_CHECK(sorted.TryRemove(10, message));
+
+    Collections::HashSet<std::string> set;
+    BOOST_CHECK(set.Emplace(payload.data(), 16));
+    BOOST_CHECK(!set.TryInsert(std::string(payload.data(), 16)));
+
+    std::unique_ptr<int> owned;
+    Collections::ConcurrentQueue<std::unique_ptr<int>> pointers;
+    pointers.Enqueue(std::make_unique<int>(11));
+    BOOST_CHECK(pointers.TryDequeue(owned));
+    BOOST_CHECK_EQUAL(*owned, 11);
+
+    BOOST_CHECK_EQUAL(CountedMessage::copies, 0);
+}
+
+// mutex que cuenta cuántas veces se bloquea (en total, entre todas sus instancias)
+struct CountingMutex : std::mutex
+{
+    static inline int locks = 0;
+
+    void lock()
+    {
+        std::mutex::lock();
+        ++locks;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(BatchOperations)
+{
+    std::vector<std::pair<int, std::string>> snapshot;
+    for (int i = 0; i < 1000; ++i)
+        snapshot.emplace_back(i, std::to_string(i));
+
+    Collections::ConcurrentDictionary<int, std::string, CountingMutex> dict;
+    dict.TryAdd(10, "10");
+    auto added = dict.TryAddRange(snapshot.begin(), snapshot.end());
+    BOOST_CHECK_EQUAL(added.size(), 1000);
+    BOOST_CHECK(!added[10] && added[0] && added[999]);
+    BOOST_CHECK_EQUAL(dict.Size(), 1000);
+
+    std::vector<int> keys{5, 2000, 999};
+    std::vector<std::string> values(keys.size());
+    auto found = dict.TryGetMany(keys, values);
+    BOOST_CHECK(found[0] && !found[1] && found[2]);
+    BOOST_CHECK_EQUAL(values[0], "5");
+    BOOST_CHECK(values[1].empty());
+    BOOST_CHECK_EQUAL(values[2], "999");
+
+    auto removed = dict.RemoveRange(keys.begin(), keys.end());
+    BOOST_CHECK(removed[0] && !removed[1] && removed[2]);
+    BOOST_CHECK_EQUAL(dict.Size(), 998);
+
+    std::vector<std::pair<int, std::string>> updates{{5, "five"}, {6, "six"}};
+    auto inserted = dict.AddRange(std::make_move_iterator(updates.begin()), std::make_move_iterator(updates.end()));
+    BOOST_CHECK(inserted[0] && !inserted[1]);
+    BOOST_CHECK_EQUAL(dict[6], "six");
+
+    Collections::ShardedConcurrentDictionary<int, std::string> sharded(8);
+    BOOST_CHECK_EQUAL(std::count(added.begin(), added.end(), true), 999);
+    added = sharded.TryAddRange(snapshot.begin(), snapshot.end());
+    BOOST_CHECK_EQUAL(std::count(added.begin(), added.end(), true), 1000);
+    added = sharded.TryAddRange(snapshot.begin() + 500, snapshot.begin() + 502);
+    BOOST_CHECK(!added[0] && !added[1]);
+    found = sharded.TryGetMany(keys, values);
+    BOOST_CHECK(found[0] && !found[1] && found[2]);
+    BOOST_CHECK_EQUAL(values[0], "5");
+    removed = sharded.RemoveRange(keys.begin(), keys.end());
+    BOOST_CHECK(removed[0] && !removed[1] && removed[2]);
+    BOOST_CHECK_EQUAL(sharded.Size(), 998);
+
+    Collections::Dictionary<int, std::string, Collections::FlatHashMap<int, std::string>> flat;
+    added = flat.TryAddRange(snapshot.begin(), snapshot.end());
+    BOOST_CHECK_EQUAL(flat.Size(), 1000);
+    std::vector<std::string *> pointers(keys.size());
+    BOOST_CHECK_EQUAL(flat.TryGetMany(keys, pointers), 2);
+    BOOST_CHECK(pointers[0] && *pointers[0] == "5" && !pointers[1]);
+
+    Collections::ConcurrentHashSet<int, CountingMutex> set;
+    auto fresh = set.InsertRange(keys.begin(), keys.end());
+    BOOST_CHECK(fresh[0] && fresh[1] && fresh[2]);
+    fresh = set.InsertRange(keys.begin(), keys.end());
+    BOOST_CHECK(!fresh[0] && !fresh[1] && !fresh[2]);
+
+    Collections::WaitedQueue<int> queue;
+    BOOST_CHECK_EQUAL(queue.EnqueueRange(keys.begin(), keys.end()), 3);
+    int value;
+    BOOST_CHECK(queue.TryDequeue(value, 1ms));
+    BOOST_CHECK_EQUAL(value, 5);
+
+    // una sola sección crítica por lote
+    Collections::ConcurrentDictionary<int, std::string, CountingMutex> counted;
+    CountingMutex::locks = 0;
+    counted.AddRange(snapshot.begin(), snapshot.end());
+    counted.TryGetMany(keys, values);
+    counted.RemoveRange(keys.begin(), keys.end());
+    BOOST_CHECK_EQUAL(CountingMutex::locks, 3);
+    BOOST_CHECK_EQUAL(counted.Size(), 998);
+}
+
+BOOST_AUTO_TEST_CASE(DictionarySnapshot)
+{
+    Collections::ConcurrentDictionary<int, std::string> dict;
+    for (int i = 0; i < 1000; ++i)
+        dict.TryAdd(i, std::to_string(i));
+
+    auto snapshot = dict.Snapshot();
+    dict.TryRemove(0);
+    dict.Add(1, "uno");
+    dict.TryAdd(1000, "1000");
+
+    // la foto no ve los cambios posteriores
+    BOOST_CHECK_EQUAL(snapshot.Size(), 1000);
+    BOOST_CHECK(snapshot.ContainsKey(0));
+    BOOST_CHECK(!snapshot.ContainsKey(1000));
+    std::string value;
+    BOOST_CHECK(snapshot.TryGetValue(1, value));
+    BOOST_CHECK_EQUAL(value, "1");
+    BOOST_CHECK_EQUAL(std::distance(snapshot.begin(), snapshot.end()), 1000);
+
+    // se puede recorrer mientras otros threads escriben
+    std::atomic<bool> done = false;
+    std::thread writer([&dict, &done]()
+                       {
+        for (int i = 2000; !done; ++i)
+            dict.Add(i % 5000, "x"); });
+    size_t sum = 0;
+    for (auto &kvp : snapshot)
+        sum += kvp.first;
+    BOOST_CHECK_EQUAL(sum, 999 * 1000 / 2);
+
+    // por cubetas: cada llave presente durante todo el recorrido se ve al menos una vez
+    std::set<int> seen;
+    dict.ForEachChunked([&seen](auto &kvp)
+                        { seen.insert(kvp.first); },
+                        64);
+    done = true;
+    writer.join();
+    for (int i = 1; i <= 1000; ++i)
+        BOOST_CHECK(seen.count(i));
+
+    Collections::ShardedConcurrentDictionary<std::string, int> sharded(8);
+    for (int i = 0; i < 100; ++i)
+        sharded.TryAdd(std::to_string(i), i);
+    auto sharded_snapshot = sharded.Snapshot();
+    sharded.Clear();
+    BOOST_CHECK_EQUAL(sharded_snapshot.Size(), 100);
+    BOOST_CHECK_EQUAL(sharded_snapshot.Keys().size(), 100);
+    int number;
+    BOOST_CHECK(sharded_snapshot.TryGetValue(std::string_view("42"), number));
+    BOOST_CHECK_EQUAL(number, 42);
+    BOOST_CHECK(!sharded_snapshot.ContainsKey("100"));
+}
+
+// memory_resource que cuenta las peticiones que le llegan
+struct CountingResource : std::pmr::memory_resource
+{
+    size_t allocations = 0;
+    std::pmr::memory_resource *upstream = std::pmr::new_delete_resource();
+
+    void *do_allocate(size_t bytes, size_t alignment) override
+    {
+        ++allocations;
+        return upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override
+    {
+        upstream->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &o) const noexcept override
+    {
+        return this == &o;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(PmrContainers)
+{
+    CountingResource counting;
+    {
+        // todos los nodos salen de la arena: al resource de abajo sólo le llegan unos cuantos bloques grandes
+        std::pmr::monotonic_buffer_resource arena(&counting);
+        Collections::pmr::Dictionary<int, int> dict(&arena);
+        Collections::pmr::SortedDictionary<int, int, std::less<int>> sorted(&arena);
+        Collections::pmr::HashSet<int> set(&arena);
+        Collections::pmr::List<int> list(&arena);
+        Collections::pmr::Queue<int> queue(&arena);
+        for (int i = 0; i < 10000; ++i)
+        {
+            dict.TryAdd(i, i);
+            sorted.TryAdd(i, i);
+            set.Insert(i);
+            list.Push(i);
+            queue.Enqueue(i);
+        }
+        BOOST_CHECK_EQUAL(dict.Size(), 10000);
+        BOOST_CHECK_EQUAL(sorted.FirstKey(), 0);
+        BOOST_CHECK(set.Contains(9999));
+        BOOST_CHECK_EQUAL(list.Size(), 10000);
+        BOOST_CHECK_EQUAL(queue.Size(), 10000);
+        BOOST_CHECK_LT(counting.allocations, 100);
+    }
+
+    std::pmr::unsynchronized_pool_resource pool(&counting);
+    Collections::pmr::ConcurrentDictionary<std::string, int, std::shared_mutex> concurrent(&pool);
+    Collections::pmr::ConcurrentHashSet<int> concurrent_set(&pool);
+    Collections::pmr::ConcurrentList<int> concurrent_list(&pool);
+    Collections::pmr::WaitedQueue<int> waited(&pool);
+    BOOST_CHECK(concurrent.TryAdd("ABCDE", 1));
+    BOOST_CHECK(concurrent.ContainsKey(std::string_view("ABCDE")));
+    BOOST_CHECK(concurrent_set.TryInsert(1));
+    concurrent_list.Push(1);
+    waited.Enqueue(1);
+    int value;
+    BOOST_CHECK(waited.TryDequeue(value, 1ms));
+
+    // mapas por petición: arena monotónica vs allocator default
+    auto requests = [](auto make)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int request = 0; request < 200; ++request)
+        {
+            auto run = make();
+            for (int i = 0; i < 1000; ++i)
+                run(i);
+        }
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+    auto with_default = requests([]()
+                                 { return [dict = std::make_shared<Collections::SortedDictionary<int, int, std::less<int>>>()](int i)
+                                   { dict->TryAdd(i, i); }; });
+    struct ArenaRequest
+    {
+        std::pmr::monotonic_buffer_resource arena{64 * 1024};
+        Collections::pmr::SortedDictionary<int, int, std::less<int>> dict{&arena};
+    };
+    auto with_arena = requests([]()
+                               { return [request = std::make_shared<ArenaRequest>()](int i)
+                                 { request->dict.TryAdd(i, i); }; });
+    std::cout << "SortedDictionary por petición std::allocator " << with_default << "ms vs monotonic_buffer_resource " << with_arena << "ms" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(CounterDictionary)
+{
+    Collections::CounterDictionary<std::string> counters;
+    counters.Incr("WALMEX");
+    counters.Incr(std::string_view("WALMEX"), 4);
+    BOOST_CHECK_EQUAL(counters.Read("WALMEX"), 5);
+    BOOST_CHECK_EQUAL(counters.Read("GFNORTEO"), 0);
+    BOOST_CHECK(!counters.ContainsKey("GFNORTEO"));
+
+    const int threads = 4, increments = 250000;
+    auto &walmex = counters.GetCounter("WALMEX");
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+        workers.emplace_back([&counters, &walmex]()
+                             {
+            for (int i = 0; i < increments; ++i)
+            {
+                walmex.Incr();
+                counters.Incr("GFNORTEO", 2);
+            } });
+    for (auto &worker : workers)
+        worker.join();
+
+    BOOST_CHECK_EQUAL(counters.Read("WALMEX"), 5 + threads * increments);
+    auto snapshot = counters.Snapshot();
+    BOOST_CHECK_EQUAL(snapshot.size(), 2);
+    BOOST_CHECK_EQUAL(snapshot["GFNORTEO"], 2 * threads * increments);
+
+    counters.Clear();
+    BOOST_CHECK_EQUAL(counters.Size(), 2);
+    walmex.Incr();
+    BOOST_CHECK_EQUAL(counters.Read("WALMEX"), 1);
+
+    // throughput: handle por celdas vs ConcurrentDictionary::Incr con el mutex global
+    auto measure = [threads](const auto &increment)
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t)
+            workers.emplace_back([&increment]()
+                                 {
+                for (int i = 0; i < increments; ++i)
+                    increment(); });
+        for (auto &worker : workers)
+            worker.join();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+    Collections::ConcurrentDictionary<std::string, int64_t> locked;
+    auto with_mutex = measure([&locked]()
+                              { locked.Incr("WALMEX", 1); });
+    auto with_cells = measure([&walmex]()
+                              { walmex.Incr(); });
+    counters.Clear();
+    auto with_key = measure([&counters]()
+                            { counters.Incr("WALMEX"); });
+    BOOST_CHECK_EQUAL(locked["WALMEX"], threads * increments);
+    BOOST_CHECK_EQUAL(counters.Read("WALMEX"), threads * increments);
+    std::cout << "Incr " << threads << " threads ConcurrentDictionary " << with_mutex << "ms vs CounterDictionary handle " << with_cells
+              << "ms, llave " << with_key << "ms" << std::endl;
+
+    // el cache por thread es por diccionario: uno nuevo (quizá en la misma dirección) no ve los handles del anterior
+    for (int round = 0; round < 3; ++round)
+    {
+        auto other = std::make_unique<Collections::CounterDictionary<std::string>>(2);
+        other->Incr("WALMEX", round + 1);
+        other->Incr(std::string("WALMEX"));
+        BOOST_CHECK_EQUAL(other->Read("WALMEX"), round + 2);
+        BOOST_CHECK_EQUAL(other->Size(), 1);
+    }
+    BOOST_CHECK_EQUAL(counters.Read("WALMEX"), threads * increments);
+}
+
+BOOST_AUTO_TEST_CASE(IncrementalRehash)
+{
+    // mismas operaciones aleatorias contra std::unordered_map, cruzando varias migraciones
+    Collections::Dictionary<int, int, Collections::IncrementalHashMap<int, int>> dict;
+    std::unordered_map<int, int> expected;
+    std::mt19937 random(7);
+    for (int i = 0; i < 200000; ++i)
+    {
+        int key = random() % 50000, value = random();
+        switch (random() % 4)
+        {
+        case 0:
+            BOOST_REQUIRE_EQUAL(dict.TryAdd(key, value), expected.try_emplace(key, value).second);
+            break;
+        case 1:
+            BOOST_REQUIRE_EQUAL(dict.Add(key, value), expected.insert_or_assign(key, value).second);
+            break;
+        case 2:
+            BOOST_REQUIRE_EQUAL(dict.TryRemove(key), expected.erase(key) > 0);
+            break;
+        default:
+            int found;
+            BOOST_REQUIRE_EQUAL(dict.TryGetValue(key, found), expected.count(key) > 0);
+            if (expected.count(key))
+                BOOST_REQUIRE_EQUAL(found, expected[key]);
+        }
+    }
+    BOOST_CHECK_EQUAL(dict.Size(), expected.size());
+    size_t visited = 0;
+    dict.ForEach([&](auto &kvp)
+                 { ++visited;
+                   BOOST_REQUIRE_EQUAL(kvp.second, expected[kvp.first]); });
+    BOOST_CHECK_EQUAL(visited, expected.size());
+
+    Collections::ConcurrentDictionary<std::string, int, std::shared_mutex, Collections::IncrementalHashMap<std::string, int>> concurrent;
+    concurrent.SetMaxLoadFactor(0.75);
+    concurrent.Reserve(1000);
+    for (int i = 0; i < 5000; ++i)
+        concurrent.TryAdd(std::to_string(i), i);
+    BOOST_CHECK(concurrent.ContainsKey(std::string_view("4999")));
+    BOOST_CHECK_EQUAL(concurrent.Snapshot().Size(), 5000);
+    for (int i = 100; i < 5000; ++i)
+        concurrent.TryRemove(std::to_string(i));
+    concurrent.ShrinkToFit();
+    BOOST_CHECK_EQUAL(concurrent.Size(), 100);
+
+    Collections::ShardedConcurrentDictionary<int, int> sharded(4);
+    sharded.Reserve(10000);
+    sharded.SetMaxLoadFactor(0.5);
+    sharded.ShrinkToFit();
+
+    // latencia por inserción mientras la tabla crece: el rehash de golpe aparece en el máximo
+    auto latencies = [](auto &dictionary)
+    {
+        std::vector<int64_t> nanos;
+        nanos.reserve(2000000);
+        for (int i = 0; i < 2000000; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            dictionary.TryAdd(i, i);
+            nanos.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::sort(nanos.begin(), nanos.end());
+        return std::make_pair(nanos[nanos.size() * 999 / 1000], nanos.back());
+    };
+    Collections::Dictionary<int, int> node_based;
+    Collections::Dictionary<int, int, Collections::IncrementalHashMap<int, int>> incremental;
+    auto [node_p999, node_max] = latencies(node_based);
+    auto [incremental_p999, incremental_max] = latencies(incremental);
+    std::cout << "TryAdd p99.9/max std::unordered_map " << node_p999 << "/" << node_max / 1000 << "us vs IncrementalHashMap "
+              << incremental_p999 << "/" << incremental_max / 1000 << "us" << std::endl;
+}
+
+// reloj falso para probar vencimientos sin esperar
+struct ManualClock
+{
+    using duration = std::chrono::milliseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<ManualClock>;
+    static constexpr bool is_steady = true;
+
+    static inline time_point current{std::chrono::hours(1)};
+
+    static time_point now()
+    {
+        return current;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(TimingWheel)
+{
+    // vencimientos en todos los niveles, en orden de tick
+    Collections::TimingWheel<int> wheel(100);
+    std::vector<uint64_t> deadlines{100, 101, 163, 164, 5000, 300000, 20000000, 99};
+    for (size_t i = 0; i < deadlines.size(); ++i)
+        wheel.Schedule(i, deadlines[i]);
+    BOOST_CHECK_EQUAL(wheel.Size(), deadlines.size());
+
+    std::vector<std::pair<int, uint64_t>> fired;
+    auto record = [&](int item, uint64_t deadline)
+    {
+        fired.emplace_back(item, wheel.Now());
+        BOOST_CHECK_LE(deadline, wheel.Now());
+    };
+    BOOST_CHECK_EQUAL(wheel.Advance(100, record), 2);
+    BOOST_CHECK_EQUAL(wheel.Advance(163, record), 2);
+    BOOST_CHECK_EQUAL(fired.back().second, 163);
+    BOOST_CHECK_EQUAL(wheel.Advance(20000000, record), 4);
+    for (auto &[item, tick] : fired)
+        BOOST_CHECK_EQUAL(tick, std::max<uint64_t>(deadlines[item], 100));
+    BOOST_CHECK(!wheel.Any());
+}
+
+BOOST_AUTO_TEST_CASE(ExpiringDictionary)
+{
+    using namespace std::chrono;
+    Collections::ConcurrentExpiringDictionary<std::string, int, ManualClock> sessions(milliseconds(100));
+    BOOST_CHECK(sessions.TryAdd("A", 1));
+    BOOST_CHECK(!sessions.TryAdd("A", 2));
+    BOOST_CHECK(sessions.TryAdd("B", 2, milliseconds(1000)));
+    sessions.AddOrUpdate("C", []()
+                         { return 3; }, [](int &v)
+                         { ++v; });
+
+    ManualClock::current += milliseconds(60);
+    BOOST_CHECK(sessions.Touch("A")); // vence ahora a los 160ms
+    ManualClock::current += milliseconds(50);
+
+    int value;
+    BOOST_CHECK(sessions.TryGetValue("A", value));
+    BOOST_CHECK(!sessions.ContainsKey("C"));
+    std::vector<std::string> expired;
+    BOOST_CHECK_EQUAL(sessions.RemoveExpired([&expired](const std::string &key, int &)
+                                             { expired.push_back(key); }),
+                      1);
+    BOOST_CHECK(expired == std::vector<std::string>{"C"});
+    BOOST_CHECK_EQUAL(sessions.Size(), 2);
+
+    ManualClock::current += milliseconds(50);
+    BOOST_CHECK(!sessions.ContainsKey("A"));
+    BOOST_CHECK(sessions.Add("A", 10)); // vencida: cuenta como nueva
+    milliseconds ttl{0};
+    BOOST_CHECK(sessions.TryGetTimeToLive("A", ttl));
+    BOOST_CHECK_EQUAL(ttl.count(), 100);
+    BOOST_CHECK(sessions.TryRemove("A"));
+
+    // la limpieza sólo toca las vencidas
+    for (int i = 0; i < 10000; ++i)
+        sessions.TryAdd(std::to_string(i), i, milliseconds(i < 10 ? 5 : 100000));
+    ManualClock::current += milliseconds(10);
+    BOOST_CHECK_EQUAL(sessions.RemoveExpired(), 10);
+    BOOST_CHECK_EQUAL(sessions.Size(), 9990 + 1);
+    ManualClock::current += milliseconds(1000);
+    BOOST_CHECK_EQUAL(sessions.RemoveExpired(), 1);
+    BOOST_CHECK_EQUAL(sessions.Keys().size(), 9990);
+}
+
+BOOST_AUTO_TEST_CASE(ClockCache)
+{
+    Collections::ClockCache<int, std::string> cache(100);
+    for (int i = 0; i < 100; ++i)
+        BOOST_CHECK(cache.TryAdd(i, std::to_string(i)));
+    BOOST_CHECK(!cache.TryAdd(5, "otro"));
+
+    // 20 llaves calientes se reusan mientras pasa un barrido de llaves que nunca se repiten
+    std::string value;
+    int hot_hits = 0;
+    for (int i = 0; i < 10000; ++i)
+    {
+        if (cache.TryGetValue(i % 20, value))
+            ++hot_hits;
+        else
+            cache.TryAdd(i % 20, std::to_string(i % 20));
+        cache.GetOrAdd(100000 + i, [i]()
+                       { return std::to_string(i); });
+    }
+    BOOST_CHECK_EQUAL(cache.Size(), 100);
+    BOOST_CHECK_GE(hot_hits, 9900);
+    auto stats = cache.Stats();
+    BOOST_CHECK_EQUAL(stats.hits, hot_hits);
+    BOOST_CHECK_EQUAL(stats.misses, 10000 - hot_hits + 10000);
+    BOOST_CHECK_EQUAL(stats.evictions, stats.insertions - 100);
+
+    BOOST_CHECK(cache.TryRemove(1));
+    BOOST_CHECK(!cache.ContainsKey(1));
+    BOOST_CHECK(cache.Add(1, "uno"));
+    BOOST_CHECK(!cache.Add(1, "one"));
+    BOOST_CHECK(cache.TryGetValue(1, value) && value == "one");
+
+    // capacidad en bytes
+    auto bytes = [](const int &, const std::string &s)
+    { return s.size(); };
+    Collections::ClockCache<int, std::string, decltype(bytes)> by_size(1000, bytes);
+    BOOST_CHECK(!by_size.TryAdd(0, std::string(1001, 'x')));
+    for (int i = 0; i < 100; ++i)
+        by_size.TryAdd(i, std::string(100, 'x'));
+    BOOST_CHECK_EQUAL(by_size.Size(), 10);
+    BOOST_CHECK_LE(by_size.Weight(), 1000);
+    // más grande que todo el cache: se regresa pero no se guarda ni desaloja nada
+    BOOST_CHECK_EQUAL(by_size.GetOrAdd(5000, []()
+                                       { return std::string(2000, 'y'); })
+                          .size(),
+                      2000);
+    BOOST_CHECK(!by_size.ContainsKey(5000));
+    BOOST_CHECK_EQUAL(by_size.Size(), 10);
+    // reemplazar con un valor demasiado grande no tira el anterior
+    std::string kept;
+    BOOST_CHECK(!by_size.Add(99, std::string(1001, 'z')));
+    BOOST_CHECK(by_size.TryGetValue(99, kept) && kept == std::string(100, 'x'));
+    std::string smaller(50, 'w');
+    BOOST_CHECK(!by_size.Add(99, std::move(smaller)));
+    BOOST_CHECK(by_size.TryGetValue(99, kept) && kept == std::string(50, 'w'));
+    BOOST_CHECK_LE(by_size.Weight(), 1000);
+
+    // la capacidad se reparte exacta entre los shards
+    Collections::ConcurrentClockCache<int, int> exact(1001, 8);
+    for (int i = 0; i < 100000; ++i)
+        exact.TryAdd(i, i);
+    BOOST_CHECK_EQUAL(exact.Size(), 1001);
+    BOOST_CHECK_LE((Collections::ConcurrentClockCache<int, int>(100).ShardCount()), 2);
+    Collections::ConcurrentClockCache<int, std::string, decltype(bytes)> sharded_bytes(1000, 4, bytes);
+    BOOST_CHECK_EQUAL(sharded_bytes.MaxEntryWeight(), 250);
+    BOOST_CHECK(!sharded_bytes.TryAdd(1, std::string(300, 'x')));
+    BOOST_CHECK(sharded_bytes.TryAdd(1, std::string(250, 'x')));
+    BOOST_CHECK(!sharded_bytes.Add(1, std::string(300, 'y')));
+    BOOST_CHECK(sharded_bytes.ContainsKey(1));
+
+    Collections::ConcurrentClockCache<int, int> concurrent(1000, 8);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t)
+        workers.emplace_back([&concurrent, t]()
+                             {
+            for (int i = 0; i < 20000; ++i)
+                concurrent.GetOrAdd(i % 2 ? i % 500 : 1000 + i * 4 + t, [i]()
+                                    { return i; }); });
+    for (auto &worker : workers)
+        worker.join();
+    BOOST_CHECK_LE(concurrent.Size(), 1000);
+    auto totals = concurrent.Stats();
+    BOOST_CHECK_EQUAL(totals.hits + totals.misses, 80000);
+    BOOST_CHECK_EQUAL(totals.insertions - totals.evictions, concurrent.Size());
+    std::cout << "ConcurrentClockCache hit ratio " << totals.HitRatio() << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(ParallelOperations)
+{
+    // cada operación paralela contra su versión secuencial, con cubetas (unordered_map) y sin ellas (flat)
+    auto check = [](auto &dict)
+    {
+        for (int64_t i = 0; i < 100000; ++i)
+            dict.TryAdd(i, i);
+
+        dict.ParallelTransform([](const int64_t &key, const int64_t &value)
+                               { return value * 2 + (key & 1); },
+                               4);
+        dict.ParallelForEach([](auto &kvp)
+                             { kvp.second += 1; },
+                             4);
+        int64_t sequential = 0;
+        dict.ForEach([&](auto &kvp)
+                     { sequential += kvp.second; });
+        BOOST_CHECK_EQUAL(sequential, 100000LL * 99999 + 50000 + 100000);
+        BOOST_CHECK_EQUAL(dict.Reduce(int64_t(0), [](const auto &kvp)
+                                      { return kvp.second; },
+                                      std::plus<int64_t>(), 4),
+                          sequential);
+        BOOST_CHECK_EQUAL(dict.Reduce(std::string("x"), [](const auto &) { return std::string(); }, std::plus<std::string>(), 4), "x");
+
+        auto keys = dict.ParallelKeys([](const int64_t &key)
+                                      { return key % 3 == 0; },
+                                      4);
+        std::sort(keys.begin(), keys.end());
+        BOOST_CHECK_EQUAL(keys.size(), 33334);
+        BOOST_CHECK_EQUAL(keys.back(), 99999);
+        BOOST_CHECK(std::adjacent_find(keys.begin(), keys.end()) == keys.end());
+
+        // la primera excepción de un worker llega al que llama
+        BOOST_CHECK_THROW(dict.ParallelForEach([](auto &kvp)
+                                               { if (kvp.first == 500) throw std::runtime_error("boom"); },
+                                               4),
+                          std::runtime_error);
+    };
+    Collections::Dictionary<int64_t, int64_t> dict;
+    check(dict);
+    Collections::Dictionary<int64_t, int64_t, Collections::FlatHashMap<int64_t, int64_t>> flat;
+    check(flat);
+    Collections::ConcurrentDictionary<int64_t, int64_t, std::shared_mutex> concurrent;
+    check(concurrent);
+    Collections::ShardedConcurrentDictionary<int64_t, int64_t> sharded;
+    check(sharded);
+
+    Collections::Dictionary<int64_t, int64_t> empty;
+    BOOST_CHECK_EQUAL(empty.Reduce(int64_t(7), [](const auto &kvp)
+                                   { return kvp.second; },
+                                   std::plus<int64_t>()),
+                      7);
+    BOOST_CHECK(empty.ParallelKeys([](const int64_t &)
+                                   { return true; })
+                    .empty());
+
+    // secuencial vs paralelo con una acción cara por elemento
+    auto heavy = [](auto &kvp)
+    {
+        double x = static_cast<double>(kvp.second);
+        for (int i = 0; i < 200; ++i)
+            x = std::sqrt(x + i);
+        kvp.second = static_cast<int64_t>(x);
+    };
+    auto time = [&](auto run)
+    {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+    auto sequential_ms = time([&]()
+                              { dict.ForEach(heavy); });
+    auto parallel_ms = time([&]()
+                            { dict.ParallelForEach(heavy); });
+    std::cout << "ForEach secuencial: " << sequential_ms << "ms, paralelo (" << Collections::ParallelWorkers(0) << " workers): " << parallel_ms << "ms" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(RangeViews)
+{
+    Collections::Dictionary<std::string, int> dict;
+    for (int i = 0; i < 100; ++i)
+        dict.TryAdd(std::to_string(i), i);
+
+    // las vistas no copian: cambian con el diccionario
+    BOOST_CHECK_EQUAL(std::ranges::distance(dict.KeysView()), 100);
+    int sum = 0;
+    for (int value : dict.ValuesView())
+        sum += value;
+    BOOST_CHECK_EQUAL(sum, 4950);
+    for (int &value : dict.ValuesView())
+        value *= 2;
+    BOOST_CHECK_EQUAL(dict["10"], 20);
+
+    auto even = dict.Where([](const auto &kvp)
+                           { return kvp.second % 4 == 0; });
+    BOOST_CHECK_EQUAL(std::ranges::distance(even), 50);
+    auto lengths = dict.Select([](const auto &kvp)
+                               { return kvp.first.size(); });
+    BOOST_CHECK_EQUAL(std::accumulate(lengths.begin(), lengths.end(), size_t(0)), 10 + 90 * 2);
+    BOOST_CHECK_EQUAL(std::ranges::distance(dict.Take(7)), 7);
+    BOOST_CHECK_EQUAL(std::ranges::distance(dict.Take(1000)), 100);
+
+    // se componen con std::views
+    auto keys = dict.Where([](const auto &kvp)
+                           { return kvp.second >= 100; }) |
+                std::views::keys | std::views::take(3);
+    BOOST_CHECK_EQUAL(std::ranges::distance(keys), 3);
+    for (const auto &key : keys)
+        BOOST_CHECK_GE(dict[key], 100);
+
+    // mismos resultados que las copias
+    auto eager = dict.Keys();
+    std::set<std::string> lazy(dict.KeysView().begin(), dict.KeysView().end());
+    BOOST_CHECK(lazy == std::set<std::string>(eager.begin(), eager.end()));
+
+    Collections::Dictionary<int, int, Collections::FlatHashMap<int, int>> flat;
+    for (int i = 0; i < 10; ++i)
+        flat.TryAdd(i, i);
+    BOOST_CHECK_EQUAL(std::ranges::distance(flat.Where([](const auto &kvp)
+                                                       { return kvp.first < 5; })),
+                      5);
+
+    // en orden: los mejores niveles de un libro
+    Collections::SortedDictionary<int, int, std::greater<int>> book;
+    for (int price = 100; price < 110; ++price)
+        book.TryAdd(price, price * 10);
+    std::vector<int> best;
+    for (const auto &[price, size] : book.Take(3))
+        best.push_back(price);
+    BOOST_CHECK(best == std::vector<int>({109, 108, 107}));
+    BOOST_CHECK_EQUAL(*book.KeysView().begin(), 109);
+    BOOST_CHECK_EQUAL(*book.ValuesView().begin(), 1090);
+    BOOST_CHECK_EQUAL(std::ranges::distance(book.Where([](const auto &kvp)
+                                                       { return kvp.first % 2 == 0; })),
+                      5);
+    auto sizes = book.Select([](const auto &kvp)
+                             { return kvp.second; }) |
+                 std::views::take(2);
+    int top = 0;
+    for (int size : sizes)
+        top += size;
+    BOOST_CHECK_EQUAL(top, 1090 + 1080);
+    BOOST_CHECK_EQUAL(book.Keys().capacity(), 10);
+}
+
+BOOST_AUTO_TEST_CASE(SingleFlightGetOrAdd)
+{
+    using namespace std::chrono_literals;
+    Collections::ConcurrentDictionary<std::string, int> dict;
+
+    // 8 threads piden la misma llave: la fábrica corre una sola vez y todos ven su valor
+    std::atomic<int> calls = 0;
+    std::vector<std::thread> threads;
+    std::vector<int> seen(8);
+    for (int i = 0; i < 8; ++i)
+        threads.emplace_back([&, i]()
+                             { seen[i] = dict.GetOrAdd("slow", [&]()
+                                                       { ++calls; std::this_thread::sleep_for(100ms); return 42; }); });
+
+    // mientras tanto las demás llaves no esperan a la fábrica lenta
+    std::this_thread::sleep_for(20ms);
+    auto start = std::chrono::steady_clock::now();
+    BOOST_CHECK_EQUAL(dict.GetOrAdd("fast", []()
+                                    { return 1; }),
+                      1);
+    BOOST_CHECK(dict.TryAdd("other", std::function<int()>([]()
+                                                          { return 2; })));
+    BOOST_CHECK_LT(std::chrono::steady_clock::now() - start, 50ms);
+
+    for (auto &thread : threads)
+        thread.join();
+    threads.clear();
+    BOOST_CHECK_EQUAL(calls, 1);
+    for (int value : seen)
+        BOOST_CHECK_EQUAL(value, 42);
+    BOOST_CHECK(!dict.TryAdd("slow", std::function<int()>([]()
+                                                         { return 0; })));
+
+    // la excepción de la fábrica le llega a todos los que esperaban y la llave no se agrega
+    calls = 0;
+    std::atomic<int> failed = 0;
+    for (int i = 0; i < 4; ++i)
+        threads.emplace_back([&]()
+                             {
+            try
+            {
+                dict.GetOrAdd("broken", [&]() -> int
+                              { ++calls; std::this_thread::sleep_for(50ms); throw std::runtime_error("load"); });
+            }
+            catch (const std::runtime_error &)
+            {
+                ++failed;
+            } });
+    for (auto &thread : threads)
+        thread.join();
+    threads.clear();
+    BOOST_CHECK_EQUAL(failed, 4);
+    BOOST_CHECK_LT(calls, 4);
+    BOOST_CHECK(!dict.ContainsKey("broken"));
+    BOOST_CHECK_EQUAL(dict.GetOrAdd("broken", []()
+                                    { return 3; }),
+                      3);
+
+    // AddOrUpdate: un add y el resto updates, aunque el add sea lento
+    for (int i = 0; i < 8; ++i)
+        threads.emplace_back([&]()
+                             { dict.AddOrUpdate("count", [&]()
+                                                { std::this_thread::sleep_for(20ms); return 1; }, [](int &v)
+                                                { ++v; }); });
+    for (auto &thread : threads)
+        thread.join();
+    int count;
+    BOOST_CHECK(dict.TryGetValue("count", count));
+    BOOST_CHECK_EQUAL(count, 8);
+}
+
+BOOST_AUTO_TEST_CASE(LockStatistics)
+{
+    using Instrumented = Collections::InstrumentedMutex<std::shared_mutex>;
+    Collections::ConcurrentDictionary<int, int, Instrumented> dict;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&, t]()
+                             {
+            for (int i = 0; i < 10000; ++i)
+            {
+                dict.TryAdd(t * 10000 + i, i);
+                int value;
+                dict.TryGetValue(i, value);
+            } });
+    for (auto &thread : threads)
+        thread.join();
+    threads.clear();
+
+    auto stats = dict.Stats();
+    BOOST_CHECK_EQUAL(stats.acquisitions, 80000);
+    BOOST_CHECK_LE(stats.contended, stats.acquisitions);
+    uint64_t waits = 0, holds = 0;
+    for (size_t i = 0; i < Collections::LockStats::Buckets; ++i)
+    {
+        waits += stats.wait[i];
+        holds += stats.hold[i];
+    }
+    BOOST_CHECK_EQUAL(waits, 80000);
+    BOOST_CHECK_EQUAL(holds, 80000);
+    BOOST_CHECK_GE(stats.HoldPercentile(0.99), stats.HoldPercentile(0.5));
+    // las sobrecargas se juntan por nombre de método
+    BOOST_REQUIRE_EQUAL(stats.callers.size(), 2);
+    std::set<std::string> callers{stats.callers[0].first, stats.callers[1].first};
+    BOOST_CHECK(callers == std::set<std::string>({"TryAdd", "TryGetValue"}));
+    BOOST_CHECK_EQUAL(stats.callers[0].second, 40000);
+    std::cout << "ConcurrentDictionary contención " << stats.ContentionRatio() << ", espera p99 < " << stats.WaitPercentile(0.99) << "ns, retención p99 < " << stats.HoldPercentile(0.99) << "ns" << std::endl;
+
+    // la cola y la lista aceptan el mismo mutex
+    Collections::ConcurrentQueue<int, std::deque<int>, Collections::InstrumentedMutex<>> queue;
+    for (int i = 0; i < 10; ++i)
+        queue.Enqueue(i);
+    int value;
+    while (queue.TryDequeue(value))
+        ;
+    BOOST_CHECK_EQUAL(queue.Stats().acquisitions, 21);
+    BOOST_CHECK_EQUAL(queue.Stats().callers.front().first, "TryDequeue");
+
+    Collections::ConcurrentList<int, std::allocator<int>, Collections::InstrumentedMutex<>> list;
+    list.Push(1);
+    list.Push(2);
+    BOOST_CHECK_EQUAL(list.Size(), 2);
+    BOOST_CHECK_EQUAL(list.Stats().acquisitions, 3);
+
+    Collections::ConcurrentHashSet<int, Collections::InstrumentedMutex<>> set;
+    set.TryInsert(1);
+    BOOST_CHECK(set.Contains(1));
+    BOOST_CHECK_EQUAL(set.Stats().acquisitions, 2);
+
+    Collections::ShardedConcurrentDictionary<int, int, Collections::InstrumentedMutex<>> sharded(4);
+    for (int i = 0; i < 100; ++i)
+        sharded.TryAdd(i, i);
+    BOOST_CHECK_EQUAL(sharded.Stats().acquisitions, 100);
+    BOOST_CHECK_EQUAL(sharded.Stats().callers.front().second, 100);
+
+    Collections::ConcurrentExpiringDictionary<int, int, std::chrono::steady_clock, Collections::InstrumentedMutex<>> expiring(std::chrono::seconds(60));
+    expiring.TryAdd(1, 1);
+    BOOST_CHECK(expiring.ContainsKey(1));
+    BOOST_CHECK_EQUAL(expiring.Stats().acquisitions, 2);
+
+    Collections::ConcurrentClockCache<int, int, Collections::UnitWeight, Collections::InstrumentedMutex<>> cache(1000, 4);
+    for (int i = 0; i < 10; ++i)
+        cache.TryAdd(i, i);
+    BOOST_CHECK_EQUAL(cache.MutexStats().acquisitions, 10);
+
+    // los alias pmr también siguen a COLLECTIONS_LOCK_STATS
+    Collections::pmr::ConcurrentDictionary<int, int> pmr_dictionary;
+    BOOST_CHECK((std::is_same<decltype(pmr_dictionary.mutex), Collections::DefaultMutex>::value));
+}
+
+BOOST_AUTO_TEST_CASE(SeqlockLockFreeDictionary)
+{
+    // V trivialmente copiable pero no atómico: el slot usa seqlock
+    struct Quote
+    {
+        int64_t bid, ask, bid_size, ask_size;
+    };
+    auto quote = [](int64_t i)
+    { return Quote{i, i + 1, i * 10, i * 10 + 1}; };
+    auto consistent = [](const Quote &q)
+    { return q.ask == q.bid + 1 && q.bid_size == q.bid * 10 && q.ask_size == q.bid_size + 1; };
+
+    Collections::LockFreeDictionary<int64_t, Quote> quotes(1024);
+    BOOST_CHECK(quotes.TryAdd(1, quote(0)));
+    BOOST_CHECK(!quotes.TryAdd(1, quote(5)));
+    BOOST_CHECK(!quotes.Add(1, quote(7)));
+    Quote q;
+    BOOST_CHECK(quotes.TryGetValue(1, q));
+    BOOST_CHECK_EQUAL(q.bid, 7);
+    // sin valor reservado: un Quote en ceros es un valor válido
+    BOOST_CHECK(quotes.Add(2, Quote{}));
+    BOOST_CHECK(quotes.ContainsKey(2));
+    BOOST_CHECK(quotes.TryRemove(2, q));
+    BOOST_CHECK(!quotes.ContainsKey(2));
+    BOOST_CHECK_EQUAL(quotes.GetOrAdd(3, [&]()
+                                      { return quote(3); })
+                          .bid,
+                      3);
+    quotes.AddOrUpdate(3, [&]()
+                       { return quote(0); }, [](Quote &q)
+                       { q.bid_size += 1; });
+    BOOST_CHECK(quotes.TryGetValue(3, q));
+    BOOST_CHECK_EQUAL(q.bid_size, 31);
+    BOOST_CHECK_EQUAL(quotes.Size(), 2);
+    quotes.Clear();
+    BOOST_CHECK(!quotes.Any());
+
+    // 3 lectores de 1M lecturas cada uno con un escritor actualizando todo el tiempo; regresa ms
+    auto readers_with_writer = [](const auto &read, const auto &write)
+    {
+        std::atomic<int> running = 3;
+        std::vector<std::thread> readers;
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < 3; ++t)
+            readers.emplace_back([&]()
+                                 {
+                for (int64_t i = 0; i < 1'000'000; ++i)
+                    read(i % 64 + 1);
+                --running; });
+        for (int64_t i = 1; running; ++i)
+            write(i % 64 + 1, i);
+        for (auto &reader : readers)
+            reader.join();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    // los lectores nunca ven una cotización a medias
+    for (int64_t key = 1; key <= 64; ++key)
+        quotes.Add(key, quote(0));
+    std::atomic<int64_t> torn = 0;
+    auto seqlock_ms = readers_with_writer([&](int64_t key)
+                                          {
+        Quote read;
+        if (quotes.TryGetValue(key, read) && !consistent(read))
+            ++torn; },
+                                          [&](int64_t key, int64_t i)
+                                          { quotes.Add(key, quote(i)); });
+    BOOST_CHECK_EQUAL(torn, 0);
+
+    Collections::ConcurrentDictionary<int64_t, Quote, std::shared_mutex> locked;
+    for (int64_t key = 1; key <= 64; ++key)
+        locked.Add(key, quote(0));
+    auto locked_ms = readers_with_writer([&](int64_t key)
+                                         {
+        Quote read;
+        locked.TryGetValue(key, read); },
+                                         [&](int64_t key, int64_t i)
+                                         { locked.Add(key, quote(i)); });
+    std::cout << "3M lecturas de Quote con un escritor: LockFreeDictionary (seqlock) " << seqlock_ms << "ms, ConcurrentDictionary (shared_mutex) " << locked_ms << "ms" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(PrefetchingTryGetMany)
+{
+    // canastas de 128 llaves al azar (la mitad inexistentes) sobre tablas más grandes que la caché:
+    // TryGetMany contra un ciclo de TryGetValue, con el mismo resultado
+    const int64_t entries = 1'000'000;
+    std::mt19937_64 random(19);
+    std::vector<int64_t> keys(128 * 2000);
+    for (auto &key : keys)
+        key = static_cast<int64_t>(random() % (entries * 2));
+
+    auto bench = [&](auto &dict, const char *name)
+    {
+        for (int64_t i = 0; i < entries; ++i)
+            dict.TryAdd(i, i * 3);
+
+        std::vector<int64_t *> looped(keys.size()), batched(keys.size());
+        auto start = std::chrono::steady_clock::now();
+        for (size_t base = 0; base < keys.size(); base += 128)
+        {
+            for (size_t i = base; i < base + 128; ++i)
+            {
+                if (!dict.TryGetValue(keys[i], looped[i]))
+                    looped[i] = nullptr;
+            }
+        }
+        auto loop = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (size_t base = 0; base < keys.size(); base += 128)
+            dict.TryGetMany(std::span<const int64_t>(keys.data() + base, 128), std::span<int64_t *>(batched.data() + base, 128));
+        auto many = std::chrono::steady_clock::now() - start;
+
+        BOOST_CHECK(looped == batched);
+        for (size_t i = 0; i < keys.size(); ++i)
+            BOOST_REQUIRE(batched[i] ? *batched[i] == keys[i] * 3 : keys[i] >= entries);
+        std::cout << name << " 128 llaves x 2000: TryGetValue " << std::chrono::duration_cast<std::chrono::microseconds>(loop).count()
+                  << "us, TryGetMany " << std::chrono::duration_cast<std::chrono::microseconds>(many).count() << "us" << std::endl;
+    };
+    {
+        Collections::Dictionary<int64_t, int64_t> dict;
+        bench(dict, "Dictionary");
+    }
+    {
+        Collections::Dictionary<int64_t, int64_t, Collections::FlatHashMap<int64_t, int64_t>> flat;
+        bench(flat, "Dictionary<FlatHashMap>");
+    }
+    {
+        Collections::SortedDictionary<int64_t, int64_t, std::less<int64_t>> sorted;
+        bench(sorted, "SortedDictionary");
+
+        // copia, llaves repetidas y en desorden
+        std::vector<int64_t> basket{5, -1, 3, 5, entries + 1, 0};
+        std::vector<int64_t> values(basket.size(), -7);
+        auto found = sorted.TryGetMany(basket, values);
+        BOOST_CHECK(found == std::vector<bool>({true, false, true, true, false, true}));
+        BOOST_CHECK(values == std::vector<int64_t>({15, -7, 9, 15, -7, 0}));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(DenseDictionary)
+{
+    // ticks de precio en [-5000, 100000): páginas sólo donde hay llaves
+    Collections::DenseDictionary<int, std::string> ticks(-5000, 99999);
+    BOOST_CHECK(ticks.TryAdd(10, "diez"));
+    BOOST_CHECK(!ticks.TryAdd(10, "otro"));
+    BOOST_CHECK(ticks.TryAdd(-5000, "min"));
+    BOOST_CHECK(ticks.TryAdd(99999, "max"));
+    BOOST_CHECK(!ticks.TryAdd(100000, "fuera"));
+    BOOST_CHECK(!ticks.TryAdd(-5001, "fuera"));
+    BOOST_CHECK(!ticks.ContainsKey(100000));
+    BOOST_CHECK_THROW(ticks[100000], std::out_of_range);
+    BOOST_CHECK_THROW(ticks.Add(-6000, "x"), std::out_of_range);
+    BOOST_CHECK(ticks.Add(7, "siete"));
+    BOOST_CHECK(!ticks.Add(7, "SIETE"));
+    BOOST_CHECK_EQUAL(ticks.Size(), 4);
+
+    std::string value;
+    BOOST_CHECK(ticks.TryGetValue(7, value));
+    BOOST_CHECK_EQUAL(value, "SIETE");
+    BOOST_CHECK_EQUAL(ticks.GetOrAdd(8, []()
+                                     { return std::string("ocho"); }),
+                      "ocho");
+    ticks.AddOrUpdate(8, []()
+                      { return std::string(); }, [](std::string &v)
+                      { v += "!"; });
+    BOOST_CHECK_EQUAL(ticks[8], "ocho!");
+
+    // orden por llave gratis
+    BOOST_CHECK(ticks.Keys() == std::vector<int>({-5000, 7, 8, 10, 99999}));
+    BOOST_CHECK_EQUAL(ticks.FirstKey(), -5000);
+    std::vector<int> visited;
+    for (auto [key, text] : ticks)
+        visited.push_back(key);
+    BOOST_CHECK(visited == ticks.Keys());
+    ticks.ForEach([](auto &kvp)
+                  { kvp.second += "."; });
+    BOOST_CHECK_EQUAL(ticks[10], "diez.");
+
+    BOOST_CHECK(ticks.TryRemove(-5000, value));
+    BOOST_CHECK_EQUAL(value, "min.");
+    BOOST_CHECK(!ticks.TryRemove(-5000));
+    auto copy = ticks;
+    ticks.Clear();
+    BOOST_CHECK(!ticks.Any());
+    BOOST_CHECK_EQUAL(copy.Size(), 4);
+    BOOST_CHECK(copy.begin() != copy.end());
+
+    // el origen de un move queda vacío y usable, con el mismo rango
+    auto moved = std::move(copy);
+    BOOST_CHECK_EQUAL(moved.Size(), 4);
+    BOOST_CHECK(!copy.Any());
+    BOOST_CHECK(copy.begin() == copy.end());
+    BOOST_CHECK(!copy.ContainsKey(10));
+    BOOST_CHECK(copy.TryAdd(10, "otra vez"));
+    ticks = std::move(moved);
+    BOOST_CHECK_EQUAL(ticks.Size(), 4);
+    BOOST_CHECK(!moved.Any());
+    BOOST_CHECK(moved.TryAdd(99999, "max"));
+    BOOST_CHECK_EQUAL(moved.Size(), 1);
+
+    // mismas operaciones al azar que un std::map
+    Collections::DenseDictionary<uint16_t, int, 64> dense(0, 65535);
+    std::map<uint16_t, int> expected;
+    std::mt19937 random(20);
+    for (int i = 0; i < 100000; ++i)
+    {
+        uint16_t key = random() % 3000;
+        switch (random() % 3)
+        {
+        case 0:
+            BOOST_REQUIRE_EQUAL(dense.TryAdd(key, i), expected.try_emplace(key, i).second);
+            break;
+        case 1:
+            BOOST_REQUIRE_EQUAL(dense.TryRemove(key), expected.erase(key) > 0);
+            break;
+        default:
+            int found;
+            BOOST_REQUIRE_EQUAL(dense.TryGetValue(key, found), expected.count(key) > 0);
+        }
+    }
+    BOOST_CHECK_EQUAL(dense.Size(), expected.size());
+    std::vector<std::pair<uint16_t, int>> in_order;
+    for (const auto &[key, found] : dense)
+        in_order.emplace_back(key, found);
+    BOOST_CHECK((in_order == std::vector<std::pair<uint16_t, int>>(expected.begin(), expected.end())));
+
+    // contra Dictionary<int, int*> en un rango denso de ids
+    Collections::DenseDictionary<int, int64_t> ids(0, 1'000'000);
+    Collections::Dictionary<int, int64_t> hashed;
+    for (int i = 0; i < 1'000'000; i += 2)
+    {
+        ids.TryAdd(i, i);
+        hashed.TryAdd(i, i);
+    }
+    auto time = [](auto &dict)
+    {
+        auto start = std::chrono::steady_clock::now();
+        int64_t sum = 0;
+        for (int round = 0; round < 5; ++round)
+        {
+            for (int i = 0; i < 1'000'000; ++i)
+            {
+                int64_t *found;
+                if (dict.TryGetValue(static_cast<int>(int64_t(i) * 7919 % 1'000'000), found))
+                    sum += *found;
+            }
+        }
+        BOOST_CHECK_GT(sum, 0);
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+    std::cout << "5M TryGetValue: DenseDictionary " << time(ids) << "ms, Dictionary " << time(hashed) << "ms" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(FrozenDictionary)
+{
+    // tabla de símbolos que se arma una vez y después sólo se consulta
+    Collections::Dictionary<std::string, int> symbols;
+    for (int i = 0; i < 1000; ++i)
+        symbols.TryAdd("SYM" + std::to_string(i), i);
+    auto frozen = symbols.Freeze();
+    BOOST_CHECK_EQUAL(frozen.Size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+    {
+        int value = -1;
+        BOOST_REQUIRE(frozen.TryGetValue("SYM" + std::to_string(i), value));
+        BOOST_REQUIRE_EQUAL(value, i);
+    }
+    BOOST_CHECK(!frozen.ContainsKey("SYM1000"));
+    BOOST_CHECK(!frozen.ContainsKey(std::string_view("")));
+    BOOST_CHECK(frozen.ContainsKey(std::string_view("SYM42")));
+    const int *pointer;
+    BOOST_CHECK(frozen.TryGetValue(std::string_view("SYM7"), pointer));
+    BOOST_CHECK_EQUAL(*pointer, 7);
+    BOOST_CHECK_EQUAL(frozen["SYM999"], 999);
+    BOOST_CHECK_THROW(frozen["nada"], std::out_of_range);
+    int sum = 0;
+    frozen.ForEach([&](const auto &kvp)
+                   { sum += kvp.second; });
+    BOOST_CHECK_EQUAL(sum, 999 * 1000 / 2);
+    BOOST_CHECK_EQUAL(frozen.Keys().size(), 1000);
+
+    // llaves repetidas, vacío y una sola llave
+    std::vector<std::pair<const int, int>> repeated{{1, 1}, {2, 2}, {1, 3}};
+    BOOST_CHECK_THROW((Collections::FrozenDictionary<int, int>(repeated.begin(), repeated.end())), std::invalid_argument);
+    // un hasher que da el mismo valor a llaves distintas no tiene semilla que lo arregle: se rechaza en vez de colgarse
+    struct Weak
+    {
+        size_t operator()(int key) const { return key & 0xF; }
+    };
+    std::vector<std::pair<const int, int>> colliding{{1, 1}, {17, 17}, {2, 2}};
+    BOOST_CHECK_THROW((Collections::FrozenDictionary<int, int, Weak>(colliding.begin(), colliding.end())), std::invalid_argument);
+    std::vector<std::pair<const int, int>> spread{{1, 1}, {2, 2}, {3, 3}};
+    BOOST_CHECK_EQUAL((Collections::FrozenDictionary<int, int, Weak>(spread.begin(), spread.end())[3]), 3);
+    Collections::FrozenDictionary<int, int> empty;
+    BOOST_CHECK(!empty.Any());
+    BOOST_CHECK(!empty.ContainsKey(0));
+    Collections::Dictionary<int, int> one;
+    one.TryAdd(5, 50);
+    BOOST_CHECK(one.Freeze().ContainsKey(5));
+    BOOST_CHECK(!one.Freeze().ContainsKey(6));
+
+    Collections::HashSet<int> set;
+    for (int i = 0; i < 5000; i += 5)
+        set.TryInsert(i);
+    auto frozen_set = set.Freeze();
+    BOOST_CHECK_EQUAL(frozen_set.Size(), 1000);
+    for (int i = 0; i < 5000; ++i)
+        BOOST_REQUIRE_EQUAL(frozen_set.Contains(i), i % 5 == 0);
+
+    Collections::ConcurrentDictionary<int, int> concurrent;
+    concurrent.TryAdd(1, 10);
+    BOOST_CHECK_EQUAL(concurrent.Freeze()[1], 10);
+
+    // 1M llaves: bytes y tiempo de lectura contra el Dictionary original
+    Collections::Dictionary<int64_t, int64_t> big;
+    for (int64_t i = 0; i < 1'000'000; ++i)
+        big.TryAdd(i * 7919, i);
+    auto start = std::chrono::steady_clock::now();
+    auto frozen_big = big.Freeze();
+    auto build = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    BOOST_REQUIRE_EQUAL(frozen_big.Size(), 1'000'000);
+    for (int64_t i = 0; i < 1'000'000; ++i)
+    {
+        const int64_t *found;
+        BOOST_REQUIRE(frozen_big.TryGetValue(i * 7919, found) && *found == i);
+    }
+    auto time = [](auto &dict)
+    {
+        auto start = std::chrono::steady_clock::now();
+        int64_t hits = 0;
+        for (int round = 0; round < 5; ++round)
+        {
+            // en orden pseudoaleatorio: recorrer en orden de inserción favorece a los nodos del Dictionary
+            for (int64_t i = 0; i < 1'000'000; ++i)
+                hits += dict.ContainsKey(i * 999'983 % 1'000'000 * 7919 + (i & 1));
+        }
+        BOOST_CHECK_EQUAL(hits, 2'500'000);
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+    std::cout << "FrozenDictionary 1M: build " << build << "ms, " << frozen_big.Bytes() / 1'000'000 << "MB; 5M ContainsKey: Frozen " << time(frozen_big) << "ms, Dictionary " << time(big) << "ms" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(MappedSnapshots)
+{
+    struct Quote
+    {
+        int64_t bid, ask;
+        uint32_t volume;
+    };
+    std::string path("/tmp/LibCollections.Snapshot.Test");
+
+    Collections::Dictionary<uint64_t, Quote> quotes;
+    for (uint64_t i = 0; i < 100000; ++i)
+        quotes.TryAdd(i * 31, Quote{int64_t(i), int64_t(i) + 1, uint32_t(i % 1000)});
+    quotes.SaveSnapshot(path);
+    {
+        auto mapped = Collections::Dictionary<uint64_t, Quote>::MapSnapshot(path, true);
+        BOOST_CHECK_EQUAL(mapped.Size(), 100000);
+        for (uint64_t i = 0; i < 100000; ++i)
+        {
+            const Quote *quote;
+            BOOST_REQUIRE(mapped.TryGetValue(i * 31, quote));
+            BOOST_REQUIRE(quote->bid == int64_t(i) && quote->ask == int64_t(i) + 1 && quote->volume == i % 1000);
+            BOOST_REQUIRE(!mapped.ContainsKey(i * 31 + 1));
+        }
+        // las copias comparten el archivo mapeado
+        auto copy = mapped;
+        mapped = Collections::FrozenDictionary<uint64_t, Quote>();
+        BOOST_CHECK_EQUAL(copy[31].bid, 1);
+    }
+
+    // archivo de otro tipo, corrupto o truncado
+    BOOST_CHECK_THROW((Collections::Dictionary<uint64_t, int64_t>::MapSnapshot(path)), std::runtime_error);
+    BOOST_CHECK_THROW(Collections::HashSet<uint64_t>::MapSnapshot(path), std::runtime_error);
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(4096);
+        file.put('\x7f');
+    }
+    BOOST_CHECK_NO_THROW((Collections::Dictionary<uint64_t, Quote>::MapSnapshot(path)));
+    BOOST_CHECK_THROW((Collections::Dictionary<uint64_t, Quote>::MapSnapshot(path, true)), std::runtime_error);
+    std::filesystem::resize_file(path, 1000);
+    BOOST_CHECK_THROW((Collections::Dictionary<uint64_t, Quote>::MapSnapshot(path)), std::runtime_error);
+    BOOST_CHECK_THROW((Collections::Dictionary<uint64_t, Quote>::MapSnapshot(path + ".missing")), std::system_error);
+
+    Collections::HashSet<int32_t> set;
+    for (int32_t i = -5000; i < 5000; i += 3)
+        set.TryInsert(i);
+    set.SaveSnapshot(path);
+    auto mapped_set = Collections::HashSet<int32_t>::MapSnapshot(path, true);
+    BOOST_CHECK_EQUAL(mapped_set.Size(), set.Size());
+    for (int32_t i = -5000; i < 5000; ++i)
+        BOOST_REQUIRE_EQUAL(mapped_set.Contains(i), set.Contains(i));
+
+    Collections::List<double> prices;
+    for (int i = 0; i < 1000; ++i)
+        prices.Add(i * 0.25);
+    prices.SaveSnapshot(path);
+    auto mapped_prices = Collections::List<double>::MapSnapshot(path, true);
+    BOOST_CHECK_EQUAL(mapped_prices.Size(), 1000);
+    BOOST_CHECK_EQUAL(mapped_prices[999], 249.75);
+    BOOST_CHECK(std::equal(mapped_prices.begin(), mapped_prices.end(), prices.begin(), prices.end()));
+    BOOST_CHECK(mapped_prices.Contains(0.5));
+
+    // tamaños que no llenan la última palabra del checksum
+    for (int32_t count : {1, 3, 5, 7})
+    {
+        Collections::List<int32_t> odd;
+        Collections::HashSet<int32_t> odd_set;
+        for (int32_t i = 0; i < count; ++i)
+        {
+            odd.Add(i * 11);
+            odd_set.TryInsert(i * 11);
+        }
+        odd.SaveSnapshot(path);
+        auto mapped_odd = Collections::List<int32_t>::MapSnapshot(path, true);
+        BOOST_REQUIRE(std::equal(mapped_odd.begin(), mapped_odd.end(), odd.begin(), odd.end()));
+        odd_set.SaveSnapshot(path);
+        auto mapped_odd_set = Collections::HashSet<int32_t>::MapSnapshot(path, true);
+        BOOST_REQUIRE_EQUAL(mapped_odd_set.Size(), size_t(count));
+        for (int32_t i = 0; i < count; ++i)
+            BOOST_REQUIRE(mapped_odd_set.Contains(i * 11));
+
+        // semillas que mandan fuera de la tabla: se rechazan aun sin verify
+        Collections::SnapshotHeader header;
+        {
+            std::ifstream in(path, std::ios::binary);
+            in.read(reinterpret_cast<char *>(&header), sizeof(header));
+        }
+        {
+            std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(std::streamoff(header.seeds_offset));
+            for (uint64_t b = 0; b < header.buckets; ++b)
+            {
+                uint32_t seed = 0xFFFFFFFFu;
+                file.write(reinterpret_cast<const char *>(&seed), sizeof(seed));
+            }
+        }
+        BOOST_CHECK_THROW(Collections::HashSet<int32_t>::MapSnapshot(path), std::runtime_error);
+    }
+
+    Collections::Dictionary<int, int> empty;
+    empty.SaveSnapshot(path);
+    BOOST_CHECK(!(Collections::Dictionary<int, int>::MapSnapshot(path, true).Any()));
+    BOOST_CHECK(!(Collections::Dictionary<int, int>::MapSnapshot(path).ContainsKey(0)));
+
+    // arranque: reconstruir desde los datos contra mapear el snapshot
+    Collections::Dictionary<uint64_t, uint64_t> big;
+    for (uint64_t i = 0; i < 1'000'000; ++i)
+        big.TryAdd(i * 7919, i);
+    big.SaveSnapshot(path);
+    auto start = std::chrono::steady_clock::now();
+    Collections::Dictionary<uint64_t, uint64_t> rebuilt;
+    for (uint64_t i = 0; i < 1'000'000; ++i)
+        rebuilt.TryAdd(i * 7919, i);
+    auto rebuild = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    auto mapped_big = Collections::Dictionary<uint64_t, uint64_t>::MapSnapshot(path);
+    uint64_t first;
+    BOOST_CHECK(mapped_big.TryGetValue(7919ULL * 500'000, first) && first == 500'000);
+    auto map = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "1M entries: rebuild " << rebuild << "us, MapSnapshot + first lookup " << map << "us" << std::endl;
+    std::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(HashQuality)
+{
+    // llaves transparentes: string, string_view y const char* dan el mismo hash
+    Collections::Hash<std::string> string_hash;
+    std::string long_key(1000, 'x');
+    BOOST_CHECK_EQUAL(string_hash(long_key), string_hash(std::string_view(long_key)));
+    BOOST_CHECK_EQUAL(string_hash(std::string("ORD-1")), string_hash("ORD-1"));
+    // todos los tamaños (los caminos de 0-3, 4-16, 17-48 y > 48 bytes) dependen de todos los bytes
+    std::set<size_t> seen;
+    for (size_t size = 0; size <= 200; ++size)
+    {
+        std::string key(size, 'a');
+        BOOST_REQUIRE(seen.insert(string_hash(key)).second);
+        for (size_t i = 0; i < size; ++i)
+        {
+            auto flipped = key;
+            flipped[i] = 'b';
+            BOOST_REQUIRE(seen.insert(string_hash(flipped)).second);
+        }
+    }
+    // un bit de la llave cambia ~la mitad de los bits del hash
+    Collections::Hash<uint64_t> integer_hash;
+    double flipped_bits = 0;
+    for (uint64_t key = 0; key < 1000; ++key)
+    {
+        for (int bit = 0; bit < 64; ++bit)
+            flipped_bits += std::popcount(integer_hash(key) ^ integer_hash(key ^ (uint64_t(1) << bit)));
+    }
+    flipped_bits /= 1000 * 64;
+    BOOST_CHECK(flipped_bits > 28 && flipped_bits < 36);
+    enum class Venue : uint8_t
+    {
+        Bmv,
+        Biva
+    };
+    BOOST_CHECK_NE(Collections::Hash<Venue>{}(Venue::Bmv), Collections::Hash<Venue>{}(Venue::Biva));
+
+    // sondeo lineal en una tabla potencia de 2 (como FlatHashMap sin su mezcla) al 50%: probes promedio y máximo
+    auto probes = [](const auto &keys, const auto &hash)
+    {
+        size_t capacity = std::bit_ceil(keys.size() * 2), total = 0, longest = 0;
+        std::vector<bool> used(capacity);
+        for (auto &key : keys)
+        {
+            size_t i = hash(key) & (capacity - 1), n = 1;
+            for (; used[i]; i = (i + 1) & (capacity - 1))
+                ++n;
+            used[i] = true;
+            total += n;
+            longest = std::max(longest, n);
+        }
+        return std::make_pair(static_cast<double>(total) / keys.size(), longest);
+    };
+    // ids de orden: secuencia << 8 | mercado
+    std::vector<uint64_t> order_ids;
+    for (uint64_t i = 0; i < 100000; ++i)
+        order_ids.push_back(i << 8 | (i % 3));
+    std::vector<std::string> symbols;
+    for (int i = 0; i < 100000; ++i)
+        symbols.push_back("ORDER-" + std::to_string(1'000'000 + i) + "-MXN");
+    auto [identity_mean, identity_max] = probes(order_ids, Collections::IdentityHash<uint64_t>());
+    auto [wy_mean, wy_max] = probes(order_ids, integer_hash);
+    auto [string_mean, string_max] = probes(symbols, string_hash);
+    auto [std_string_mean, std_string_max] = probes(symbols, std::hash<std::string>());
+    BOOST_CHECK_LT(wy_mean, 2.0);
+    BOOST_CHECK_LT(wy_max, 64);
+    BOOST_CHECK_LT(string_mean, 2.0);
+    BOOST_CHECK_LT(string_max, 64);
+    std::cout << "probes (media/max) ids << 8: std::hash " << identity_mean << "/" << identity_max << ", Hash " << wy_mean << "/" << wy_max
+              << "; strings: std::hash " << std_string_mean << "/" << std_string_max << ", Hash " << string_mean << "/" << string_max << std::endl;
+
+    // throughput de lookups en Dictionary con cada hasher
+    auto time = [](auto &dict, const auto &keys)
+    {
+        for (auto &key : keys)
+            dict.TryAdd(key, 1);
+        auto start = std::chrono::steady_clock::now();
+        size_t hits = 0;
+        for (int round = 0; round < 5; ++round)
+        {
+            for (auto &key : keys)
+                hits += dict.ContainsKey(key);
+        }
+        BOOST_CHECK_EQUAL(hits, keys.size() * 5);
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+    Collections::Dictionary<uint64_t, int, std::unordered_map<uint64_t, int, Collections::IdentityHash<uint64_t>>> identity_ids;
+    Collections::Dictionary<uint64_t, int> ids;
+    Collections::Dictionary<std::string, int, std::unordered_map<std::string, int, std::hash<std::string>>> std_strings;
+    Collections::Dictionary<std::string, int> strings;
+    std::cout << "500K ContainsKey ids: std::hash " << time(identity_ids, order_ids) << "ms, Hash " << time(ids, order_ids)
+              << "ms; strings: std::hash " << time(std_strings, symbols) << "ms, Hash " << time(strings, symbols) << "ms" << std::endl;
+
+    // hashes de strings largos: MB/s
+    std::string blob(1 << 20, 'z');
+    auto start = std::chrono::steady_clock::now();
+    size_t sink = 0;
+    for (int i = 0; i < 200; ++i)
+    {
+        blob[i] = static_cast<char>(i);
+        sink ^= string_hash(blob);
+    }
+    auto wy = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 200; ++i)
+    {
+        blob[i] = static_cast<char>(i + 1);
+        sink ^= std::hash<std::string>()(blob);
+    }
+    auto murmur = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    BOOST_CHECK_NE(sink, 0);
+    std::cout << "hash de 200MB: std::hash " << 200'000'000 / std::max<int64_t>(murmur, 1) << "MB/s, Hash " << 200'000'000 / std::max<int64_t>(wy, 1) << "MB/s" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(MemoryUsage)
+{
+    // el estimado de un backend std cuadra con lo que cuenta CountingAllocator para el mismo contenido
+    auto close = [](size_t estimated, size_t counted)
+    {
+        return estimated >= counted * 9 / 10 && estimated <= counted * 11 / 10;
+    };
+    Collections::Dictionary<int64_t, int64_t> plain;
+    Collections::counted::Dictionary<int64_t, int64_t> counted;
+    for (int64_t i = 0; i < 100000; ++i)
+    {
+        plain.TryAdd(i, i);
+        counted.TryAdd(i, i);
+    }
+    BOOST_CHECK(close(plain.MemoryUsage(), counted.MemoryUsage()));
+    // nodo de 8 + 16 bytes -> 32 de malloc, más las cubetas
+    BOOST_CHECK_GT(counted.MemoryUsage(), 100000 * 32);
+    BOOST_CHECK_LT(counted.MemoryUsage(), 100000 * 48);
+
+    // las copias cuentan aparte y al vaciar se regresa todo menos las cubetas
+    auto copy = counted;
+    BOOST_CHECK(close(copy.MemoryUsage(), counted.MemoryUsage()));
+    counted.Clear();
+    BOOST_CHECK_LT(counted.MemoryUsage(), 100000 * 16);
+    BOOST_CHECK_GT(copy.MemoryUsage(), 100000 * 32);
+
+    // strings: los nodos guardan el hash (ver Hash.hpp) y deep suma los que no caben en el objeto
+    Collections::Dictionary<std::string, std::string> names;
+    Collections::counted::Dictionary<std::string, std::string> counted_names;
+    for (int i = 0; i < 1000; ++i)
+    {
+        names.TryAdd("K" + std::to_string(i), std::string(100, 'x'));
+        counted_names.TryAdd("K" + std::to_string(i), std::string(100, 'x'));
+    }
+    BOOST_CHECK(close(names.MemoryUsage(), counted_names.MemoryUsage()));
+    BOOST_CHECK_EQUAL(names.MemoryUsage(true) - names.MemoryUsage(), 1000 * Collections::AllocationSize(101));
+
+    // valores apuntador de GetOrAddNew: sólo los ve deep
+    struct Order
+    {
+        char data[100];
+    };
+    Collections::Dictionary<int, Order *> orders;
+    for (int i = 0; i < 1000; ++i)
+        orders.GetOrAddNew(i);
+    BOOST_CHECK_EQUAL(orders.MemoryUsage(true) - orders.MemoryUsage(), 1000 * Collections::AllocationSize(sizeof(Order)));
+    orders.ForEach([](auto &kvp)
+                   { delete kvp.second; });
+
+    Collections::SortedDictionary<int, double, std::less<int>> sorted;
+    Collections::counted::SortedDictionary<int, double, std::less<int>> counted_sorted;
+    Collections::HashSet<int> set;
+    Collections::counted::HashSet<int> counted_set;
+    Collections::List<int> list;
+    Collections::counted::List<int> counted_list;
+    Collections::Queue<int> queue;
+    Collections::counted::Queue<int> counted_queue;
+    for (int i = 0; i < 10000; ++i)
+    {
+        sorted.Add(i, i);
+        counted_sorted.Add(i, i);
+        set.TryInsert(i);
+        counted_set.TryInsert(i);
+        list.Add(i);
+        counted_list.Add(i);
+        queue.Enqueue(i);
+        counted_queue.Enqueue(i);
+    }
+    BOOST_CHECK(close(sorted.MemoryUsage(), counted_sorted.MemoryUsage()));
+    BOOST_CHECK(close(set.MemoryUsage(), counted_set.MemoryUsage()));
+    BOOST_CHECK(close(list.MemoryUsage(), counted_list.MemoryUsage()));
+    BOOST_CHECK(close(queue.MemoryUsage(), counted_queue.MemoryUsage()));
+
+    Collections::ConcurrentDictionary<int, int> concurrent;
+    Collections::ShardedConcurrentDictionary<int, int> sharded;
+    Collections::ConcurrentQueue<int> concurrent_queue;
+    Collections::ConcurrentList<int> concurrent_list;
+    Collections::ConcurrentHashSet<int> concurrent_set;
+    auto empty_sharded = sharded.MemoryUsage();
+    for (int i = 0; i < 10000; ++i)
+    {
+        concurrent.TryAdd(i, i);
+        sharded.TryAdd(i, i);
+        concurrent_queue.Enqueue(i);
+        concurrent_list.Add(i);
+        concurrent_set.TryInsert(i);
+    }
+    BOOST_CHECK_GT(concurrent.MemoryUsage(), 10000 * 32);
+    BOOST_CHECK_GT(sharded.MemoryUsage(), empty_sharded + 10000 * 32);
+    BOOST_CHECK_GT(concurrent_queue.MemoryUsage(), 10000 * sizeof(int));
+    BOOST_CHECK_GT(concurrent_list.MemoryUsage(), 10000 * sizeof(int));
+    BOOST_CHECK_GT(concurrent_set.MemoryUsage(), 10000 * 32);
+
+    // el origen de un move sigue usable: comparte el contador con el destino
+    Collections::counted::List<int> moved_from;
+    moved_from.Add(1);
+    auto moved_to = std::move(moved_from);
+    moved_from.Add(2);
+    BOOST_CHECK_EQUAL(moved_from.Size(), 1);
+    BOOST_CHECK_GT(moved_from.MemoryUsage(), 0);
+    Collections::counted::Dictionary<int, int> moved_dictionary;
+    moved_dictionary.TryAdd(1, 1);
+    auto moved_dictionary_to = std::move(moved_dictionary);
+    BOOST_CHECK(moved_dictionary.TryAdd(2, 2));
+    BOOST_CHECK_GT(moved_dictionary.MemoryUsage(), 0);
+    BOOST_CHECK(moved_dictionary_to.ContainsKey(1));
+
+    // el resto de los contenedores
+    Collections::ClockCache<int, std::string> cache(1000);
+    Collections::ConcurrentClockCache<int, std::string> concurrent_cache(1000, 4);
+    Collections::CounterDictionary<int> counters(4);
+    Collections::ConcurrentExpiringDictionary<int, int> expiring(std::chrono::seconds(60));
+    Collections::DenseDictionary<int, int> dense(0, 99999);
+    Collections::LockFreeDictionary<int, int> lock_free(20000);
+    auto empty_cache = cache.MemoryUsage(), empty_concurrent_cache = concurrent_cache.MemoryUsage(), empty_counters = counters.MemoryUsage();
+    auto empty_expiring = expiring.MemoryUsage(), empty_dense = dense.MemoryUsage();
+    for (int i = 0; i < 1000; ++i)
+    {
+        cache.TryAdd(i, std::string(100, 'x'));
+        concurrent_cache.TryAdd(i, std::string(100, 'x'));
+        counters.Incr(i);
+        expiring.TryAdd(i, i);
+        dense.TryAdd(i * 100, i);
+        lock_free.TryAdd(i + 1, i + 1);
+    }
+    BOOST_CHECK_GT(cache.MemoryUsage(), empty_cache + 1000 * sizeof(std::string));
+    BOOST_CHECK_EQUAL(cache.MemoryUsage(true) - cache.MemoryUsage(), 1000 * Collections::AllocationSize(101));
+    BOOST_CHECK_GT(concurrent_cache.MemoryUsage(), empty_concurrent_cache + 900 * sizeof(std::string));
+    BOOST_CHECK_GT(counters.MemoryUsage(), empty_counters + 1000 * 4 * 64);
+    BOOST_CHECK_GT(expiring.MemoryUsage(), empty_expiring + 1000 * 32);
+    BOOST_CHECK_GT(dense.MemoryUsage(), empty_dense + 25 * 4096 * sizeof(int));
+    BOOST_CHECK_GE(lock_free.MemoryUsage(), lock_free.Capacity() * 2 * sizeof(int));
+    auto frozen = plain.Freeze();
+    BOOST_CHECK_GE(frozen.MemoryUsage(), frozen.Bytes());
+
+    // como métrica cada segundo: 1M lecturas
+    auto start = std::chrono::steady_clock::now();
+    size_t sink = 0;
+    for (int i = 0; i < 1'000'000; ++i)
+        sink += plain.MemoryUsage() + copy.MemoryUsage();
+    BOOST_CHECK_GT(sink, 0);
+    std::cout << "1M MemoryUsage() estimado + contado: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << "ms" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(BPlusTreeSortedDictionary)
+{
+    // libro: niveles de precio en orden descendente, misma interfaz que con std::map
+    Collections::SortedDictionary<double, int64_t, std::greater<double>, Collections::BPlusTreeMap<double, int64_t, std::greater<double>>> bids;
+    BOOST_CHECK(bids.TryAdd(100.5, 10));
+    BOOST_CHECK(bids.TryAdd(101.0, 5));
+    BOOST_CHECK(!bids.TryAdd(100.5, 7));
+    BOOST_CHECK(bids.TryAdd(99.75, 3));
+    BOOST_CHECK_EQUAL(bids.FirstKey(), 101.0);
+    BOOST_CHECK_EQUAL(bids.First().second, 5);
+    // llega a 0: se borra el nivel
+    BOOST_CHECK(bids.Sub(101.0, 5));
+    BOOST_CHECK(bids.Sub(100.5, 4));
+    int64_t volume;
+    BOOST_CHECK(!bids.TryGetValue(101.0, volume));
+    BOOST_CHECK(bids.TryGetValue(100.5, volume));
+    BOOST_CHECK_EQUAL(volume, 6);
+    BOOST_CHECK_EQUAL(bids.FirstKey(), 100.5);
+    BOOST_CHECK(bids.Keys() == std::vector<double>({100.5, 99.75}));
+    BOOST_CHECK(std::ranges::equal(bids.KeysView(), std::vector<double>({100.5, 99.75})));
+    int64_t top = 0;
+    for (auto [price, size] : bids.Take(1))
+        top += size;
+    BOOST_CHECK_EQUAL(top, 6);
+    auto copy = bids;
+    bids.Clear();
+    BOOST_CHECK(!bids.Any());
+    BOOST_CHECK_EQUAL(copy.Size(), 2);
+
+    // mismas operaciones al azar que un std::map, con nodos chicos para tener varios niveles
+    Collections::BPlusTreeMap<int64_t, int64_t, std::less<int64_t>, 64> tree;
+    std::map<int64_t, int64_t> expected;
+    std::mt19937 random(25);
+    for (int i = 0; i < 200000; ++i)
+    {
+        int64_t key = random() % 5000;
+        switch (random() % 4)
+        {
+        case 0:
+        case 1:
+            BOOST_REQUIRE_EQUAL(tree.try_emplace(key, i).second, expected.try_emplace(key, i).second);
+            break;
+        case 2:
+            BOOST_REQUIRE_EQUAL(tree.erase(key), expected.erase(key));
+            break;
+        default:
+            auto found = tree.lower_bound(key);
+            auto wanted = expected.lower_bound(key);
+            BOOST_REQUIRE_EQUAL(found == tree.end(), wanted == expected.end());
+            if (wanted != expected.end())
+                BOOST_REQUIRE(found->first == wanted->first && found->second == wanted->second);
+        }
+        if (i % 20000 == 0)
+            BOOST_REQUIRE(std::ranges::equal(tree | std::views::keys, expected | std::views::keys));
+    }
+    BOOST_CHECK_EQUAL(tree.size(), expected.size());
+    BOOST_CHECK(std::ranges::equal(tree | std::views::values, expected | std::views::values));
+    // vaciarlo entero y volver a usarlo
+    for (int64_t key = 0; key < 5000; ++key)
+        tree.erase(key);
+    BOOST_CHECK(tree.empty() && tree.begin() == tree.end());
+    BOOST_CHECK_EQUAL(tree.memory_usage(), 0);
+    tree[3] = 4;
+    BOOST_CHECK_EQUAL(tree.find(3)->second, 4);
+
+    // un constructor de V que lanza no deja la hoja a medias
+    struct Picky
+    {
+        int value = 0;
+        Picky() = default;
+        explicit Picky(int value) : value(value)
+        {
+            if (value < 0)
+                throw std::invalid_argument("Picky");
+        }
+    };
+    Collections::BPlusTreeMap<int, Picky> picky;
+    for (int key = 0; key < 100; key += 2)
+        picky.try_emplace(key, key);
+    BOOST_CHECK_THROW(picky.try_emplace(51, -1), std::invalid_argument);
+    BOOST_CHECK_THROW(picky.try_emplace(-1, -1), std::invalid_argument);
+    BOOST_CHECK_EQUAL(picky.size(), 50);
+    BOOST_CHECK(picky.find(51) == picky.end());
+    int next_key = 0;
+    for (auto [key, value] : picky)
+    {
+        BOOST_REQUIRE_EQUAL(key, next_key);
+        BOOST_REQUIRE_EQUAL(value.value, next_key);
+        next_key += 2;
+    }
+    BOOST_CHECK_EQUAL(next_key, 100);
+
+    // llaves no aritméticas: búsqueda binaria dentro del nodo
+    Collections::SortedDictionary<std::string, int, std::less<std::string>, Collections::BPlusTreeMap<std::string, int, std::less<std::string>>> symbols;
+    for (int i = 0; i < 1000; ++i)
+        symbols.Add("S" + std::to_string(i), i);
+    BOOST_CHECK_EQUAL(symbols.FirstKey(), "S0");
+    BOOST_CHECK(symbols.ContainsKey("S999"));
+    BOOST_CHECK(symbols.TryRemove("S0"));
+    BOOST_CHECK_EQUAL(symbols.FirstKey(), "S1");
+    std::vector<std::string> wanted_keys{"S5", "nada", "S10"};
+    std::vector<int> values(3, -1);
+    BOOST_CHECK((symbols.TryGetMany(wanted_keys, values) == std::vector<bool>{true, false, true}));
+    BOOST_CHECK_EQUAL(values[2], 10);
+
+    // contra std::map: inserción en orden y al azar, recorrido en orden y borrado
+    std::vector<int64_t> keys(1'000'000);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), random);
+    auto bench = [&](auto &book)
+    {
+        using namespace std::chrono;
+        auto start = steady_clock::now();
+        for (int64_t i = 0; i < 1'000'000; ++i)
+            book.TryAdd(i, i);
+        auto ordered = duration_cast<milliseconds>(steady_clock::now() - start).count();
+        book.Clear();
+
+        start = steady_clock::now();
+        for (auto key : keys)
+            book.TryAdd(key, key);
+        auto shuffled = duration_cast<milliseconds>(steady_clock::now() - start).count();
+
+        start = steady_clock::now();
+        int64_t sum = 0;
+        for (int round = 0; round < 10; ++round)
+        {
+            for (auto [key, value] : book)
+                sum += value;
+        }
+        auto scan = duration_cast<milliseconds>(steady_clock::now() - start).count();
+        BOOST_CHECK_EQUAL(sum, 10 * (999'999LL * 1'000'000 / 2));
+
+        start = steady_clock::now();
+        int64_t hits = 0;
+        for (auto key : keys)
+        {
+            int64_t value;
+            hits += book.TryGetValue(key, value);
+        }
+        auto lookup = duration_cast<milliseconds>(steady_clock::now() - start).count();
+        BOOST_CHECK_EQUAL(hits, 1'000'000);
+
+        start = steady_clock::now();
+        for (auto key : keys)
+            book.TryRemove(key);
+        auto erase = duration_cast<milliseconds>(steady_clock::now() - start).count();
+        BOOST_CHECK(!book.Any());
+        return std::to_string(ordered) + "/" + std::to_string(shuffled) + "/" + std::to_string(scan) + "/" + std::to_string(lookup) + "/" + std::to_string(erase) + "ms";
+    };
+    Collections::SortedDictionary<int64_t, int64_t, std::less<int64_t>> rb;
+    Collections::SortedDictionary<int64_t, int64_t, std::less<int64_t>, Collections::BPlusTreeMap<int64_t, int64_t>> bplus;
+    for (int i = 0; i < 1000; ++i)
+        bplus.TryAdd(i, i);
+    BOOST_CHECK_LT(bplus.MemoryUsage(), rb.MemoryUsage() + 1000 * 48);
+    bplus.Clear();
+    std::cout << "1M insert en orden/al azar, 10 recorridos, lookup, erase: std::map " << bench(rb) << ", BPlusTreeMap " << bench(bplus) << std::endl;
+}
+
 // en rhel7 nunca encontramos el rocksdb.rpm
 #if __GNUC__ >= 12
 